@@ -1,9 +1,34 @@
+#include <Thermistor.h>
+
+// The table is fitted to the Dehumidifier divider, another divider needs its own log of
+// readings run through libraries/Thermistor/tools/thermistor_table.py
+#define ThermistorPin A0
+#define ReadPeriod 1000
+
+unsigned long readAt = 0;
+
 void setup()
 {
-
+    Serial.begin(115200);
 }
 
 void loop()
 {
+    if (millis() - readAt < ReadPeriod) {
+        return;
+    }
+    readAt = millis();
+
+    int raw = analogRead(ThermistorPin);
+    int tenths = Thermistor::toTenths(raw);
 
+    Serial.print("Raw: ");
+    Serial.println(raw);
+    Serial.print("Celsius: ");
+    if (tenths < 0) {
+        Serial.print('-');
+    }
+    Serial.print(abs(tenths) / 10);
+    Serial.print('.');
+    Serial.println(abs(tenths) % 10);
 }
@@ -1,31 +1,38 @@
+#include <MuxScanner.h>
+
+#define SensorsPowerPin 5
+#define ReportPeriod 1000 // ms
+
+const byte selectPins[] = {2, 3, 4}; // S0..S2, PD2..PD4
+MuxScanner mux(selectPins, A0);
+
+unsigned long reportAt = 0;
+unsigned int reportScans = 0;
+
 void setup() {
     Serial.begin(115200);
-    pinMode(A0, OUTPUT);
-    pinMode(2, OUTPUT);
-    pinMode(3, OUTPUT);
-    pinMode(4, OUTPUT);
-    pinMode(5, OUTPUT);
+    pinMode(SensorsPowerPin, OUTPUT);
+    digitalWrite(SensorsPowerPin, HIGH);
 
-    digitalWrite(2, LOW);
-    digitalWrite(3, LOW);
-    digitalWrite(4, LOW);
-    digitalWrite(5, HIGH);
+    if (!mux.begin()) {
+        Serial.println("Select pins are not on one port");
+    }
 }
 
 void loop() {
-    digitalWrite(2, LOW);
-    digitalWrite(5, HIGH);
-    delay(1000);
-    pinMode(A0, INPUT);
-    int result = analogRead(A0);
-    digitalWrite(5, LOW);
-    Serial.print("Sensor: ");
-    Serial.println(result);
-
-
-    digitalWrite(2, HIGH);
-    pinMode(A0, OUTPUT);
-    digitalWrite(A0, result > 512 ? HIGH : LOW);
+    if (!mux.isReady() || millis() - reportAt < ReportPeriod) {
+        return;
+    }
+    reportAt = millis();
 
-    delay(1000);
+    unsigned int scans = mux.getScans();
+    Serial.print("Sensors:");
+    for (byte i = 0; i < MUX_CHANNELS; i++) {
+        Serial.print(' ');
+        Serial.print(mux.getValue(i));
+    }
+    Serial.print(" (");
+    Serial.print(scans - reportScans);
+    Serial.println(" scans/s)");
+    reportScans = scans;
 }
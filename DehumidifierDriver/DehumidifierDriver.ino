@@ -1,21 +1,43 @@
+#include <Thermistor.h>
+
 #define ThermistorPin 2
-#define PeltierPin 3
+#define PeltierPin 3 // Timer2 PWM
 #define LedPin 4
 
-#define CoolingTime 1000 * 60 * 1
-#define HeatingTime 1000 * 60 * 1
-
-// Temperature from http://playground.arduino.cc/ComponentLib/Thermistor
-#define CoolingTemperature 296 // ~6C
-#define HeatingTemperature 395 // ~15C
-
-
-unsigned long time = 0;
-unsigned long lastTime = 0;
-bool isCooling = true;
-bool isTemeratureOk = false;
-bool isTimerSet = false;
-bool loadingLedState = true;
+#define CoolingTime 1000 * 60 * 1 // ms held at CoolingTemperature
+#define HeatingTime 1000 * 60 * 1 // ms at HeatingTemperature before cooling again
+#define MinStateTime 1000 * 30    // ms in any state, the Peltier is not cycled faster
+
+// calibration in libraries/Thermistor/tools/calibration.txt
+#define CoolingTemperature THERMISTOR_C(6.0)
+#define HeatingTemperature THERMISTOR_C(15.0)
+
+// PI on the filtered temperature in tenths of a degree
+#define ControlPeriod 100 // ms
+#define Kp 8              // duty per tenth of error
+#define Ki 1              // duty/16 per tenth of error and ControlPeriod
+#define MaxDuty 255
+#define RampStep 13       // duty per ControlPeriod, off to full in 2s
+#define FilterShift 3     // reading average over ~8 samples
+
+enum CycleState{
+    Cooling,
+    Holding,
+    Defrosting
+};
+
+CycleState state = Cooling;
+unsigned long stateAt = 0;
+unsigned long reachedAt = 0;
+bool isReached = false;
+
+long temperature = -1; // filtered reading << 4
+long integral = 0;     // duty << 4
+int duty = 0;
+unsigned long controlAt = 0;
+
+unsigned long ledAt = 0;
+bool ledState = true;
 
 void blink(byte x, int ms = 1000){
     for (byte i = 0; i < x; i++){
@@ -26,26 +48,6 @@ void blink(byte x, int ms = 1000){
     }
 }
 
-void softPeltier(bool on = true){
-    for (int i = on ? 0 : 1024; on ? i < 1024 : i > 0; on ? i++ : i--){
-        analogWrite(PeltierPin, i);
-        delay(2);
-    }
-}
-
-void pulse(){
-    int i = 1024;
-    for (i; i > 0; i--){
-        analogWrite(LedPin, i);
-        delay(1);
-    }
-
-    for (i; i < 1024; i++){
-        analogWrite(LedPin, i);
-        delay(1);
-    }
-}
-
 void setup() {
     pinMode(ThermistorPin, INPUT);
     pinMode(PeltierPin, OUTPUT);
@@ -54,1376 +56,122 @@ void setup() {
     digitalWrite(PeltierPin, LOW);
     digitalWrite(LedPin, HIGH);
 
-    softPeltier();
-
     blink(5, 500);
+
+    stateAt = millis();
 }
 
-void loop() {   
-    int temp = analogRead(ThermistorPin);
-    bool isTemeratureOk = isCooling ? temp <= CoolingTemperature : temp >= HeatingTemperature;
+// sampled every loop, the control and the state machine run on the average
+void loop() {
+    readTemperature();
 
-    time = millis();
-    // When mills overflow then reset
-    if (time < lastTime){
-        lastTime = 0;
+    unsigned long now = millis();
+    if (now - controlAt >= ControlPeriod){
+        controlAt = now;
+        handleState(now);
+        handlePeltier();
     }
 
-    if (isTemeratureOk && !isTimerSet){
-        lastTime = time;
+    handleLed(now);
+}
+
+void readTemperature(){
+    long raw = (long)analogRead(ThermistorPin) << 4;
+    if (temperature < 0){
+        temperature = raw;
+    }
+    else {
+        temperature += (raw - temperature) >> FilterShift;
     }
+}
 
+// tenths of a degree
+int getTemperature(){
+    return Thermistor::toTenths((temperature + 8) >> 4);
+}
 
-    if (isTemeratureOk && lastTime + (isCooling ? CoolingTime : HeatingTime) <= time)
-    {
-        isCooling = !isCooling;
-        isTimerSet = false;
+void setState(CycleState next, unsigned long now){
+    state = next;
+    stateAt = now;
+    isReached = false;
+}
 
-        //digitalWrite(PeltierPin, isCooling ? HIGH : LOW);
-        softPeltier(isCooling);
-        blink(isCooling ? 50 : 5, isCooling ? 100 : 1000);
+// Cooling until the plate gets to CoolingTemperature, Holding it there for CoolingTime while
+// water condenses, Defrosting with the Peltier off until the ice melted (HeatingTemperature
+// for HeatingTime); no state is left before MinStateTime
+void handleState(unsigned long now){
+    int temp = getTemperature();
+    if (now - stateAt < MinStateTime){
+        return;
     }
 
-    if (!isTimerSet){
-        pulse();
-    } else {
-        delay(100);
+    switch (state){
+    case Cooling:
+        if (temp <= CoolingTemperature){
+            setState(Holding, now);
+        }
+        break;
+
+    case Holding:
+        if (now - stateAt >= CoolingTime){
+            setState(Defrosting, now);
+        }
+        break;
+
+    case Defrosting:
+        if (temp < HeatingTemperature){
+            isReached = false;
+        }
+        else if (!isReached){
+            isReached = true;
+            reachedAt = now;
+        }
+        else if (now - reachedAt >= HeatingTime){
+            integral = 0;
+            setState(Cooling, now);
+        }
+        break;
     }
 }
 
-// Temperatures:
-/*
-Raw: 251
-Celsius: 1.4
-Raw: 252
-Celsius: 1.6
-Raw: 252
-Celsius: 1.6
-Raw: 253
-Celsius: 1.7
-Raw: 252
-Celsius: 1.6
-Raw: 252
-Celsius: 1.6
-Raw: 254
-Celsius: 1.8
-Raw: 255
-Celsius: 1.9
-Raw: 255
-Celsius: 1.9
-Raw: 256
-Celsius: 2.0
-Raw: 258
-Celsius: 2.2
-Raw: 258
-Celsius: 2.2
-Raw: 259
-Celsius: 2.3
-Raw: 260
-Celsius: 2.4
-Raw: 261
-Celsius: 2.5
-Raw: 262
-Celsius: 2.6
-Raw: 264
-Celsius: 2.8
-Raw: 265
-Celsius: 2.9
-Raw: 266
-Celsius: 3.0
-Raw: 267
-Celsius: 3.1
-Raw: 268
-Celsius: 3.2
-Raw: 269
-Celsius: 3.3
-Raw: 271
-Celsius: 3.5
-Raw: 272
-Celsius: 3.6
-Raw: 273
-Celsius: 3.7
-Raw: 275
-Celsius: 3.9
-Raw: 276
-Celsius: 4.0
-Raw: 277
-Celsius: 4.1
-Raw: 279
-Celsius: 4.3
-Raw: 279
-Celsius: 4.3
-Raw: 280
-Celsius: 4.4
-Raw: 283
-Celsius: 4.7
-Raw: 283
-Celsius: 4.7
-Raw: 284
-Celsius: 4.8
-Raw: 285
-Celsius: 4.9
-Raw: 287
-Celsius: 5.1
-Raw: 288
-Celsius: 5.2
-Raw: 289
-Celsius: 5.3
-Raw: 290
-Celsius: 5.4
-Raw: 292
-Celsius: 5.6
-Raw: 293
-Celsius: 5.7
-Raw: 295
-Celsius: 5.9
-Raw: 296
-Celsius: 6.0
-Raw: 296
-Celsius: 6.0
-Raw: 298
-Celsius: 6.1
-Raw: 299
-Celsius: 6.2
-Raw: 301
-Celsius: 6.4
-Raw: 302
-Celsius: 6.5
-Raw: 303
-Celsius: 6.6
-Raw: 303
-Celsius: 6.6
-Raw: 304
-Celsius: 6.7
-Raw: 307
-Celsius: 7.0
-Raw: 307
-Celsius: 7.0
-Raw: 308
-Celsius: 7.1
-Raw: 308
-Celsius: 7.1
-Raw: 311
-Celsius: 7.4
-Raw: 312
-Celsius: 7.5
-Raw: 314
-Celsius: 7.7
-Raw: 314
-Celsius: 7.7
-Raw: 315
-Celsius: 7.8
-Raw: 316
-Celsius: 7.9
-Raw: 317
-Celsius: 8.0
-Raw: 319
-Celsius: 8.1
-Raw: 319
-Celsius: 8.1
-Raw: 321
-Celsius: 8.3
-Raw: 321
-Celsius: 8.3
-Raw: 323
-Celsius: 8.5
-Raw: 324
-Celsius: 8.6
-Raw: 325
-Celsius: 8.7
-Raw: 326
-Celsius: 8.8
-Raw: 326
-Celsius: 8.8
-Raw: 328
-Celsius: 9.0
-Raw: 329
-Celsius: 9.1
-Raw: 330
-Celsius: 9.2
-Raw: 331
-Celsius: 9.3
-Raw: 332
-Celsius: 9.4
-Raw: 333
-Celsius: 9.4
-Raw: 333
-Celsius: 9.4
-Raw: 335
-Celsius: 9.6
-Raw: 336
-Celsius: 9.7
-Raw: 337
-Celsius: 9.8
-Raw: 338
-Celsius: 9.9
-Raw: 339
-Celsius: 10.0
-Raw: 340
-Celsius: 10.1
-Raw: 340
-Celsius: 10.1
-Raw: 342
-Celsius: 10.3
-Raw: 343
-Celsius: 10.4
-Raw: 343
-Celsius: 10.4
-Raw: 344
-Celsius: 10.5
-Raw: 345
-Celsius: 10.6
-Raw: 346
-Celsius: 10.6
-Raw: 347
-Celsius: 10.7
-Raw: 347
-Celsius: 10.7
-Raw: 349
-Celsius: 10.9
-Raw: 349
-Celsius: 10.9
-Raw: 350
-Celsius: 11.0
-Raw: 351
-Celsius: 11.1
-Raw: 352
-Celsius: 11.2
-Raw: 352
-Celsius: 11.2
-Raw: 353
-Celsius: 11.3
-Raw: 354
-Celsius: 11.4
-Raw: 355
-Celsius: 11.5
-Raw: 355
-Celsius: 11.5
-Raw: 357
-Celsius: 11.6
-Raw: 357
-Celsius: 11.6
-Raw: 358
-Celsius: 11.7
-Raw: 358
-Celsius: 11.7
-Raw: 360
-Celsius: 11.9
-Raw: 360
-Celsius: 11.9
-Raw: 361
-Celsius: 12.0
-Raw: 361
-Celsius: 12.0
-Raw: 363
-Celsius: 12.2
-Raw: 362
-Celsius: 12.1
-Raw: 363
-Celsius: 12.2
-Raw: 363
-Celsius: 12.2
-Raw: 366
-Celsius: 12.5
-Raw: 366
-Celsius: 12.5
-Raw: 366
-Celsius: 12.5
-Raw: 367
-Celsius: 12.5
-Raw: 368
-Celsius: 12.6
-Raw: 368
-Celsius: 12.6
-Raw: 369
-Celsius: 12.7
-Raw: 368
-Celsius: 12.6
-Raw: 369
-Celsius: 12.7
-Raw: 370
-Celsius: 12.8
-Raw: 369
-Celsius: 12.7
-Raw: 371
-Celsius: 12.9
-Raw: 372
-Celsius: 13.0
-Raw: 373
-Celsius: 13.1
-Raw: 372
-Celsius: 13.0
-Raw: 374
-Celsius: 13.2
-Raw: 375
-Celsius: 13.3
-Raw: 374
-Celsius: 13.2
-Raw: 376
-Celsius: 13.3
-Raw: 377
-Celsius: 13.4
-Raw: 377
-Celsius: 13.4
-Raw: 377
-Celsius: 13.4
-Raw: 379
-Celsius: 13.6
-Raw: 379
-Celsius: 13.6
-Raw: 380
-Celsius: 13.7
-Raw: 377
-Celsius: 13.4
-Raw: 380
-Celsius: 13.7
-Raw: 379
-Celsius: 13.6
-Raw: 380
-Celsius: 13.7
-Raw: 381
-Celsius: 13.8
-Raw: 382
-Celsius: 13.9
-Raw: 384
-Celsius: 14.1
-Raw: 384
-Celsius: 14.1
-Raw: 383
-Celsius: 14.0
-Raw: 386
-Celsius: 14.2
-Raw: 386
-Celsius: 14.2
-Raw: 385
-Celsius: 14.2
-Raw: 387
-Celsius: 14.3
-Raw: 387
-Celsius: 14.3
-Raw: 388
-Celsius: 14.4
-Raw: 388
-Celsius: 14.4
-Raw: 389
-Celsius: 14.5
-Raw: 390
-Celsius: 14.6
-Raw: 390
-Celsius: 14.6
-Raw: 389
-Celsius: 14.5
-Raw: 390
-Celsius: 14.6
-Raw: 392
-Celsius: 14.8
-Raw: 391
-Celsius: 14.7
-Raw: 390
-Celsius: 14.6
-Raw: 391
-Celsius: 14.7
-Raw: 392
-Celsius: 14.8
-Raw: 392
-Celsius: 14.8
-Raw: 394
-Celsius: 15.0
-Raw: 392
-Celsius: 14.8
-Raw: 395
-Celsius: 15.0
-Raw: 396
-Celsius: 15.1
-Raw: 397
-Celsius: 15.2
-Raw: 396
-Celsius: 15.1
-Raw: 397
-Celsius: 15.2
-Raw: 397
-Celsius: 15.2
-Raw: 398
-Celsius: 15.3
-Raw: 396
-Celsius: 15.1
-Raw: 399
-Celsius: 15.4
-Raw: 398
-Celsius: 15.3
-Raw: 399
-Celsius: 15.4
-Raw: 398
-Celsius: 15.3
-Raw: 400
-Celsius: 15.5
-Raw: 400
-Celsius: 15.5
-Raw: 399
-Celsius: 15.4
-Raw: 402
-Celsius: 15.7
-Raw: 402
-Celsius: 15.7
-Raw: 401
-Celsius: 15.6
-Raw: 404
-Celsius: 15.8
-Raw: 402
-Celsius: 15.7
-Raw: 404
-Celsius: 15.8
-Raw: 404
-Celsius: 15.8
-Raw: 405
-Celsius: 15.9
-Raw: 405
-Celsius: 15.9
-Raw: 405
-Celsius: 15.9
-Raw: 405
-Celsius: 15.9
-Raw: 405
-Celsius: 15.9
-Raw: 405
-Celsius: 15.9
-Raw: 406
-Celsius: 16.0
-Raw: 406
-Celsius: 16.0
-Raw: 406
-Celsius: 16.0
-Raw: 407
-Celsius: 16.1
-Raw: 408
-Celsius: 16.2
-Raw: 407
-Celsius: 16.1
-Raw: 408
-Celsius: 16.2
-Raw: 409
-Celsius: 16.3
-Raw: 410
-Celsius: 16.4
-Raw: 411
-Celsius: 16.5
-Raw: 411
-Celsius: 16.5
-Raw: 412
-Celsius: 16.5
-Raw: 412
-Celsius: 16.5
-Raw: 412
-Celsius: 16.5
-Raw: 412
-Celsius: 16.5
-Raw: 413
-Celsius: 16.6
-Raw: 413
-Celsius: 16.6
-Raw: 412
-Celsius: 16.5
-Raw: 413
-Celsius: 16.6
-Raw: 413
-Celsius: 16.6
-Raw: 415
-Celsius: 16.8
-Raw: 415
-Celsius: 16.8
-Raw: 414
-Celsius: 16.7
-Raw: 417
-Celsius: 17.0
-Raw: 415
-Celsius: 16.8
-Raw: 415
-Celsius: 16.8
-Raw: 417
-Celsius: 17.0
-Raw: 417
-Celsius: 17.0
-Raw: 419
-Celsius: 17.2
-Raw: 418
-Celsius: 17.1
-Raw: 419
-Celsius: 17.2
-Raw: 419
-Celsius: 17.2
-Raw: 421
-Celsius: 17.3
-Raw: 418
-Celsius: 17.1
-Raw: 419
-Celsius: 17.2
-Raw: 418
-Celsius: 17.1
-Raw: 419
-Celsius: 17.2
-Raw: 420
-Celsius: 17.2
-Raw: 420
-Celsius: 17.2
-Raw: 421
-Celsius: 17.3
-Raw: 422
-Celsius: 17.4
-Raw: 421
-Celsius: 17.3
-Raw: 422
-Celsius: 17.4
-Raw: 424
-Celsius: 17.6
-Raw: 423
-Celsius: 17.5
-Raw: 425
-Celsius: 17.7
-Raw: 425
-Celsius: 17.7
-Raw: 425
-Celsius: 17.7
-Raw: 426
-Celsius: 17.8
-Raw: 426
-Celsius: 17.8
-Raw: 427
-Celsius: 17.9
-Raw: 423
-Celsius: 17.5
-Raw: 426
-Celsius: 17.8
-Raw: 425
-Celsius: 17.7
-Raw: 425
-Celsius: 17.7
-Raw: 425
-Celsius: 17.7
-Raw: 425
-Celsius: 17.7
-Raw: 426
-Celsius: 17.8
-Raw: 427
-Celsius: 17.9
-Raw: 428
-Celsius: 17.9
-Raw: 430
-Celsius: 18.1
-Raw: 426
-Celsius: 17.8
-Raw: 430
-Celsius: 18.1
-Raw: 429
-Celsius: 18.0
-Raw: 430
-Celsius: 18.1
-Raw: 430
-Celsius: 18.1
-Raw: 431
-Celsius: 18.2
-Raw: 430
-Celsius: 18.1
-Raw: 431
-Celsius: 18.2
-Raw: 429
-Celsius: 18.0
-Raw: 433
-Celsius: 18.4
-Raw: 431
-Celsius: 18.2
-Raw: 431
-Celsius: 18.2
-Raw: 431
-Celsius: 18.2
-Raw: 432
-Celsius: 18.3
-Raw: 433
-Celsius: 18.4
-Raw: 433
-Celsius: 18.4
-Raw: 434
-Celsius: 18.5
-Raw: 435
-Celsius: 18.6
-Raw: 435
-Celsius: 18.6
-Raw: 436
-Celsius: 18.6
-Raw: 436
-Celsius: 18.6
-Raw: 436
-Celsius: 18.6
-Raw: 435
-Celsius: 18.6
-Raw: 436
-Celsius: 18.6
-Raw: 437
-Celsius: 18.7
-Raw: 435
-Celsius: 18.6
-Raw: 436
-Celsius: 18.6
-Raw: 438
-Celsius: 18.8
-Raw: 436
-Celsius: 18.6
-Raw: 437
-Celsius: 18.7
-Raw: 436
-Celsius: 18.6
-Raw: 437
-Celsius: 18.7
-Raw: 437
-Celsius: 18.7
-Raw: 438
-Celsius: 18.8
-Raw: 438
-Celsius: 18.8
-Raw: 437
-Celsius: 18.7
-Raw: 437
-Celsius: 18.7
-Raw: 439
-Celsius: 18.9
-Raw: 440
-Celsius: 19.0
-Raw: 440
-Celsius: 19.0
-Raw: 441
-Celsius: 19.1
-Raw: 439
-Celsius: 18.9
-Raw: 441
-Celsius: 19.1
-Raw: 442
-Celsius: 19.2
-Raw: 440
-Celsius: 19.0
-Raw: 441
-Celsius: 19.1
-Raw: 441
-Celsius: 19.1
-Raw: 441
-Celsius: 19.1
-Raw: 440
-Celsius: 19.0
-Raw: 440
-Celsius: 19.0
-Raw: 442
-Celsius: 19.2
-Raw: 443
-Celsius: 19.3
-Raw: 441
-Celsius: 19.1
-Raw: 443
-Celsius: 19.3
-Raw: 442
-Celsius: 19.2
-Raw: 442
-Celsius: 19.2
-Raw: 444
-Celsius: 19.3
-Raw: 444
-Celsius: 19.3
-Raw: 445
-Celsius: 19.4
-Raw: 446
-Celsius: 19.5
-Raw: 444
-Celsius: 19.3
-Raw: 444
-Celsius: 19.3
-Raw: 444
-Celsius: 19.3
-Raw: 443
-Celsius: 19.3
-Raw: 444
-Celsius: 19.3
-Raw: 443
-Celsius: 19.3
-Raw: 445
-Celsius: 19.4
-Raw: 445
-Celsius: 19.4
-Raw: 444
-Celsius: 19.3
-Raw: 445
-Celsius: 19.4
-Raw: 445
-Celsius: 19.4
-Raw: 447
-Celsius: 19.6
-Raw: 447
-Celsius: 19.6
-Raw: 448
-Celsius: 19.7
-Raw: 448
-Celsius: 19.7
-Raw: 446
-Celsius: 19.5
-Raw: 447
-Celsius: 19.6
-Raw: 447
-Celsius: 19.6
-Raw: 447
-Celsius: 19.6
-Raw: 447
-Celsius: 19.6
-Raw: 447
-Celsius: 19.6
-Raw: 446
-Celsius: 19.5
-Raw: 447
-Celsius: 19.6
-Raw: 447
-Celsius: 19.6
-Raw: 448
-Celsius: 19.7
-Raw: 448
-Celsius: 19.7
-Raw: 448
-Celsius: 19.7
-Raw: 449
-Celsius: 19.8
-Raw: 451
-Celsius: 20.0
-Raw: 448
-Celsius: 19.7
-Raw: 449
-Celsius: 19.8
-Raw: 451
-Celsius: 20.0
-Raw: 450
-Celsius: 19.9
-Raw: 450
-Celsius: 19.9
-Raw: 450
-Celsius: 19.9
-Raw: 450
-Celsius: 19.9
-Raw: 449
-Celsius: 19.8
-Raw: 452
-Celsius: 20.0
-Raw: 452
-Celsius: 20.0
-Raw: 449
-Celsius: 19.8
-Raw: 450
-Celsius: 19.9
-Raw: 450
-Celsius: 19.9
-Raw: 450
-Celsius: 19.9
-Raw: 451
-Celsius: 20.0
-Raw: 449
-Celsius: 19.8
-Raw: 451
-Celsius: 20.0
-Raw: 453
-Celsius: 20.1
-Raw: 451
-Celsius: 20.0
-Raw: 452
-Celsius: 20.0
-Raw: 453
-Celsius: 20.1
-Raw: 452
-Celsius: 20.0
-Raw: 454
-Celsius: 20.2
-Raw: 453
-Celsius: 20.1
-Raw: 453
-Celsius: 20.1
-Raw: 453
-Celsius: 20.1
-Raw: 453
-Celsius: 20.1
-Raw: 453
-Celsius: 20.1
-Raw: 452
-Celsius: 20.0
-Raw: 452
-Celsius: 20.0
-Raw: 453
-Celsius: 20.1
-Raw: 454
-Celsius: 20.2
-Raw: 452
-Celsius: 20.0
-Raw: 453
-Celsius: 20.1
-Raw: 455
-Celsius: 20.3
-Raw: 455
-Celsius: 20.3
-Raw: 454
-Celsius: 20.2
-Raw: 455
-Celsius: 20.3
-Raw: 455
-Celsius: 20.3
-Raw: 456
-Celsius: 20.4
-Raw: 455
-Celsius: 20.3
-Raw: 456
-Celsius: 20.4
-Raw: 455
-Celsius: 20.3
-Raw: 455
-Celsius: 20.3
-Raw: 454
-Celsius: 20.2
-Raw: 455
-Celsius: 20.3
-Raw: 455
-Celsius: 20.3
-Raw: 455
-Celsius: 20.3
-Raw: 455
-Celsius: 20.3
-Raw: 455
-Celsius: 20.3
-Raw: 457
-Celsius: 20.5
-Raw: 455
-Celsius: 20.3
-Raw: 456
-Celsius: 20.4
-Raw: 459
-Celsius: 20.7
-Raw: 457
-Celsius: 20.5
-Raw: 457
-Celsius: 20.5
-Raw: 457
-Celsius: 20.5
-Raw: 457
-Celsius: 20.5
-Raw: 457
-Celsius: 20.5
-Raw: 457
-Celsius: 20.5
-Raw: 457
-Celsius: 20.5
-Raw: 456
-Celsius: 20.4
-Raw: 458
-Celsius: 20.6
-Raw: 457
-Celsius: 20.5
-Raw: 456
-Celsius: 20.4
-Raw: 457
-Celsius: 20.5
-Raw: 457
-Celsius: 20.5
-Raw: 457
-Celsius: 20.5
-Raw: 458
-Celsius: 20.6
-Raw: 459
-Celsius: 20.7
-Raw: 457
-Celsius: 20.5
-Raw: 459
-Celsius: 20.7
-Raw: 459
-Celsius: 20.7
-Raw: 460
-Celsius: 20.8
-Raw: 461
-Celsius: 20.8
-Raw: 460
-Celsius: 20.8
-Raw: 460
-Celsius: 20.8
-Raw: 460
-Celsius: 20.8
-Raw: 460
-Celsius: 20.8
-Raw: 458
-Celsius: 20.6
-Raw: 460
-Celsius: 20.8
-Raw: 460
-Celsius: 20.8
-Raw: 458
-Celsius: 20.6
-Raw: 460
-Celsius: 20.8
-Raw: 460
-Celsius: 20.8
-Raw: 460
-Celsius: 20.8
-Raw: 460
-Celsius: 20.8
-Raw: 461
-Celsius: 20.8
-Raw: 459
-Celsius: 20.7
-Raw: 460
-Celsius: 20.8
-Raw: 461
-Celsius: 20.8
-Raw: 461
-Celsius: 20.8
-Raw: 461
-Celsius: 20.8
-Raw: 462
-Celsius: 20.9
-Raw: 462
-Celsius: 20.9
-Raw: 462
-Celsius: 20.9
-Raw: 462
-Celsius: 20.9
-Raw: 462
-Celsius: 20.9
-Raw: 462
-Celsius: 20.9
-Raw: 460
-Celsius: 20.8
-Raw: 463
-Celsius: 21.0
-Raw: 462
-Celsius: 20.9
-Raw: 462
-Celsius: 20.9
-Raw: 462
-Celsius: 20.9
-Raw: 462
-Celsius: 20.9
-Raw: 462
-Celsius: 20.9
-Raw: 465
-Celsius: 21.2
-Raw: 463
-Celsius: 21.0
-Raw: 464
-Celsius: 21.1
-Raw: 464
-Celsius: 21.1
-Raw: 465
-Celsius: 21.2
-Raw: 465
-Celsius: 21.2
-Raw: 464
-Celsius: 21.1
-Raw: 464
-Celsius: 21.1
-Raw: 463
-Celsius: 21.0
-Raw: 464
-Celsius: 21.1
-Raw: 463
-Celsius: 21.0
-Raw: 463
-Celsius: 21.0
-Raw: 463
-Celsius: 21.0
-Raw: 462
-Celsius: 20.9
-Raw: 464
-Celsius: 21.1
-Raw: 465
-Celsius: 21.2
-Raw: 465
-Celsius: 21.2
-Raw: 464
-Celsius: 21.1
-Raw: 467
-Celsius: 21.4
-Raw: 464
-Celsius: 21.1
-Raw: 466
-Celsius: 21.3
-Raw: 466
-Celsius: 21.3
-Raw: 465
-Celsius: 21.2
-Raw: 466
-Celsius: 21.3
-Raw: 465
-Celsius: 21.2
-Raw: 466
-Celsius: 21.3
-Raw: 465
-Celsius: 21.2
-Raw: 465
-Celsius: 21.2
-Raw: 465
-Celsius: 21.2
-Raw: 466
-Celsius: 21.3
-Raw: 464
-Celsius: 21.1
-Raw: 463
-Celsius: 21.0
-Raw: 466
-Celsius: 21.3
-Raw: 464
-Celsius: 21.1
-Raw: 466
-Celsius: 21.3
-Raw: 466
-Celsius: 21.3
-Raw: 465
-Celsius: 21.2
-Raw: 469
-Celsius: 21.5
-Raw: 468
-Celsius: 21.5
-Raw: 467
-Celsius: 21.4
-Raw: 466
-Celsius: 21.3
-Raw: 467
-Celsius: 21.4
-Raw: 467
-Celsius: 21.4
-Raw: 467
-Celsius: 21.4
-Raw: 467
-Celsius: 21.4
-Raw: 466
-Celsius: 21.3
-Raw: 467
-Celsius: 21.4
-Raw: 467
-Celsius: 21.4
-Raw: 467
-Celsius: 21.4
-Raw: 467
-Celsius: 21.4
-Raw: 467
-Celsius: 21.4
-Raw: 467
-Celsius: 21.4
-Raw: 467
-Celsius: 21.4
-Raw: 467
-Celsius: 21.4
-Raw: 467
-Celsius: 21.4
-Raw: 469
-Celsius: 21.5
-Raw: 468
-Celsius: 21.5
-Raw: 468
-Celsius: 21.5
-Raw: 468
-Celsius: 21.5
-Raw: 468
-Celsius: 21.5
-Raw: 470
-Celsius: 21.6
-Raw: 469
-Celsius: 21.5
-Raw: 468
-Celsius: 21.5
-Raw: 467
-Celsius: 21.4
-Raw: 469
-Celsius: 21.5
-Raw: 469
-Celsius: 21.5
-Raw: 468
-Celsius: 21.5
-Raw: 468
-Celsius: 21.5
-Raw: 467
-Celsius: 21.4
-Raw: 469
-Celsius: 21.5
-Raw: 468
-Celsius: 21.5
-Raw: 470
-Celsius: 21.6
-Raw: 469
-Celsius: 21.5
-Raw: 471
-Celsius: 21.7
-Raw: 469
-Celsius: 21.5
-Raw: 469
-Celsius: 21.5
-Raw: 469
-Celsius: 21.5
-Raw: 471
-Celsius: 21.7
-Raw: 471
-Celsius: 21.7
-Raw: 472
-Celsius: 21.8
-Raw: 470
-Celsius: 21.6
-Raw: 470
-Celsius: 21.6
-Raw: 470
-Celsius: 21.6
-Raw: 470
-Celsius: 21.6
-Raw: 470
-Celsius: 21.6
-Raw: 470
-Celsius: 21.6
-Raw: 470
-Celsius: 21.6
-Raw: 468
-Celsius: 21.5
-Raw: 470
-Celsius: 21.6
-Raw: 470
-Celsius: 21.6
-Raw: 469
-Celsius: 21.5
-Raw: 471
-Celsius: 21.7
-Raw: 471
-Celsius: 21.7
-Raw: 471
-Celsius: 21.7
-Raw: 471
-Celsius: 21.7
-Raw: 471
-Celsius: 21.7
-Raw: 472
-Celsius: 21.8
-Raw: 472
-Celsius: 21.8
-Raw: 471
-Celsius: 21.7
-Raw: 471
-Celsius: 21.7
-Raw: 469
-Celsius: 21.5
-Raw: 471
-Celsius: 21.7
-Raw: 470
-Celsius: 21.6
-Raw: 470
-Celsius: 21.6
-Raw: 471
-Celsius: 21.7
-Raw: 472
-Celsius: 21.8
-Raw: 471
-Celsius: 21.7
-Raw: 472
-Celsius: 21.8
-Raw: 470
-Celsius: 21.6
-Raw: 470
-Celsius: 21.6
-Raw: 472
-Celsius: 21.8
-Raw: 472
-Celsius: 21.8
-Raw: 472
-Celsius: 21.8
-Raw: 473
-Celsius: 21.9
-Raw: 473
-Celsius: 21.9
-Raw: 473
-Celsius: 21.9
-Raw: 469
-Celsius: 21.5
-Raw: 472
-Celsius: 21.8
-Raw: 470
-Celsius: 21.6
-Raw: 471
-Celsius: 21.7
-Raw: 472
-Celsius: 21.8
-Raw: 472
-Celsius: 21.8
-Raw: 472
-Celsius: 21.8
-Raw: 472
-Celsius: 21.8
-Raw: 472
-Celsius: 21.8
-Raw: 472
-Celsius: 21.8
-Raw: 472
-Celsius: 21.8
-Raw: 473
-Celsius: 21.9
-Raw: 473
-Celsius: 21.9
-Raw: 473
-Celsius: 21.9
-Raw: 473
-Celsius: 21.9
-Raw: 473
-Celsius: 21.9
-Raw: 473
-Celsius: 21.9
-Raw: 472
-Celsius: 21.8
-Raw: 475
-Celsius: 22.1
-Raw: 472
-Celsius: 21.8
-Raw: 472
-Celsius: 21.8
-Raw: 472
-Celsius: 21.8
-Raw: 472
-Celsius: 21.8
-Raw: 472
-Celsius: 21.8
-Raw: 472
-Celsius: 21.8
-Raw: 473
-Celsius: 21.9
-Raw: 473
-Celsius: 21.9
-Raw: 473
-Celsius: 21.9
-Raw: 472
-Celsius: 21.8
-Raw: 473
-Celsius: 21.9
-Raw: 474
-Celsius: 22.0
-Raw: 474
-Celsius: 22.0
-Raw: 473
-Celsius: 21.9
-Raw: 474
-Celsius: 22.0
-Raw: 473
-Celsius: 21.9
-Raw: 474
-Celsius: 22.0
-Raw: 474
-Celsius: 22.0
-Raw: 473
-Celsius: 21.9
-Raw: 473
-Celsius: 21.9
-Raw: 473
-Celsius: 21.9
-Raw: 473
-Celsius: 21.9
-Raw: 473
-Celsius: 21.9
-Raw: 473
-Celsius: 21.9
-Raw: 473
-Celsius: 21.9
-Raw: 474
-Celsius: 22.0
-Raw: 472
-Celsius: 21.8
-Raw: 476
-Celsius: 22.2
-Raw: 474
-Celsius: 22.0
-Raw: 475
-Celsius: 22.1
-Raw: 474
-Celsius: 22.0
-Raw: 475
-Celsius: 22.1
-Raw: 474
-Celsius: 22.0
-Raw: 476
-Celsius: 22.2
-Raw: 475
-Celsius: 22.1
-Raw: 474
-Celsius: 22.0
-Raw: 475
-Celsius: 22.1
-Raw: 474
-Celsius: 22.0
-Raw: 473
-Celsius: 21.9
-Raw: 474
-Celsius: 22.0
-Raw: 475
-Celsius: 22.1
-Raw: 475
-Celsius: 22.1
-Raw: 474
-Celsius: 22.0
-Raw: 473
-Celsius: 21.9
-Raw: 475
-Celsius: 22.1
-Raw: 475
-Celsius: 22.1
-Raw: 476
-Celsius: 22.2
-Raw: 476
-Celsius: 22.2
-Raw: 475
-Celsius: 22.1
-Raw: 475
-Celsius: 22.1
-Raw: 476
-Celsius: 22.2
-Raw: 475
-Celsius: 22.1
-Raw: 475
-Celsius: 22.1
-Raw: 476
-Celsius: 22.2
-Raw: 475
-Celsius: 22.1
-Raw: 475
-Celsius: 22.1
-Raw: 473
-Celsius: 21.9
-Raw: 475
-Celsius: 22.1
-Raw: 474
-Celsius: 22.0
-Raw: 474
-Celsius: 22.0
-Raw: 474
-Celsius: 22.0
-Raw: 474
-Celsius: 22.0
-Raw: 474
-Celsius: 22.0
-Raw: 477
-Celsius: 22.2
-Raw: 477
-Celsius: 22.2
-Raw: 475
-Celsius: 22.1
-Raw: 476
-Celsius: 22.2
-Raw: 476
-Celsius: 22.2
-Raw: 476
-Celsius: 22.2
-Raw: 477
-Celsius: 22.2
-Raw: 478
-Celsius: 22.3
-Raw: 477
-Celsius: 22.2
-Raw: 476
-Celsius: 22.2
-Raw: 475
-Celsius: 22.1
-Raw: 475
-Celsius: 22.1
-Raw: 475
-Celsius: 22.1
-Raw: 475
-Celsius: 22.1
-Raw: 475
-Celsius: 22.1
+// PI towards CoolingTemperature while cooling or holding, off while defrosting; the duty
+// moves by at most RampStep per period so the Peltier never sees a current step
+void handlePeltier(){
+    int target = 0;
+    if (state != Defrosting){
+        int error = getTemperature() - CoolingTemperature;
+        integral = constrain(integral + error * Ki, 0, (long)MaxDuty << 4);
+        target = constrain(error * Kp + (integral >> 4), 0, MaxDuty);
+    }
+
+    duty = constrain(target, duty - RampStep, duty + RampStep);
+    analogWrite(PeltierPin, duty);
+}
 
-*/
\ No newline at end of file
+// Cooling: 1s blink, Holding: steady, Defrosting: short flash every 2s
+void handleLed(unsigned long now){
+    unsigned int period;
+    switch (state){
+    case Cooling:
+        period = 1000;
+        break;
+    case Holding:
+        period = 0;
+        break;
+    default:
+        period = ledState ? 1900 : 100;
+        break;
+    }
+
+    if (period == 0){
+        ledState = true;
+        digitalWrite(LedPin, HIGH);
+        return;
+    }
+
+    if (now - ledAt >= period){
+        ledAt = now;
+        ledState = !ledState;
+        digitalWrite(LedPin, ledState ? HIGH : LOW);
+    }
+}
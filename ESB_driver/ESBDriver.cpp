@@ -1,6 +1,13 @@
 #include "ESBDriver.h"
 
-ESBDriver::ESBDriver(IPAddress &id,
+// QPI, QMN, QID, sent before every command like the vendor software does
+static const byte helloCommands[3][6] = {
+    {0x51, 0x50, 0x49, 0xBE, 0xAC, 0x0D},
+    {0x51, 0x4D, 0x4E, 0xBB, 0x64, 0x0D},
+    {0x51, 0x49, 0x44, 0xD6, 0xEA, 0x0D}};
+static const byte qpigsCommand[8] = {0x51, 0x50, 0x49, 0x47, 0x53, 0xB7, 0xA9, 0x0D};
+
+ESBDriver::ESBDriver(IPAddress &ip,
                      const char *ssid,
                      const char *pwd) : server(80),
                                         gateway(192, 168, 100, 1),
@@ -46,6 +53,12 @@ void ESBDriver::begin()
     this->server.on("/sbu", std::bind(&ESBDriver::handleSBU, this));
     this->server.on("/sub", std::bind(&ESBDriver::handleSUB, this));
     this->server.on("/worktype", std::bind(&ESBDriver::handleWorkType, this));
+    this->server.on("/history", std::bind(&ESBDriver::handleHistory, this));
+    this->server.on("/history/days", std::bind(&ESBDriver::handleHistoryDays, this));
+    this->server.on("/mode", std::bind(&ESBDriver::handleMode, this));
+#ifdef METRICS_ENABLED
+    this->server.on("/metrics", [this]() { this->server.send(200, "text/plain; version=0.0.4", Metrics::toString()); });
+#endif
 
     this->server.on("/ota", HTTP_OPTIONS, std::bind(&ESBDriver::handleOptions, this));
     this->server.on("/reset", HTTP_OPTIONS, std::bind(&ESBDriver::handleOptions, this));
@@ -58,6 +71,9 @@ void ESBDriver::begin()
     this->server.on("/sbu", HTTP_OPTIONS, std::bind(&ESBDriver::handleOptions, this));
     this->server.on("/sub", HTTP_OPTIONS, std::bind(&ESBDriver::handleOptions, this));
     this->server.on("/worktype", HTTP_OPTIONS, std::bind(&ESBDriver::handleOptions, this));
+    this->server.on("/history", HTTP_OPTIONS, std::bind(&ESBDriver::handleOptions, this));
+    this->server.on("/history/days", HTTP_OPTIONS, std::bind(&ESBDriver::handleOptions, this));
+    this->server.on("/mode", HTTP_OPTIONS, std::bind(&ESBDriver::handleOptions, this));
 
     this->server.onNotFound(std::bind(&ESBDriver::handleNotFound, this));
     this->server.begin();
@@ -72,6 +88,9 @@ void ESBDriver::begin()
     ArduinoOTA.begin();
     getTime();
 
+    this->history.begin();
+    this->modeController.begin();
+
     nextRead = millis() + 100;
 }
 
@@ -121,8 +140,10 @@ void ESBDriver::getTime()
 
 void ESBDriver::handle()
 {
+    METRICS_LOOP();
     this->server.handleClient();
 
+    this->handleExchange();
     this->handleTimeEvents();
 
     if (this->otaEnabled)
@@ -136,7 +157,7 @@ void ESBDriver::handleTimeEvents()
     if (this->nextRead < millis())
     {
         this->timer++;
-        if (this->timer > 36000)
+        if (this->timer >= 36000)
         {
             this->timer = 0;
         }
@@ -145,7 +166,35 @@ void ESBDriver::handleTimeEvents()
         if (this->timer % 600 == 0)
         {
             this->getTime();
-            //this->setWorkType();
+        }
+
+        if (this->timer % 3000 == 0)
+        {
+            this->sampleParams();
+        }
+
+        // flushed once the day energy is in
+        if (this->timer == 0)
+        {
+            this->isDayEnergyDue = this->isTimeSet();
+            if (!this->isDayEnergyDue)
+            {
+                this->history.flush();
+            }
+        }
+
+        if (this->exchange == Exchange::NoExchange)
+        {
+            if (this->isDayEnergyDue)
+            {
+                this->isDayEnergyDue = false;
+                this->dayEnergyDate = this->formatDate(this->getDate(), 8);
+                this->startExchange(Exchange::DayEnergyExchange);
+            }
+            else if (this->timer % 100 == 0)
+            {
+                this->startExchange(Exchange::ParamsExchange);
+            }
         }
     }
 }
@@ -175,127 +224,363 @@ void ESBDriver::handleRoot()
     String src = "<div>ESB Driver</div>";
     src += "<div><a href=\"/params\">params</a></div>";
     src += "<div><a href=\"/stats\">stats</a></div>";
+    src += "<div><a href=\"/history?format=csv\">history</a></div>";
+    src += "<div><a href=\"/history/days?format=csv\">history days</a></div>";
+    src += "<div><a href=\"/mode\">mode</a></div>";
 
     this->server.send(200, "text/html", src);
 }
 
 void ESBDriver::handleParams()
 {
-    byte qpigs[8] = {0x51, 0x50, 0x49, 0x47, 0x53, 0xB7, 0xA9, 0x0D};
-
-    this->sendHelloCommands();
-    this->write(qpigs, sizeof(qpigs));
-    String result = Serial.readString();
-    result.remove(0, 1);
-
+    // polled every 10 s in the background
     this->addCORSHeaders();
-    this->server.send(200, "text/plain", result);
+    this->server.send(200, "text/plain", this->params);
 }
 
 void ESBDriver::handleWorkType()
 {
-    String result;
-    switch (this->workType)
+    this->addCORSHeaders();
+    this->server.send(200, "text/plain", ModeController::toString(this->workType));
+}
+
+void ESBDriver::handleMode()
+{
+    ModeConfig &config = this->modeController.getConfig();
+
+    // other arguments, a cache-buster for one, leave the saved config alone
+    const char *names[] = {"enabled", "sbuPvVoltage", "subPvVoltage", "sbuSoc", "subSoc", "minDwell"};
+    bool hasConfig = false;
+    for (const char *name : names)
     {
-    case WorkType::sbu:
-        result = "sbu";
-        break;
+        hasConfig = hasConfig || this->server.hasArg(name);
+    }
 
-    case WorkType::sub:
-        result = "sub";
-        break;
+    if (hasConfig)
+    {
+        // parsed wide and checked before anything narrows into the config
+        long sbuPvVoltage = this->server.hasArg("sbuPvVoltage") ? lround(this->server.arg("sbuPvVoltage").toFloat() * 10) : config.sbuPvVoltage;
+        long subPvVoltage = this->server.hasArg("subPvVoltage") ? lround(this->server.arg("subPvVoltage").toFloat() * 10) : config.subPvVoltage;
+        long sbuSoc = this->server.hasArg("sbuSoc") ? this->server.arg("sbuSoc").toInt() : config.sbuSoc;
+        long subSoc = this->server.hasArg("subSoc") ? this->server.arg("subSoc").toInt() : config.subSoc;
+        long minDwell = this->server.hasArg("minDwell") ? this->server.arg("minDwell").toInt() : config.minDwell;
+
+        if (sbuPvVoltage < 0 || sbuPvVoltage > 65535 || subPvVoltage < 0 || subPvVoltage > 65535 ||
+            sbuSoc < 0 || sbuSoc > 100 || subSoc < 0 || subSoc > 100 ||
+            minDwell < 0 || minDwell > MODE_MAX_DWELL ||
+            subPvVoltage > sbuPvVoltage || subSoc > sbuSoc)
+        {
+            this->addCORSHeaders();
+            this->server.send(400, "text/plain", "invalid data");
+            return;
+        }
 
-    default:
-        result = "unknown";
+        if (this->server.hasArg("enabled"))
+        {
+            config.enabled = this->server.arg("enabled").toInt() != 0;
+        }
+        config.sbuPvVoltage = sbuPvVoltage;
+        config.subPvVoltage = subPvVoltage;
+        config.sbuSoc = sbuSoc;
+        config.subSoc = subSoc;
+        config.minDwell = minDwell;
+
+        this->modeController.saveConfig();
     }
 
+    String result = "enabled=" + String(config.enabled ? 1 : 0);
+    result += "\nsbuPvVoltage=" + String(config.sbuPvVoltage / 10.0f, 1);
+    result += "\nsubPvVoltage=" + String(config.subPvVoltage / 10.0f, 1);
+    result += "\nsbuSoc=" + String(config.sbuSoc);
+    result += "\nsubSoc=" + String(config.subSoc);
+    result += "\nminDwell=" + String(config.minDwell);
+    result += "\nworkType=" + String(ModeController::toString(this->workType));
+    result += "\n\n" + this->modeController.getLog();
+
     this->addCORSHeaders();
     this->server.send(200, "text/plain", result);
 }
 
 void ESBDriver::handleStats()
 {
-    this->sendHelloCommands();
-    CRC16 crc;
-    String query = "QEY";
+    this->waitExchange();
     DateTime date = this->getDate();
-    query += date.year;
 
-    for (byte i = 0; i < query.length(); i++)
+    String yearConsumption = this->sendQuery("QEY" + this->formatDate(date, 4));
+    yearConsumption.remove(0, 1);
+
+    String monthConsumption = this->sendQuery("QEM" + this->formatDate(date, 6));
+    monthConsumption.remove(0, 1);
+
+    String dayConsumption = this->sendQuery("QED" + this->formatDate(date, 8));
+    dayConsumption.remove(0, 1);
+
+    String totalConsumption = this->sendQuery("QET");
+    totalConsumption.remove(0, 1);
+
+    this->addCORSHeaders();
+    this->server.send(200, "text/plain", yearConsumption + "." + monthConsumption + "." + dayConsumption + "." + totalConsumption);
+}
+
+void ESBDriver::handleHistory()
+{
+    uint32_t from = this->server.hasArg("from") ? this->server.arg("from").toInt() : 0;
+    uint32_t to = this->server.hasArg("to") ? this->server.arg("to").toInt() : 0xFFFFFFFF;
+    bool csv = this->server.arg("format") == "csv";
+
+    this->addCORSHeaders();
+    this->server.setContentLength(CONTENT_LENGTH_UNKNOWN);
+    this->server.send(200, csv ? "text/csv" : "application/octet-stream", "");
+
+    if (csv)
     {
-        Serial.write(query[i]);
-        crc.add(query[i]);
+        this->server.sendContent("time,pvVoltage,pvPower,activePower,batteryVoltage,soc,load\n");
     }
 
-    uint16_t c = crc.getCRC();
-    Serial.write((byte)(c & 0xFF));
-    Serial.write((byte)((c >> 8) & 0xFF));
-    Serial.write(0x0D);
+    for (uint16_t i = 0; i < this->history.paramsCount(); i++)
+    {
+        ParamsSample &sample = this->history.getParams(i);
+        if (sample.time < from || sample.time > to)
+        {
+            continue;
+        }
 
-    String yearConsumption = Serial.readString();
-    yearConsumption.remove(0, 1);
+        if (csv)
+        {
+            this->server.sendContent(EnergyHistory::toCsv(sample));
+        }
+        else
+        {
+            this->server.sendContent((const char *)&sample, sizeof(sample));
+        }
+    }
 
-    crc.reset();
-    this->sendHelloCommands();
+    this->server.sendContent("");
+}
 
-    query = "QEM";
-    query += date.year;
-    query += date.month > 9 ? String(date.month) : ("0" + date.month);
-    for (byte i = 0; i < query.length(); i++)
+void ESBDriver::handleHistoryDays()
+{
+    uint32_t from = this->server.hasArg("from") ? this->server.arg("from").toInt() : 0;
+    uint32_t to = this->server.hasArg("to") ? this->server.arg("to").toInt() : 99999999;
+    bool csv = this->server.arg("format") == "csv";
+
+    this->addCORSHeaders();
+    this->server.setContentLength(CONTENT_LENGTH_UNKNOWN);
+    this->server.send(200, csv ? "text/csv" : "application/octet-stream", "");
+
+    if (csv)
     {
-        Serial.write(query[i]);
-        crc.add(query[i]);
+        this->server.sendContent("date,energy\n");
     }
 
-    c = crc.getCRC();
-    Serial.write((byte)(c & 0xFF));
-    Serial.write((byte)((c >> 8) & 0xFF));
-    Serial.write(0x0D);
+    for (uint16_t i = 0; i < this->history.daysCount(); i++)
+    {
+        DaySample &sample = this->history.getDay(i);
+        if (sample.date < from || sample.date > to)
+        {
+            continue;
+        }
 
-    String monthConsumption = Serial.readString();
-    monthConsumption.remove(0, 1);
+        if (csv)
+        {
+            this->server.sendContent(EnergyHistory::toCsv(sample));
+        }
+        else
+        {
+            this->server.sendContent((const char *)&sample, sizeof(sample));
+        }
+    }
 
-    crc.reset();
-    this->sendHelloCommands();
+    this->server.sendContent("");
+}
 
-    query = "QED";
-    query += date.year;
-    query += date.month > 9 ? String(date.month) : ("0" + date.month);
-    query += date.day > 9 ? String(date.day) : ("0" + date.day);
-    for (byte i = 0; i < query.length(); i++)
+void ESBDriver::startExchange(Exchange exchange)
+{
+    // late answers of a timed out exchange
+    while (Serial.available() > 0)
     {
-        Serial.write(query[i]);
-        crc.add(query[i]);
+        Serial.read();
     }
 
-    c = crc.getCRC();
-    Serial.write((byte)(c & 0xFF));
-    Serial.write((byte)((c >> 8) & 0xFF));
-    Serial.write(0x0D);
+    this->exchange = exchange;
+    this->exchangeStep = 0;
+    this->sendExchangeStep();
+}
 
-    String dayConsumption = Serial.readString();
-    dayConsumption.remove(0, 1);
+void ESBDriver::sendExchangeStep()
+{
+    this->reply = "";
+    this->exchangeAt = millis();
+
+    if (this->exchangeStep < 3)
+    {
+        this->write(helloCommands[this->exchangeStep], sizeof(helloCommands[0]));
+    }
+    else if (this->exchange == Exchange::ParamsExchange)
+    {
+        this->write(qpigsCommand, sizeof(qpigsCommand));
+    }
+    else if (this->exchange == Exchange::WorkTypeExchange)
+    {
+        this->writeWorkType(this->pendingWorkType);
+    }
+    else
+    {
+        String query = "QED" + this->dayEnergyDate;
+        this->writeQuery(query);
+    }
+}
+
+void ESBDriver::handleExchange()
+{
+    if (this->exchange == Exchange::NoExchange)
+    {
+        return;
+    }
+
+    while (Serial.available() > 0)
+    {
+        char c = Serial.read();
+        if (c == '\r')
+        {
+            this->nextExchangeStep(true);
+            return;
+        }
+
+        this->reply += c;
+    }
+
+    if (millis() - this->exchangeAt >= EXCHANGE_TIMEOUT)
+    {
+        this->nextExchangeStep(false);
+    }
+}
+
+void ESBDriver::nextExchangeStep(bool isAnswered)
+{
+    // hello answers are not used, a missing one does not stop the exchange
+    if (this->exchangeStep < 3)
+    {
+        this->exchangeStep++;
+        this->sendExchangeStep();
+        return;
+    }
+
+    Exchange exchange = this->exchange;
+    this->exchange = Exchange::NoExchange;
+
+    if (exchange == Exchange::ParamsExchange)
+    {
+        this->onParams(isAnswered);
+    }
+    else if (exchange == Exchange::WorkTypeExchange)
+    {
+        this->onWorkType(isAnswered && this->reply.substring(1, 4) == "ACK");
+    }
+    else
+    {
+        this->onDayEnergy(isAnswered);
+    }
+}
+
+// for the blocking queries, they share the serial line
+void ESBDriver::waitExchange()
+{
+    while (this->exchange != Exchange::NoExchange)
+    {
+        delay(1);
+        this->handleExchange();
+    }
+}
+
+void ESBDriver::onParams(bool isAnswered)
+{
+    if (!isAnswered)
+    {
+        return;
+    }
+
+    this->reply.remove(0, 1);
+    this->params = this->reply;
+    this->paramsTime = millis();
 
-    crc.reset();
+    if (this->isConnected && this->params.length() > 0)
+    {
+        this->telemetry.publish("qpigs", this->params);
+    }
+
+    WorkType workType = this->modeController.update(this->params, this->paramsTime);
+    if (workType != WorkType::Unknown)
+    {
+        this->pendingWorkType = workType;
+        this->startExchange(Exchange::WorkTypeExchange);
+    }
+}
+
+void ESBDriver::onWorkType(bool isAck)
+{
+    if (!isAck)
+    {
+        return;
+    }
+
+    this->workType = this->pendingWorkType;
+    this->modeController.setWorkType(this->pendingWorkType, this->timeClient.getEpochTime(), millis());
+}
+
+void ESBDriver::sampleParams()
+{
+    if (!this->isTimeSet() || this->paramsTime == 0)
+    {
+        return;
+    }
+
+    this->history.addParams(this->timeClient.getEpochTime(), this->params);
+}
+
+void ESBDriver::onDayEnergy(bool isAnswered)
+{
+    if (isAnswered && this->reply.length() >= 9 && this->reply[0] == '(')
+    {
+        this->history.setDayEnergy(this->dayEnergyDate.toInt(), this->reply.substring(1, 9).toInt());
+    }
+
+    this->history.flush();
+}
+
+bool ESBDriver::isTimeSet()
+{
+    return this->timeClient.getEpochTime() > 946684800UL;
+}
+
+String ESBDriver::formatDate(DateTime date, byte lenght)
+{
+    char buf[16];
+    sprintf(buf, "%04d%02d%02d%02d", date.year, date.month, date.day, date.hour);
+    buf[lenght] = 0;
+    return String(buf);
+}
+
+String ESBDriver::sendQuery(String query)
+{
+    METRICS_SCOPE("query");
     this->sendHelloCommands();
+    this->writeQuery(query);
+
+    return Serial.readStringUntil('\r');
+}
 
-    query = "QET";
+void ESBDriver::writeQuery(String &query)
+{
     for (byte i = 0; i < query.length(); i++)
     {
         Serial.write(query[i]);
-        crc.add(query[i]);
     }
 
-    c = crc.getCRC();
-    Serial.write((byte)(c & 0xFF));
+    uint16_t c = this->getCRC(query);
     Serial.write((byte)((c >> 8) & 0xFF));
+    Serial.write((byte)(c & 0xFF));
     Serial.write(0x0D);
-
-    String totalConsumption = Serial.readString();
-    totalConsumption.remove(0, 1);
-
-    this->addCORSHeaders();
-    this->server.send(200, "text/plain", yearConsumption + "." + monthConsumption + "." + dayConsumption + "." + totalConsumption);
 }
 
 void ESBDriver::handleQEY()
@@ -327,24 +612,23 @@ void ESBDriver::handleQE(const char *qe, byte lenght)
         return;
     }
 
+    this->waitExchange();
     this->sendHelloCommands();
     String hex = "";
-    CRC16 crc;
     String query = String(qe) + this->server.arg(0);
     for (byte i = 0; i < query.length(); i++)
     {
         Serial.write(query[i]);
-        crc.add(query[i]);
         hex += String(query[i], HEX);
     }
 
-    uint16_t c = crc.getCRC();
-    Serial.write((byte)(c & 0xFF));
+    uint16_t c = this->getCRC(query);
     Serial.write((byte)((c >> 8) & 0xFF));
+    Serial.write((byte)(c & 0xFF));
     Serial.write(0x0D);
 
-    hex += String((byte)(c & 0xFF), HEX);
     hex += String((byte)((c >> 8) & 0xFF), HEX);
+    hex += String((byte)(c & 0xFF), HEX);
 
     String result = Serial.readString();
 
@@ -352,21 +636,39 @@ void ESBDriver::handleQE(const char *qe, byte lenght)
     this->server.send(200, "text/plain", result + "." + hex);
 }
 
-void ESBDriver::sendHelloCommands()
+uint16_t ESBDriver::getCRC(String &query)
 {
-    byte qpi[6] = {0x51, 0x50, 0x49, 0xBE, 0xAC, 0x0D};
-    byte qmn[6] = {0x51, 0x4D, 0x4E, 0xBB, 0x64, 0x0D};
-    byte qid[6] = {0x51, 0x49, 0x44, 0xD6, 0xEA, 0x0D};
+    CRC16 crc;
+    for (byte i = 0; i < query.length(); i++)
+    {
+        crc.add(query[i]);
+    }
+
+    // the inverter expects CRC bytes that collide with '(', CR or LF incremented
+    uint8_t high = crc.getCRC() >> 8;
+    uint8_t low = crc.getCRC() & 0xFF;
+    if (high == 0x28 || high == 0x0D || high == 0x0A)
+    {
+        high++;
+    }
+    if (low == 0x28 || low == 0x0D || low == 0x0A)
+    {
+        low++;
+    }
 
-    this->write(qpi, sizeof(qpi));
-    Serial.readString();
-    this->write(qmn, sizeof(qmn));
-    Serial.readString();
-    this->write(qid, sizeof(qid));
-    Serial.readString();
+    return (high << 8) | low;
 }
 
-void ESBDriver::write(byte *buf, byte lenght)
+void ESBDriver::sendHelloCommands()
+{
+    for (byte i = 0; i < 3; i++)
+    {
+        this->write(helloCommands[i], sizeof(helloCommands[i]));
+        Serial.readStringUntil('\r');
+    }
+}
+
+void ESBDriver::write(const byte *buf, byte lenght)
 {
     for (byte i = 0; i < lenght; i++)
     {
@@ -376,63 +678,56 @@ void ESBDriver::write(byte *buf, byte lenght)
 
 void ESBDriver::handleSBU()
 {
-    byte sbu[8] = {0x50, 0x4F, 0x50, 0x30, 0x32, 0xE2, 0x0B, 0x0D};
-    this->sendHelloCommands();
+    bool result = this->sendWorkType(WorkType::sbu);
+    if (result)
+    {
+        this->modeController.setWorkType(WorkType::sbu, this->timeClient.getEpochTime(), millis());
+    }
 
-    this->workType = WorkType::sbu;
+    this->addCORSHeaders();
+    this->server.send(200, "text/plain", result ? "ACK" : "NAK");
+}
 
-    this->write(sbu, sizeof(sbu));
-    String result = Serial.readString();
+void ESBDriver::handleSUB()
+{
+    bool result = this->sendWorkType(WorkType::sub);
+    if (result)
+    {
+        this->modeController.setWorkType(WorkType::sub, this->timeClient.getEpochTime(), millis());
+    }
 
     this->addCORSHeaders();
-    this->server.send(200, "text/plain", result);
+    this->server.send(200, "text/plain", result ? "ACK" : "NAK");
 }
 
-void ESBDriver::handleSUB()
+bool ESBDriver::sendWorkType(WorkType workType)
 {
-    byte sub[8] = {0x50, 0x4F, 0x50, 0x30, 0x31, 0xD2, 0x69, 0x0D};
+    this->waitExchange();
     this->sendHelloCommands();
+    this->writeWorkType(workType);
 
-    this->workType = WorkType::sub;
-
-    this->write(sub, sizeof(sub));
-    String result = Serial.readString();
+    String ack = Serial.readStringUntil('\r');
+    if (ack.substring(1, 4) != "ACK")
+    {
+        return false;
+    }
 
-    this->addCORSHeaders();
-    this->server.send(200, "text/plain", result);
+    this->workType = workType;
+    return true;
 }
 
-void ESBDriver::setWorkType()
+void ESBDriver::writeWorkType(WorkType workType)
 {
-    byte qpigs[8] = {0x51, 0x50, 0x49, 0x47, 0x53, 0xB7, 0xA9, 0x0D};
     byte sbu[8] = {0x50, 0x4F, 0x50, 0x30, 0x32, 0xE2, 0x0B, 0x0D}; // PV, ACU, AC
     byte sub[8] = {0x50, 0x4F, 0x50, 0x30, 0x31, 0xD2, 0x69, 0x0D}; // PV, AC, ACU
 
-    this->sendHelloCommands();
-    this->write(qpigs, sizeof(qpigs));
-    String params = Serial.readString();
-    params.remove(0, 1);
-
-    int pvVoltage = params.substring(64, 67).toInt();
-    int soc = params.substring(50, 53).toInt();
-
-    if (this->workType != WorkType::sub && (pvVoltage < 250 || soc < 70))
+    if (workType == WorkType::sbu)
     {
-        this->write(sub, sizeof(sub));
-        String ack = Serial.readString();
-        if (ack.substring(1, 4) == "ACK")
-        {
-            this->workType = WorkType::sub;
-        }
+        this->write(sbu, sizeof(sbu));
     }
-    else if (this->workType != WorkType::sbu && pvVoltage >= 250 && soc >= 70)
+    else
     {
-        this->write(sbu, sizeof(sbu));
-        String ack = Serial.readString();
-        if (ack.substring(1, 4) == "ACK")
-        {
-            this->workType = WorkType::sbu;
-        }
+        this->write(sub, sizeof(sub));
     }
 }
 
@@ -11,6 +11,11 @@
 #include <ArduinoOTA.h>
 #include <CRC16.h>
 #include "FS.h"
+#include <Telemetry.h>
+#include <Metrics.h>
+
+#include "EnergyHistory.h"
+#include "ModeController.h"
 
 struct DateTime
 {
@@ -22,6 +27,17 @@ struct DateTime
     byte second;
 };
 
+#define EXCHANGE_TIMEOUT 1000 // ms for each reply, the Serial timeout of the blocking queries
+
+// inverter exchanges run from handle() while the web server keeps serving
+typedef enum
+{
+    NoExchange = 0,
+    ParamsExchange = 1,
+    WorkTypeExchange = 2,
+    DayEnergyExchange = 3
+} Exchange;
+
 typedef enum
 {
     None = 0,
@@ -32,13 +48,6 @@ typedef enum
     QED = 32
 } Operation;
 
-typedef enum
-{
-    Unknown = 0,
-    sbu = 1,
-    sub = 2
-} WorkType;
-
 class ESBDriver
 {
 private:
@@ -60,6 +69,18 @@ private:
     bool otaEnabled = false;
     byte operationQueue = Operation::None;
     WorkType workType = WorkType::Unknown;
+    EnergyHistory history;
+    ModeController modeController;
+    TelemetryPublisher telemetry;
+    String params;
+    unsigned long paramsTime = 0;
+    Exchange exchange = Exchange::NoExchange;
+    byte exchangeStep = 0;
+    unsigned long exchangeAt = 0;
+    String reply;
+    WorkType pendingWorkType = WorkType::Unknown;
+    bool isDayEnergyDue = false;
+    String dayEnergyDate;
 
     void onWifiDisconnect(const WiFiEventStationModeDisconnected &event);
     void onWifiConnected(const WiFiEventStationModeConnected &event);
@@ -81,10 +102,28 @@ private:
     void handleSBU();
     void handleSUB();
     void handleWorkType();
+    void handleHistory();
+    void handleHistoryDays();
+    void handleMode();
     void sendHelloCommands();
-    void setWorkType();
+    void startExchange(Exchange exchange);
+    void sendExchangeStep();
+    void handleExchange();
+    void nextExchangeStep(bool isAnswered);
+    void waitExchange();
+    void onParams(bool isAnswered);
+    void onWorkType(bool isAck);
+    void onDayEnergy(bool isAnswered);
+    String sendQuery(String query);
+    void writeQuery(String &query);
+    uint16_t getCRC(String &query);
+    String formatDate(DateTime date, byte lenght);
+    void sampleParams();
+    bool isTimeSet();
+    bool sendWorkType(WorkType workType);
+    void writeWorkType(WorkType workType);
     DateTime getDate();
-    void write(byte *buf, byte lenght);
+    void write(const byte *buf, byte lenght);
 
 public:
     ESBDriver(IPAddress &ip, const char *ssid, const char *pwd);
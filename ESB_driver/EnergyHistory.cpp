@@ -0,0 +1,135 @@
+#include "EnergyHistory.h"
+
+void EnergyHistory::begin()
+{
+    if (LittleFS.begin())
+    {
+        this->load();
+    }
+}
+
+void EnergyHistory::load()
+{
+    File file = LittleFS.open(HISTORY_FILE, "r");
+    if (!file)
+    {
+        return;
+    }
+
+    uint32_t magic = 0;
+    if (file.read((uint8_t *)&magic, sizeof(magic)) == sizeof(magic) && magic == HISTORY_MAGIC)
+    {
+        this->params.read(file);
+        this->days.read(file);
+    }
+
+    file.close();
+}
+
+void EnergyHistory::flush()
+{
+    if (!this->isDirty)
+    {
+        return;
+    }
+
+    File file = LittleFS.open(HISTORY_FILE, "w");
+    if (!file)
+    {
+        return;
+    }
+
+    uint32_t magic = HISTORY_MAGIC;
+    file.write((uint8_t *)&magic, sizeof(magic));
+    if (this->params.write(file) && this->days.write(file))
+    {
+        this->isDirty = false;
+    }
+
+    file.close();
+}
+
+void EnergyHistory::addParams(uint32_t time, String &qpigs)
+{
+    if (qpigs.length() < 102)
+    {
+        return;
+    }
+
+    ParamsSample sample;
+    sample.time = time;
+    sample.activePower = qpigs.substring(27, 31).toInt();
+    sample.load = qpigs.substring(32, 35).toInt();
+    sample.batteryVoltage = (uint16_t)(qpigs.substring(40, 45).toFloat() * 100 + 0.5);
+    sample.soc = qpigs.substring(50, 53).toInt();
+    sample.pvVoltage = (uint16_t)(qpigs.substring(64, 69).toFloat() * 10 + 0.5);
+    sample.pvPower = qpigs.substring(97, 102).toInt();
+    sample.reserved = 0;
+
+    this->params.add(sample);
+    this->isDirty = true;
+}
+
+void EnergyHistory::setDayEnergy(uint32_t date, uint32_t energy)
+{
+    if (this->days.size() > 0 && this->days.last().date == date)
+    {
+        if (this->days.last().energy != energy)
+        {
+            this->days.last().energy = energy;
+            this->isDirty = true;
+        }
+
+        return;
+    }
+
+    DaySample sample;
+    sample.date = date;
+    sample.energy = energy;
+
+    this->days.add(sample);
+    this->isDirty = true;
+}
+
+uint16_t EnergyHistory::paramsCount()
+{
+    return this->params.size();
+}
+
+ParamsSample &EnergyHistory::getParams(uint16_t i)
+{
+    return this->params.at(i);
+}
+
+uint16_t EnergyHistory::daysCount()
+{
+    return this->days.size();
+}
+
+DaySample &EnergyHistory::getDay(uint16_t i)
+{
+    return this->days.at(i);
+}
+
+String EnergyHistory::toCsv(ParamsSample &sample)
+{
+    char buf[64];
+    sprintf(buf, "%lu,%u.%u,%u,%u,%u.%02u,%u,%u\n",
+            (unsigned long)sample.time,
+            sample.pvVoltage / 10,
+            sample.pvVoltage % 10,
+            sample.pvPower,
+            sample.activePower,
+            sample.batteryVoltage / 100,
+            sample.batteryVoltage % 100,
+            sample.soc,
+            sample.load);
+    return String(buf);
+}
+
+String EnergyHistory::toCsv(DaySample &sample)
+{
+    char buf[24];
+    sprintf(buf, "%lu,%lu\n", (unsigned long)sample.date, (unsigned long)sample.energy);
+    return String(buf);
+}
@@ -0,0 +1,111 @@
+#ifndef ENERGYHISTORY_H
+#define ENERGYHISTORY_H
+
+#include <Arduino.h>
+#include <LittleFS.h>
+
+#define PARAMS_HISTORY_SIZE 288 // 24h of 5 minute samples
+#define DAYS_HISTORY_SIZE 62
+#define HISTORY_FILE "/history.bin"
+#define HISTORY_MAGIC 0x48425345UL // "ESBH"
+
+// Binary responses are arrays of these structs (little endian, 16 and 8 bytes).
+struct ParamsSample
+{
+    uint32_t time;           // epoch
+    uint16_t pvVoltage;      // 0.1 V
+    uint16_t pvPower;        // W
+    uint16_t activePower;    // W
+    uint16_t batteryVoltage; // 0.01 V
+    uint8_t soc;             // %
+    uint8_t load;            // %
+    uint16_t reserved;
+};
+
+struct DaySample
+{
+    uint32_t date;   // yyyymmdd
+    uint32_t energy; // Wh
+};
+
+template <typename T, uint16_t N>
+class HistoryRing
+{
+private:
+    T items[N];
+    uint16_t head = 0;
+    uint16_t count = 0;
+
+public:
+    void add(const T &item)
+    {
+        this->items[this->head] = item;
+        this->head = (this->head + 1) % N;
+        if (this->count < N)
+        {
+            this->count++;
+        }
+    }
+
+    // 0 is the oldest item
+    T &at(uint16_t i)
+    {
+        return this->items[(this->head + N - this->count + i) % N];
+    }
+
+    T &last()
+    {
+        return this->at(this->count - 1);
+    }
+
+    uint16_t size()
+    {
+        return this->count;
+    }
+
+    bool write(File &file)
+    {
+        return file.write((uint8_t *)&this->head, sizeof(this->head)) == sizeof(this->head) &&
+               file.write((uint8_t *)&this->count, sizeof(this->count)) == sizeof(this->count) &&
+               file.write((uint8_t *)this->items, sizeof(this->items)) == sizeof(this->items);
+    }
+
+    bool read(File &file)
+    {
+        if (file.read((uint8_t *)&this->head, sizeof(this->head)) != sizeof(this->head) ||
+            file.read((uint8_t *)&this->count, sizeof(this->count)) != sizeof(this->count) ||
+            file.read((uint8_t *)this->items, sizeof(this->items)) != sizeof(this->items) ||
+            this->head >= N || this->count > N)
+        {
+            this->head = 0;
+            this->count = 0;
+            return false;
+        }
+
+        return true;
+    }
+};
+
+class EnergyHistory
+{
+private:
+    HistoryRing<ParamsSample, PARAMS_HISTORY_SIZE> params;
+    HistoryRing<DaySample, DAYS_HISTORY_SIZE> days;
+    bool isDirty = false;
+
+    void load();
+
+public:
+    void begin();
+    void addParams(uint32_t time, String &qpigs);
+    void setDayEnergy(uint32_t date, uint32_t energy);
+    void flush();
+    uint16_t paramsCount();
+    ParamsSample &getParams(uint16_t i);
+    uint16_t daysCount();
+    DaySample &getDay(uint16_t i);
+    static String toCsv(ParamsSample &sample);
+    static String toCsv(DaySample &sample);
+};
+
+#endif
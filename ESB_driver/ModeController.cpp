@@ -0,0 +1,145 @@
+#include "ModeController.h"
+
+void ModeController::begin()
+{
+    File cfg = LittleFS.open(MODE_CONFIG_FILE, "r");
+    if (!cfg)
+    {
+        return;
+    }
+
+    DynamicJsonDocument doc(256);
+    if (!deserializeJson(doc, cfg))
+    {
+        JsonObject obj = doc.as<JsonObject>();
+        this->config.enabled = obj["enabled"] | this->config.enabled;
+        this->config.sbuPvVoltage = obj["sbuPvVoltage"] | this->config.sbuPvVoltage;
+        this->config.subPvVoltage = obj["subPvVoltage"] | this->config.subPvVoltage;
+        this->config.sbuSoc = obj["sbuSoc"] | this->config.sbuSoc;
+        this->config.subSoc = obj["subSoc"] | this->config.subSoc;
+        this->config.minDwell = obj["minDwell"] | this->config.minDwell;
+    }
+
+    cfg.close();
+}
+
+void ModeController::saveConfig()
+{
+    File cfg = LittleFS.open(MODE_CONFIG_FILE, "w");
+    if (!cfg)
+    {
+        return;
+    }
+
+    DynamicJsonDocument doc(256);
+    JsonObject obj = doc.to<JsonObject>();
+    obj["enabled"] = this->config.enabled;
+    obj["sbuPvVoltage"] = this->config.sbuPvVoltage;
+    obj["subPvVoltage"] = this->config.subPvVoltage;
+    obj["sbuSoc"] = this->config.sbuSoc;
+    obj["subSoc"] = this->config.subSoc;
+    obj["minDwell"] = this->config.minDwell;
+    serializeJson(doc, cfg);
+    cfg.close();
+}
+
+ModeConfig &ModeController::getConfig()
+{
+    return this->config;
+}
+
+WorkType ModeController::update(String &qpigs, unsigned long now)
+{
+    if (qpigs.length() < 69)
+    {
+        return WorkType::Unknown;
+    }
+
+    this->soc.add(qpigs.substring(50, 53).toInt());
+    this->pvVoltage.add((uint16_t)(qpigs.substring(64, 69).toFloat() * 10 + 0.5));
+
+    if (!this->config.enabled || !this->pvVoltage.isFull())
+    {
+        return WorkType::Unknown;
+    }
+
+    if (this->hasAttempt && now - this->attemptAt < this->config.minDwell * 60000UL)
+    {
+        return WorkType::Unknown;
+    }
+
+    uint16_t pv = this->pvVoltage.get();
+    uint16_t soc = this->soc.get();
+    WorkType decision = WorkType::Unknown;
+
+    if (this->workType != WorkType::sub && (pv < this->config.subPvVoltage || soc < this->config.subSoc))
+    {
+        decision = WorkType::sub;
+    }
+    else if (this->workType != WorkType::sbu && pv >= this->config.sbuPvVoltage && soc >= this->config.sbuSoc)
+    {
+        decision = WorkType::sbu;
+    }
+
+    if (decision != WorkType::Unknown)
+    {
+        this->hasAttempt = true;
+        this->attemptAt = now;
+    }
+
+    return decision;
+}
+
+void ModeController::setWorkType(WorkType workType, uint32_t time, unsigned long now)
+{
+    this->workType = workType;
+    this->hasAttempt = true;
+    this->attemptAt = now;
+
+    ModeDecision &decision = this->decisions[this->decisionsHead];
+    decision.time = time;
+    decision.workType = workType;
+    decision.pvVoltage = this->pvVoltage.get();
+    decision.soc = this->soc.get();
+
+    this->decisionsHead = (this->decisionsHead + 1) % MODE_LOG_SIZE;
+    if (this->decisionsCount < MODE_LOG_SIZE)
+    {
+        this->decisionsCount++;
+    }
+}
+
+String ModeController::getLog()
+{
+    char buf[48];
+    String result = "time,workType,pvVoltage,soc\n";
+
+    for (byte i = 0; i < this->decisionsCount; i++)
+    {
+        ModeDecision &decision = this->decisions[(this->decisionsHead + MODE_LOG_SIZE - this->decisionsCount + i) % MODE_LOG_SIZE];
+        sprintf(buf, "%lu,%s,%u.%u,%u\n",
+                (unsigned long)decision.time,
+                ModeController::toString(decision.workType),
+                decision.pvVoltage / 10,
+                decision.pvVoltage % 10,
+                decision.soc);
+        result += buf;
+    }
+
+    return result;
+}
+
+const char *ModeController::toString(WorkType workType)
+{
+    switch (workType)
+    {
+    case WorkType::sbu:
+        return "sbu";
+
+    case WorkType::sub:
+        return "sub";
+
+    default:
+        return "unknown";
+    }
+}
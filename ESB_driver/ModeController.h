@@ -0,0 +1,100 @@
+#ifndef MODECONTROLLER_H
+#define MODECONTROLLER_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <LittleFS.h>
+
+#define MODE_CONFIG_FILE "/mode.json"
+#define MODE_FILTER_SIZE 30 // samples, one every 10 s
+#define MODE_LOG_SIZE 16
+#define MODE_MAX_DWELL 1440 // minutes
+
+typedef enum
+{
+    Unknown = 0,
+    sbu = 1,
+    sub = 2
+} WorkType;
+
+struct ModeConfig
+{
+    bool enabled = false;
+    uint16_t sbuPvVoltage = 2600; // 0.1 V, switch to SBU at or above
+    uint16_t subPvVoltage = 2400; // 0.1 V, switch to SUB below
+    uint8_t sbuSoc = 75;
+    uint8_t subSoc = 65;
+    uint16_t minDwell = 15; // minutes
+};
+
+struct ModeDecision
+{
+    uint32_t time;
+    WorkType workType;
+    uint16_t pvVoltage;
+    uint8_t soc;
+};
+
+template <uint8_t N>
+class MovingAverage
+{
+private:
+    uint16_t values[N];
+    uint8_t index = 0;
+    uint8_t count = 0;
+    uint32_t sum = 0;
+
+public:
+    void add(uint16_t value)
+    {
+        if (this->count == N)
+        {
+            this->sum -= this->values[this->index];
+        }
+        else
+        {
+            this->count++;
+        }
+
+        this->values[this->index] = value;
+        this->sum += value;
+        this->index = (this->index + 1) % N;
+    }
+
+    uint16_t get()
+    {
+        return this->count > 0 ? this->sum / this->count : 0;
+    }
+
+    bool isFull()
+    {
+        return this->count == N;
+    }
+};
+
+class ModeController
+{
+private:
+    ModeConfig config;
+    MovingAverage<MODE_FILTER_SIZE> pvVoltage;
+    MovingAverage<MODE_FILTER_SIZE> soc;
+    WorkType workType = WorkType::Unknown;
+    bool hasAttempt = false;
+    unsigned long attemptAt = 0;
+    ModeDecision decisions[MODE_LOG_SIZE];
+    byte decisionsHead = 0;
+    byte decisionsCount = 0;
+
+public:
+    void begin();
+    // a returned work type is an attempt to switch, whether the inverter acknowledges it or
+    // not the next one comes minDwell later
+    WorkType update(String &qpigs, unsigned long now);
+    void setWorkType(WorkType workType, uint32_t time, unsigned long now);
+    ModeConfig &getConfig();
+    void saveConfig();
+    String getLog();
+    static const char *toString(WorkType workType);
+};
+
+#endif
@@ -3,7 +3,8 @@
 LightDriver::LightDriver(Logger *logger, TimeService *timeService) : 
                             ledHandler(5),
                             server(80),
-                            timer(std::bind(&LightDriver::handleTimedEvents, this), 1000 * 60)
+                            timer(std::bind(&LightDriver::handleTimedEvents, this), 1000 * 60),
+                            logStream(logger, "/log/stream")
 {
     this->logger = logger;
     this->timeService = timeService;
@@ -13,6 +14,7 @@ void LightDriver::handle()
 {
     this->ledHandler.handle();
     this->timer.update();
+    this->logStream.handle();
 }
 
 void LightDriver::setup()
@@ -21,7 +23,10 @@ void LightDriver::setup()
     this->ledHandler.setValue(5);
     
     this->server.on("/", std::bind(&LightDriver::handleRoot, this, std::placeholders::_1));
+    this->server.on("/log/live", std::bind(&LightDriver::handleLiveLog, this, std::placeholders::_1));
+    this->logStream.setup(&this->server);
     this->server.on("/log", std::bind(&LightDriver::handleLog, this, std::placeholders::_1));
+    METRICS_SETUP(&this->server);
     this->server.onNotFound(std::bind(&LightDriver::handleNotFound, this, std::placeholders::_1));
 
     AsyncCallbackJsonWebHandler* onOffhandler = new AsyncCallbackJsonWebHandler("/onoff", std::bind(&LightDriver::handleOnOff, this, std::placeholders::_1, std::placeholders::_2));
@@ -65,8 +70,14 @@ void LightDriver::handleLog(AsyncWebServerRequest *request)
     this->sendResponse(request, this->logger->getLog());
 }
 
+void LightDriver::handleLiveLog(AsyncWebServerRequest *request)
+{
+    this->sendResponse(request, LogStream::getPage("/log/stream"));
+}
+
 void LightDriver::handleOnOff(AsyncWebServerRequest *request, JsonVariant &json)
 {
+    METRICS_HANDLER("onoff");
     const JsonObject& jsonObj = json.as<JsonObject>();
     bool value = jsonObj["value"];
     if(value)
@@ -83,6 +94,7 @@ void LightDriver::handleOnOff(AsyncWebServerRequest *request, JsonVariant &json)
 
 void LightDriver::handleChangeBrightness(AsyncWebServerRequest *request, JsonVariant &json)
 {
+    METRICS_HANDLER("brightness");
     const JsonObject& jsonObj = json.as<JsonObject>();
     int value = jsonObj["value"];
     this->ledHandler.setMaxValue(value);
@@ -104,6 +116,7 @@ void LightDriver::handleChangeBrightness(AsyncWebServerRequest *request, JsonVar
 
 void LightDriver::handleRoot(AsyncWebServerRequest *request)
 {
+    METRICS_HANDLER("root");
     String src = htmlsrc1;
 
     src += this->generateLedHtml();
@@ -143,6 +156,7 @@ void LightDriver::setDisconnected()
 
 void LightDriver::handleTimedEvents()
 {
+    METRICS_SCOPE("timedEvents");
     tm *tm;
     tm = this->timeService->now();
     this->logger->println("");
@@ -7,6 +7,7 @@
 
 #include <TimeService.h>
 #include <Logger.h>
+#include <Metrics.h>
 
 #include "LightDriver.h"
 
@@ -27,5 +28,6 @@ void setup() {
 }
 
 void loop() {
+  METRICS_LOOP();
   wifiHandler.handle();
 }
\ No newline at end of file
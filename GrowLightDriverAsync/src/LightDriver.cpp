@@ -3,7 +3,8 @@
 LightDriver::LightDriver(Logger *logger, TimeService *timeService) : 
                             ledHandler(5),
                             server(80),
-                            timer(std::bind(&LightDriver::handleTimedEvents, this), 1000 * 60)
+                            timer(std::bind(&LightDriver::handleTimedEvents, this), 1000 * 60),
+                            logStream(logger, "/log/stream")
 {
     this->logger = logger;
     this->timeService = timeService;
@@ -13,6 +14,7 @@ void LightDriver::handle()
 {
     this->ledHandler.handle();
     this->timer.update();
+    this->logStream.handle();
 }
 
 void LightDriver::setup()
@@ -21,6 +23,8 @@ void LightDriver::setup()
     this->ledHandler.setValue(5);
     
     this->server.on("/", std::bind(&LightDriver::handleRoot, this, std::placeholders::_1));
+    this->server.on("/log/live", std::bind(&LightDriver::handleLiveLog, this, std::placeholders::_1));
+    this->logStream.setup(&this->server);
     this->server.on("/log", std::bind(&LightDriver::handleLog, this, std::placeholders::_1));
     this->server.onNotFound(std::bind(&LightDriver::handleNotFound, this, std::placeholders::_1));
 
@@ -65,6 +69,11 @@ void LightDriver::handleLog(AsyncWebServerRequest *request)
     this->sendResponse(request, this->logger->getLog());
 }
 
+void LightDriver::handleLiveLog(AsyncWebServerRequest *request)
+{
+    this->sendResponse(request, LogStream::getPage("/log/stream"));
+}
+
 void LightDriver::handleOnOff(AsyncWebServerRequest *request, JsonVariant &json)
 {
     const JsonObject& jsonObj = json.as<JsonObject>();
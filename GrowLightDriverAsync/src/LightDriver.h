@@ -10,6 +10,7 @@
 #include <Logger.h>
 #include <LedHandler.h>
 #include <WiFiHandler.h>
+#include <LogStream.h>
 
 #include "htmlSrc.h"
 
@@ -21,9 +22,11 @@ class LightDriver : public IDriver {
         TimeService *timeService;
         TickTwo timer;
         Logger *logger;
+        LogStream logStream;
 
         void handleNotFound(AsyncWebServerRequest *request);
         void handleLog(AsyncWebServerRequest *request);
+        void handleLiveLog(AsyncWebServerRequest *request);
         void handleOnOff(AsyncWebServerRequest *request, JsonVariant &json);
         void handleChangeBrightness(AsyncWebServerRequest *request, JsonVariant &json);
         void handleRoot(AsyncWebServerRequest *request);
@@ -1,36 +1,35 @@
+#include <Sonar.h>
+
 #define TrigPin 3
-#define EchoPin 2
+#define EchoPin 2 // INT0
+#define PingPeriod 60    // ms
+#define ReportPeriod 500 // ms
 
-int distance;
-long duration = 0;
+Sonar sonar(TrigPin, EchoPin, PingPeriod, 2, 200);
+unsigned long reportAt = 0;
 
 void setup() {
   // put your setup code here, to run once:
   Serial.begin(115200);
-  pinMode(TrigPin, OUTPUT);
-  pinMode(EchoPin, INPUT);
+  sonar.begin();
 }
 
 void loop() {
-  digitalWrite(TrigPin, HIGH);
-  delayMicroseconds(10);
-  digitalWrite(TrigPin, LOW);
-
-  duration = pulseIn(EchoPin, HIGH);
+  sonar.handle();
 
-  distance = duration/58;
+  if (millis() - reportAt < ReportPeriod) {
+    return;
+  }
+  reportAt = millis();
 
-  Serial.println(distance);
-  if(distance < 2 || distance > 200)
+  if (!sonar.isValid())
   {
-    Serial.println("---- out of range");  
+    Serial.println("---- out of range");
   }
   else
   {
-    Serial.print("Distance: ");
-    Serial.print(distance);
-    Serial.println(" cm");
+    char line[24];
+    snprintf(line, sizeof(line), "Distance: %u cm", sonar.getDistance());
+    Serial.println(line);
   }
-
-  delay(500);
 }
@@ -0,0 +1,573 @@
+#include "LightsDriver.h"
+
+LightsDriver::LightsDriver(Logger *logger,
+                           TimeService *timeService,
+                           const int leds[],
+                           byte ledsCount,
+                           const int detectors[],
+                           byte detectorsCount,
+                           String *names,
+                           const char *instanceName) :
+                            server(80),
+                            motion(detectors, detectorsCount),
+                            logStream(logger, "/log/stream")
+{
+    this->logger = logger;
+    this->timeService = timeService;
+    this->lightsCount = ledsCount > MAX_LIGHTS ? MAX_LIGHTS : ledsCount;
+    this->names = names;
+    this->instanceName = instanceName;
+
+    // 15 per 100 ms tick, a full range fade takes 1.7 s
+    for(byte i = 0; i < this->lightsCount; i++)
+    {
+        this->lights[i] = new LedHandler(leds[i], 15);
+    }
+}
+
+void LightsDriver::handle()
+{
+    for(byte i = 0; i < this->lightsCount; i++)
+    {
+        this->lights[i]->handle();
+    }
+
+    if(this->motion.handle())
+    {
+        this->serveAuto();
+    }
+    this->serveHoldTimers();
+    this->logStream.handle();
+
+    if(this->otaEnabled)
+    {
+        ArduinoOTA.handle();
+    }
+
+    // restarting from the request callback would drop the response
+    if(this->resetAt > 0 && millis() > this->resetAt)
+    {
+        ESP.reset();
+    }
+}
+
+void LightsDriver::setup()
+{
+    for(byte i = 0; i < this->lightsCount; i++)
+    {
+        this->lights[i]->setup();
+    }
+
+    this->loadConfiguration();
+
+    // preflights first, /ota and /reset take any method and must not act on one
+    const char *corsPaths[] = {"/onoff", "/brightness", "/save", "/auto", "/led", "/ota", "/reset", "/conf"};
+    for(const char *path : corsPaths)
+    {
+        this->server.on(path, HTTP_OPTIONS, std::bind(&LightsDriver::handleOptions, this, std::placeholders::_1));
+    }
+
+    this->server.on("/", std::bind(&LightsDriver::handleRoot, this, std::placeholders::_1));
+    this->server.on("/led", HTTP_POST, std::bind(&LightsDriver::handleLed, this, std::placeholders::_1));
+    this->server.on("/ota", std::bind(&LightsDriver::handleOTA, this, std::placeholders::_1));
+    this->server.on("/reset", std::bind(&LightsDriver::handleReset, this, std::placeholders::_1));
+    this->server.on("/conf", std::bind(&LightsDriver::handleConf, this, std::placeholders::_1));
+    this->server.on("/log/live", std::bind(&LightsDriver::handleLiveLog, this, std::placeholders::_1));
+    this->logStream.setup(&this->server);
+    this->server.on("/log", std::bind(&LightsDriver::handleLog, this, std::placeholders::_1));
+    METRICS_SETUP(&this->server);
+
+    AsyncCallbackJsonWebHandler* onOffHandler = new AsyncCallbackJsonWebHandler("/onoff", std::bind(&LightsDriver::handleOnOff, this, std::placeholders::_1, std::placeholders::_2));
+    AsyncCallbackJsonWebHandler* brightnessHandler = new AsyncCallbackJsonWebHandler("/brightness", std::bind(&LightsDriver::handleBrightness, this, std::placeholders::_1, std::placeholders::_2));
+    AsyncCallbackJsonWebHandler* saveHandler = new AsyncCallbackJsonWebHandler("/save", std::bind(&LightsDriver::handleSave, this, std::placeholders::_1, std::placeholders::_2));
+    AsyncCallbackJsonWebHandler* autoHandler = new AsyncCallbackJsonWebHandler("/auto", std::bind(&LightsDriver::handleAuto, this, std::placeholders::_1, std::placeholders::_2));
+
+    this->server.addHandler(onOffHandler);
+    this->server.addHandler(brightnessHandler);
+    this->server.addHandler(saveHandler);
+    this->server.addHandler(autoHandler);
+    this->server.onNotFound(std::bind(&LightsDriver::handleNotFound, this, std::placeholders::_1));
+
+    this->server.begin();
+    this->setupOTA();
+    this->motion.setup();
+
+    this->logger->println("Server started");
+    for(byte i = 0; i < this->lightsCount; i++)
+    {
+        this->logger->println("Light " + String(i + 1) + ": " + this->names[i]);
+    }
+}
+
+void LightsDriver::setupOTA()
+{
+    ArduinoOTA.setHostname(this->instanceName);
+
+    Logger *logger = this->logger;
+    ArduinoOTA.onStart([logger]() {
+        logger->println("Update started");
+    });
+    ArduinoOTA.onEnd([logger]() {
+        logger->println("Update finished");
+    });
+    ArduinoOTA.onError([logger](ota_error_t error) {
+        logger->println("Update error " + String(error));
+    });
+    ArduinoOTA.begin();
+}
+
+void LightsDriver::loadConfiguration()
+{
+    if(!LittleFS.begin())
+    {
+        this->logger->println("Cannot mount filesystem");
+        return;
+    }
+
+    File cfg = LittleFS.open("/vals.json", "r");
+    if(cfg)
+    {
+        DynamicJsonDocument doc(200);
+        deserializeJson(doc, cfg);
+        JsonArray arr = doc.as<JsonArray>();
+        for(byte i = 0; i < this->lightsCount && i < arr.size(); i++)
+        {
+            // setMaxValue also lights the led, the lights start off
+            this->lights[i]->setMaxValue(arr[i].as<int>());
+            this->lights[i]->turnOff();
+        }
+        cfg.close();
+    }
+
+    cfg = LittleFS.open("/autoState.json", "r");
+    if(cfg)
+    {
+        DynamicJsonDocument doc(200);
+        deserializeJson(doc, cfg);
+        JsonArray arr = doc.as<JsonArray>();
+        for(byte i = 0; i < this->lightsCount && i < arr.size(); i++)
+        {
+            this->autoState[i] = arr[i].as<int>() > 0;
+        }
+        cfg.close();
+    }
+
+    cfg = LittleFS.open("/time.json", "r");
+    if(cfg)
+    {
+        DynamicJsonDocument doc(200);
+        deserializeJson(doc, cfg);
+        JsonArray arr = doc.as<JsonArray>();
+        this->from = arr[0].as<int>();
+        this->to = arr[1].as<int>();
+        cfg.close();
+    }
+
+    LittleFS.end();
+    this->logger->println("Configuration loaded");
+}
+
+bool LightsDriver::saveAuto()
+{
+    if(!LittleFS.begin())
+    {
+        return false;
+    }
+
+    bool isSaved = false;
+    File cfg = LittleFS.open("/autoState.json", "w");
+    if(cfg)
+    {
+        DynamicJsonDocument doc(200);
+        JsonArray arr = doc.to<JsonArray>();
+        for(byte i = 0; i < this->lightsCount; i++)
+        {
+            arr.add(this->autoState[i] ? 1 : 0);
+        }
+        serializeJson(doc, cfg);
+        cfg.close();
+        isSaved = true;
+    }
+
+    LittleFS.end();
+    return isSaved;
+}
+
+bool LightsDriver::saveSettings()
+{
+    if(!LittleFS.begin())
+    {
+        return false;
+    }
+
+    File cfg = LittleFS.open("/time.json", "w");
+    if(cfg)
+    {
+        DynamicJsonDocument doc(200);
+        JsonArray arr = doc.to<JsonArray>();
+        arr.add(this->from);
+        arr.add(this->to);
+        serializeJson(doc, cfg);
+        cfg.close();
+    }
+
+    bool isSaved = false;
+    cfg = LittleFS.open("/vals.json", "w");
+    if(cfg)
+    {
+        DynamicJsonDocument doc(200);
+        JsonArray arr = doc.to<JsonArray>();
+        for(byte i = 0; i < this->lightsCount; i++)
+        {
+            arr.add(this->lights[i]->getMaxValue());
+        }
+        serializeJson(doc, cfg);
+        cfg.close();
+        isSaved = true;
+    }
+
+    LittleFS.end();
+    return isSaved;
+}
+
+void LightsDriver::sendResponse(AsyncWebServerRequest *request, int code, String contentType, String msg)
+{
+    AsyncWebServerResponse *response = request->beginResponse(code, contentType, msg);
+    response->addHeader("Access-Control-Allow-Origin", "*");
+    response->addHeader("Access-Control-Allow-Methods", "DELETE, POST, GET, OPTIONS");
+    response->addHeader("Access-Control-Allow-Headers", "Content-Type, Authorization, X-Requested-With");
+    request->send(response);
+}
+
+// forms posted from the page itself ask to be sent back to it
+void LightsDriver::sendDone(AsyncWebServerRequest *request)
+{
+    if(request->hasArg("local"))
+    {
+        AsyncWebServerResponse *response = request->beginResponse(303);
+        response->addHeader("Location", "/");
+        response->addHeader("Access-Control-Allow-Origin", "*");
+        request->send(response);
+        return;
+    }
+
+    this->sendResponse(request, 200);
+}
+
+bool LightsDriver::isValidId(int id)
+{
+    return id >= 1 && id <= this->lightsCount;
+}
+
+void LightsDriver::handleNotFound(AsyncWebServerRequest *request)
+{
+    String message = "File Not Found\n\nURI: ";
+    message += request->url();
+    message += "\nMethod: ";
+    message += request->methodToString();
+    message += "\n";
+
+    this->sendResponse(request, 404, "text/plain", message);
+}
+
+void LightsDriver::handleOptions(AsyncWebServerRequest *request)
+{
+    this->sendResponse(request, 200);
+}
+
+void LightsDriver::handleLog(AsyncWebServerRequest *request)
+{
+    this->sendResponse(request, 200, "text/html", this->logger->getLog());
+}
+
+void LightsDriver::handleLiveLog(AsyncWebServerRequest *request)
+{
+    this->sendResponse(request, 200, "text/html", LogStream::getPage("/log/stream"));
+}
+
+void LightsDriver::handleRoot(AsyncWebServerRequest *request)
+{
+    METRICS_HANDLER("root");
+    String src = htmlsrc1;
+
+    for(byte i = 0; i < this->lightsCount; i++)
+    {
+        src += this->generateLedHtml(i);
+    }
+
+    src += "<section class=\"settings\">";
+    src += "    <span class=\"label\">Auto off time: </span><input class=\"number\" type=\"number\" min=\"0\" max=\"23\" value=\"";
+    src += String(this->from);
+    src += "\" id=\"from\"><span class=\"label\"> - </span> <input class=\"number\" type=\"number\" min=\"0\" max=\"23\" value=\"";
+    src += String(this->to);
+    src += "\" id=\"to\">";
+
+    src += htmlsrc2;
+
+    this->sendResponse(request, 200, "text/html", src);
+}
+
+String LightsDriver::generateLedHtml(int n)
+{
+    bool isOn = this->lights[n]->isOn();
+    String src = "<h1>";
+    src += this->names[n];
+    src += "</h1><input class=\"btn\" type=\"button\" value=\"";
+    src += (!isOn ? "on" : "off");
+    src += "\" onclick=\"turnOnOff(";
+    src += String(n + 1);
+    src += ", ";
+    src += (!isOn ? "1" : "0");
+    src += ")\"><input class=\"range\" type=\"range\" value=\"";
+    src += String(this->lights[n]->getMaxValue());
+    src += "\" min=\"0\" max=\"255\" oninput=\"changeBrightness(";
+    src += String(n + 1);
+    src += ", this.value)\">";
+
+    src += "<input class=\"checkbox\" type=\"checkbox\" oninput=\"changeAuto(";
+    src += String(n + 1);
+    src += ")\" id=\"c";
+    src += String(n + 1);
+    src += "\" ";
+    src += (this->autoState[n] ? "checked" : "");
+    src += "><label for=\"c";
+    src += String(n + 1);
+    src += "\" class=\"label\">Auto</label>";
+
+    return src;
+}
+
+void LightsDriver::handleLed(AsyncWebServerRequest *request)
+{
+    METRICS_HANDLER("led");
+    if(!request->hasArg("id") || !request->hasArg("val"))
+    {
+        this->sendResponse(request, 400, "text/plain", "400: Invalid request");
+        return;
+    }
+
+    int id = request->arg("id").toInt();
+    int val = request->arg("val").toInt();
+    if(!this->isValidId(id))
+    {
+        this->sendResponse(request, 400, "text/plain", "400: Invalid id");
+        return;
+    }
+
+    this->lights[id - 1]->setMaxValue(val);
+    this->releaseAuto(id - 1);
+    this->logger->println("led " + String(id) + " value: " + String(val));
+
+    this->sendDone(request);
+}
+
+void LightsDriver::handleOnOff(AsyncWebServerRequest *request, JsonVariant &json)
+{
+    METRICS_HANDLER("onoff");
+    const JsonObject& jsonObj = json.as<JsonObject>();
+    int id = jsonObj["id"];
+    int val = jsonObj["value"];
+    if(!this->isValidId(id))
+    {
+        this->sendResponse(request, 400, "text/plain", "400: Invalid id");
+        return;
+    }
+
+    LedHandler *light = this->lights[id - 1];
+    if(val > 0)
+    {
+        if(light->getMaxValue() == 0)
+        {
+            light->setMaxValue(255);
+        }
+        light->turnOn();
+    }
+    else
+    {
+        light->turnOff();
+    }
+    this->releaseAuto(id - 1);
+
+    this->logger->println("onoff " + String(id) + " value: " + String(val));
+    this->sendDone(request);
+}
+
+void LightsDriver::handleBrightness(AsyncWebServerRequest *request, JsonVariant &json)
+{
+    METRICS_HANDLER("brightness");
+    const JsonObject& jsonObj = json.as<JsonObject>();
+    int id = jsonObj["id"];
+    int val = jsonObj["value"];
+    if(!this->isValidId(id))
+    {
+        this->sendResponse(request, 400, "text/plain", "400: Invalid id");
+        return;
+    }
+
+    this->lights[id - 1]->setMaxValue(val);
+    this->releaseAuto(id - 1);
+    this->logger->println("brightness " + String(id) + " value: " + String(val));
+
+    this->sendDone(request);
+}
+
+void LightsDriver::handleSave(AsyncWebServerRequest *request, JsonVariant &json)
+{
+    METRICS_HANDLER("save");
+    const JsonObject& jsonObj = json.as<JsonObject>();
+    this->from = jsonObj["from"];
+    this->to = jsonObj["to"];
+
+    if(!this->saveSettings())
+    {
+        this->sendResponse(request, 500, "text/plain", "Cannot open file");
+        return;
+    }
+
+    this->sendResponse(request, 200);
+}
+
+void LightsDriver::handleAuto(AsyncWebServerRequest *request, JsonVariant &json)
+{
+    METRICS_HANDLER("auto");
+    const JsonObject& jsonObj = json.as<JsonObject>();
+    int id = jsonObj["id"];
+    int val = jsonObj["value"];
+    if(!this->isValidId(id))
+    {
+        this->sendResponse(request, 400, "text/plain", "400: Invalid id");
+        return;
+    }
+
+    this->autoState[id - 1] = val > 0;
+    if(!this->autoState[id - 1])
+    {
+        this->releaseAuto(id - 1);
+    }
+    if(!this->saveAuto())
+    {
+        this->sendResponse(request, 500, "text/plain", "Cannot open file");
+        return;
+    }
+
+    this->sendDone(request);
+}
+
+void LightsDriver::handleOTA(AsyncWebServerRequest *request)
+{
+    this->otaEnabled = true;
+    this->logger->println("OTA enabled");
+
+    this->sendResponse(request, 200, "text/plain", "OTA enabled");
+}
+
+void LightsDriver::handleReset(AsyncWebServerRequest *request)
+{
+    this->otaEnabled = false;
+    this->resetAt = millis() + 500;
+    this->logger->println("Reset requested");
+
+    this->sendResponse(request, 200, "text/plain", "Resetting");
+}
+
+void LightsDriver::handleConf(AsyncWebServerRequest *request)
+{
+    METRICS_HANDLER("conf");
+    DynamicJsonDocument doc(400);
+    JsonObject obj = doc.to<JsonObject>();
+    String result;
+    obj["from"] = this->from;
+    obj["to"] = this->to;
+    JsonArray arr = doc.createNestedArray("lights");
+    for(byte i = 0; i < this->lightsCount; i++)
+    {
+        obj = arr.createNestedObject();
+        obj["auto"] = this->autoState[i];
+        obj["brightness"] = this->lights[i]->getMaxValue();
+        obj["on"] = this->lights[i]->isOn() ? 1 : 0;
+    }
+
+    serializeJsonPretty(doc, result);
+
+    this->sendResponse(request, 200, "text/plain", result);
+}
+
+void LightsDriver::setConnected()
+{
+    this->isConnected = true;
+}
+
+void LightsDriver::setDisconnected()
+{
+    // without time the auto mode treats the whole day as dark, the lights stay as they are
+    this->isConnected = false;
+}
+
+bool LightsDriver::isDarkTime()
+{
+    if(!this->isConnected)
+    {
+        return true;
+    }
+
+    tm *tm = this->timeService->now();
+    return tm->tm_hour >= this->to || tm->tm_hour <= this->from;
+}
+
+// called on occupancy changes only, lights switched on by motion get their own hold timer
+void LightsDriver::serveAuto()
+{
+    bool isOccupied = this->motion.getOccupied() != 0;
+    bool isDark = isOccupied && this->isDarkTime();
+    unsigned long now = millis();
+
+    for(byte i = 0; i < this->lightsCount; i++)
+    {
+        if(!this->autoState[i])
+        {
+            continue;
+        }
+
+        if(isOccupied)
+        {
+            bitClear(this->holding, i);
+            if(!bitRead(this->autoOn, i) && isDark)
+            {
+                this->logger->println("auto on " + String(i + 1));
+                this->lights[i]->turnOn();
+                bitSet(this->autoOn, i);
+            }
+        }
+        else if(bitRead(this->autoOn, i))
+        {
+            this->holdUntil[i] = now + AUTO_HOLD_TIME;
+            bitSet(this->holding, i);
+        }
+    }
+}
+
+void LightsDriver::serveHoldTimers()
+{
+    if(this->holding == 0)
+    {
+        return;
+    }
+
+    unsigned long now = millis();
+    for(byte i = 0; i < this->lightsCount; i++)
+    {
+        if(bitRead(this->holding, i) && (long)(now - this->holdUntil[i]) >= 0)
+        {
+            this->logger->println("auto off " + String(i + 1));
+            this->lights[i]->turnOff();
+            this->releaseAuto(i);
+        }
+    }
+}
+
+// the light is no longer switched by motion, a manual change or auto mode off takes it over
+void LightsDriver::releaseAuto(byte light)
+{
+    bitClear(this->autoOn, light);
+    bitClear(this->holding, light);
+}
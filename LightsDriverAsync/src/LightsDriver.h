@@ -0,0 +1,76 @@
+#pragma once
+
+#include <Arduino.h>
+#include <AsyncJson.h>
+#include <ArduinoJson.h>
+#include <ArduinoOTA.h>
+#include <ESPAsyncWebServer.h>
+#include <LittleFS.h>
+
+#include <TimeService.h>
+#include <Logger.h>
+#include <LedHandler.h>
+#include <WiFiHandler.h>
+#include <LogStream.h>
+#include <Metrics.h>
+
+#include "MotionDetector.h"
+#include "htmlSrc.h"
+
+#define MAX_LIGHTS 4
+#define AUTO_HOLD_TIME 60000
+
+class LightsDriver : public IDriver {
+    private:
+        LedHandler *lights[MAX_LIGHTS];
+        byte lightsCount;
+        String *names;
+        const char *instanceName;
+        AsyncWebServer server;
+        TimeService *timeService;
+        MotionDetector motion;
+        Logger *logger;
+        LogStream logStream;
+        bool isConnected = false;
+        bool otaEnabled = false;
+        unsigned long resetAt = 0;
+        bool autoState[MAX_LIGHTS] = {false, false, false, false};
+        byte autoOn = 0;
+        byte holding = 0;
+        unsigned long holdUntil[MAX_LIGHTS];
+        int from = 7;
+        int to = 15;
+
+        void handleNotFound(AsyncWebServerRequest *request);
+        void handleOptions(AsyncWebServerRequest *request);
+        void handleLog(AsyncWebServerRequest *request);
+        void handleLiveLog(AsyncWebServerRequest *request);
+        void handleRoot(AsyncWebServerRequest *request);
+        void handleLed(AsyncWebServerRequest *request);
+        void handleOnOff(AsyncWebServerRequest *request, JsonVariant &json);
+        void handleBrightness(AsyncWebServerRequest *request, JsonVariant &json);
+        void handleSave(AsyncWebServerRequest *request, JsonVariant &json);
+        void handleAuto(AsyncWebServerRequest *request, JsonVariant &json);
+        void handleOTA(AsyncWebServerRequest *request);
+        void handleReset(AsyncWebServerRequest *request);
+        void handleConf(AsyncWebServerRequest *request);
+        void sendResponse(AsyncWebServerRequest *request, int code, String contentType = "text/plain", String msg = "");
+        void sendDone(AsyncWebServerRequest *request);
+        bool isValidId(int id);
+        void serveAuto();
+        void serveHoldTimers();
+        void releaseAuto(byte light);
+        bool isDarkTime();
+        void loadConfiguration();
+        bool saveAuto();
+        bool saveSettings();
+        void setupOTA();
+        String generateLedHtml(int n);
+
+    public:
+        LightsDriver(Logger *logger, TimeService *timeService, const int leds[], byte ledsCount, const int detectors[], byte detectorsCount, String *names, const char *instanceName);
+        void setup();
+        void handle();
+        void setDisconnected();
+        void setConnected();
+};
@@ -0,0 +1,130 @@
+#include "MotionDetector.h"
+
+MotionDetector::MotionDetector(const int pins[], byte count)
+{
+    this->zonesCount = count > MOTION_MAX_ZONES ? MOTION_MAX_ZONES : count;
+    for(byte i = 0; i < this->zonesCount; i++)
+    {
+        this->pins[i].owner = this;
+        this->pins[i].zone = i;
+        this->pins[i].pin = pins[i];
+    }
+}
+
+void MotionDetector::setup()
+{
+    unsigned long now = millis();
+    for(byte i = 0; i < this->zonesCount; i++)
+    {
+        pinMode(this->pins[i].pin, INPUT);
+        attachInterruptArg(digitalPinToInterrupt(this->pins[i].pin), MotionDetector::onEdge, &this->pins[i], CHANGE);
+
+        // a detector already high at boot counts like a rising edge now
+        this->apply(i, digitalRead(this->pins[i].pin), now);
+    }
+}
+
+void IRAM_ATTR MotionDetector::onEdge(void *arg)
+{
+    motionPin *pin = (motionPin *)arg;
+    pin->owner->push(pin->zone, digitalRead(pin->pin), millis());
+}
+
+// GPIO interrupts do not nest, the ISRs of all zones are the only writer of head
+void IRAM_ATTR MotionDetector::push(byte zone, byte level, unsigned long time)
+{
+    byte next = (this->head + 1) % MOTION_QUEUE_SIZE;
+    if(next == this->tail)
+    {
+        this->dropped++;
+        return;
+    }
+
+    this->queue[this->head].zone = zone;
+    this->queue[this->head].level = level;
+    this->queue[this->head].time = time;
+    this->head = next;
+}
+
+bool MotionDetector::handle()
+{
+    if(this->head == this->tail && this->pending == 0 && this->dropped == this->handledDropped)
+    {
+        return false;
+    }
+
+    byte before = this->occupied;
+    while(this->tail != this->head)
+    {
+        motionEdge &edge = this->queue[this->tail];
+        this->apply(edge.zone, edge.level, edge.time);
+        this->tail = (this->tail + 1) % MOTION_QUEUE_SIZE;
+    }
+
+    unsigned long now = millis();
+
+    // edges were lost while the loop was busy, the pins tell the current state
+    if(this->dropped != this->handledDropped)
+    {
+        this->handledDropped = this->dropped;
+        for(byte i = 0; i < this->zonesCount; i++)
+        {
+            this->apply(i, digitalRead(this->pins[i].pin), now);
+        }
+    }
+
+    for(byte i = 0; i < this->zonesCount; i++)
+    {
+        if(bitRead(this->pending, i) && now - this->risenAt[i] >= MOTION_DEBOUNCE)
+        {
+            bitClear(this->pending, i);
+            bitSet(this->occupied, i);
+        }
+    }
+
+    return this->occupied != before;
+}
+
+void MotionDetector::apply(byte zone, byte level, unsigned long time)
+{
+    if(bitRead(this->levels, zone) == (level ? 1 : 0))
+    {
+        return;
+    }
+
+    this->edges++;
+    if(level)
+    {
+        bitSet(this->levels, zone);
+        if(!bitRead(this->occupied, zone))
+        {
+            bitSet(this->pending, zone);
+            this->risenAt[zone] = time;
+        }
+        return;
+    }
+
+    bitClear(this->levels, zone);
+    bitClear(this->pending, zone);
+    bitClear(this->occupied, zone);
+}
+
+byte MotionDetector::getOccupied()
+{
+    return this->occupied;
+}
+
+bool MotionDetector::isOccupied(byte zone)
+{
+    return bitRead(this->occupied, zone);
+}
+
+uint32_t MotionDetector::getEdges()
+{
+    return this->edges;
+}
+
+uint32_t MotionDetector::getDropped()
+{
+    return this->dropped;
+}
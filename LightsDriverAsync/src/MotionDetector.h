@@ -0,0 +1,61 @@
+#pragma once
+
+#include <Arduino.h>
+
+#define MOTION_MAX_ZONES 4
+#define MOTION_QUEUE_SIZE 32
+#define MOTION_DEBOUNCE 20
+
+struct motionEdge
+{
+    byte zone;
+    byte level;
+    unsigned long time;
+};
+
+class MotionDetector;
+
+struct motionPin
+{
+    MotionDetector *owner;
+    byte zone;
+    byte pin;
+};
+
+/*
+Motion detectors on pin-change interrupts, every detector is one zone. The ISR only
+timestamps the edge into a ring written by the interrupt and read by the loop, handle()
+replays the edges and keeps a debounced occupancy state per zone: a zone is occupied once
+its pin stayed high for MOTION_DEBOUNCE ms and vacant on the falling edge, shorter pulses
+are dropped as noise. Nothing is read while the pins are quiet.
+*/
+class MotionDetector
+{
+    private:
+        motionPin pins[MOTION_MAX_ZONES];
+        byte zonesCount;
+        motionEdge queue[MOTION_QUEUE_SIZE];
+        volatile byte head = 0;
+        volatile byte tail = 0;
+        volatile uint32_t dropped = 0;
+        uint32_t handledDropped = 0;
+        uint32_t edges = 0;
+        byte levels = 0;
+        byte pending = 0;
+        byte occupied = 0;
+        unsigned long risenAt[MOTION_MAX_ZONES];
+
+        static void onEdge(void *arg);
+        void push(byte zone, byte level, unsigned long time);
+        void apply(byte zone, byte level, unsigned long time);
+
+    public:
+        MotionDetector(const int pins[], byte count);
+        void setup();
+        // true when a zone became occupied or vacant
+        bool handle();
+        byte getOccupied();
+        bool isOccupied(byte zone);
+        uint32_t getEdges();
+        uint32_t getDropped();
+};
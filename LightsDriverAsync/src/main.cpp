@@ -0,0 +1,54 @@
+#include <DNSServer.h>
+#include <ESP8266WiFi.h>
+#include <ESPAsyncTCP.h>
+#include <WiFiUdp.h>
+#include <ESPAsyncWebServer.h>
+
+#include <TimeService.h>
+#include <Logger.h>
+#include <Metrics.h>
+
+#include "LightsDriver.h"
+
+#include "pwd.h"
+
+#if defined(LIGHTS_KKD)
+IPAddress ip(192, 168, 100, 32);
+const int leds[] = {5, 4, 14, 13};
+const int detectors[] = {12};
+String names[] = {"Oswietlenie gorne", "Oswietlenie szafek", "Oswietlenie blat", "Oswietlenie podloga"};
+const char *instance = "LightsDriverKKD";
+#elif defined(LIGHTS_KG)
+IPAddress ip(192, 168, 100, 34);
+const int leds[] = {5, 4};
+const int detectors[] = {12, 13};
+String names[] = {"Plafon", "Glowne"};
+const char *instance = "LightsDriverKG";
+#else
+IPAddress ip(192, 168, 100, 33);
+const int leds[] = {5, 4};
+const int detectors[] = {12};
+String names[] = {"Plafon", "Glowne"};
+const char *instance = "LightsDriverKD";
+#endif
+
+IPAddress gateway(192, 168, 100, 1);
+
+TimeService timeService;
+Logger logger;
+LightsDriver driver(&logger, &timeService, leds, sizeof(leds) / sizeof(leds[0]), detectors, sizeof(detectors) / sizeof(detectors[0]), names, instance);
+WiFiHandler wifiHandler(&logger, &driver, ssid, password, &ip, &gateway);
+
+void setup() {
+  Serial.begin(115200);
+  
+  wifiHandler.setup();
+
+  timeService.begin();
+  logger.println("Current time: " + timeService.toString());
+}
+
+void loop() {
+  METRICS_LOOP();
+  wifiHandler.handle();
+}
@@ -1,14 +1,22 @@
 #include <EEPROM.h>
+#include <SettingsStore.h>
+#include <LedFader.h>
+#include <SleepService.h>
 
 #define TIME_RESOLUTION 10
 #define AUTO_OFF_MAX_VAL 1 * 60 * (1000 / TIME_RESOLUTION) // 1min
 #define INITIAL_AUTO_OFF_VAL 1 * 59 * (1000 / TIME_RESOLUTION) // 59s
 #define MAX_VAL 255
+#define FADE_TIME 1500     // ms, off to on and back
+#define STEP_FADE_TIME 200 // ms, between two lit levels
+#define INC_DEC_TICKS (100 / TIME_RESOLUTION) // one 5-unit step per 100ms while a button is held
+#define SETTINGS_ADDRESS 16                  // bytes 0-1 held the value before the store
+#define SETTINGS_SLOTS 16
 
 int leds[] = {10};
 byte ledsCount = 1;
+LedFader fader(leds, ledsCount);
 bool ledsOn = true;
-byte currentLedVal = 0;
 byte expectedLedVal = 100;
 
 int detectors[] = {A0, A1};
@@ -22,40 +30,77 @@ unsigned long timeNow = 0;
 int incPin = 7;
 int decPin = 8;
 
+byte incDecCounter = 0;
+SettingsStore settingsStore(SETTINGS_ADDRESS, SETTINGS_SLOTS, 1);
+
 int signalPin = 13;
 int signalVal = 0;
 bool signalState = false;
 
 void setup()
 {
-  if (EEPROM.read(0) != 1)
-  {
-    EEPROM.write(0, 1);
-    EEPROM.write(1, expectedLedVal);
-  }
-  else
-  {
-    expectedLedVal = EEPROM.read(1);
-  }
+  loadSettings();
 
   pinMode(signalPin, OUTPUT);
   pinMode(incPin, INPUT);
   pinMode(decPin, INPUT);
 
-  for (byte i = 0; i < ledsCount; i++)
-  {
-    pinMode(leds[i], OUTPUT);
-  }
+  fader.setup();
 
   for (byte i = 0; i < detectorsCount; i++)
   {
     pinMode(detectors[i], INPUT);
+    SleepService::wakeOnPin(detectors[i]);
   }
+  SleepService::wakeOnPin(incPin);
+  SleepService::wakeOnPin(decPin);
+  SleepService::begin();
 }
 
 void loop()
 {
   handleTimer();
+  fader.update();
+  handleSleep();
+}
+
+void handleSleep()
+{
+  noInterrupts();
+  if (!isIdle())
+  {
+    // Timer1 keeps the PWM up while lit, the next millis() tick wakes the loop
+    SleepService::idle();
+    return;
+  }
+
+  SleepService::powerDown();
+  // millis() stood still, whatever woke it is handled right away
+  timeNow = millis() - TIME_RESOLUTION - 1;
+}
+
+// lights off, no countdown and no pin that needs the loop, only a pin change starts new work
+bool isIdle()
+{
+  if (ledsOn || fader.getLevel() > 0 || fader.isFading() || settingsStore.isPending())
+  {
+    return false;
+  }
+
+  if (digitalRead(incPin) == HIGH || digitalRead(decPin) == HIGH)
+  {
+    return false;
+  }
+
+  for (byte i = 0; i < detectorsCount; i++)
+  {
+    if (digitalRead(detectors[i]) == HIGH)
+    {
+      return false;
+    }
+  }
+
+  return true;
 }
 
 void handleTimer()
@@ -67,11 +112,27 @@ void handleTimer()
   }
 }
 
+void loadSettings()
+{
+  if (settingsStore.load(&expectedLedVal))
+  {
+    return;
+  }
+
+  // value written by the previous firmware moves into the store once
+  if (EEPROM.read(0) == 1)
+  {
+    expectedLedVal = EEPROM.read(1);
+  }
+  settingsStore.save(&expectedLedVal);
+}
+
 void handleEvents()
 {
   handleIncDec();
   handleAutoOnOff();
   handleLeds();
+  settingsStore.handle(&expectedLedVal);
   //handleSignal();
 }
 
@@ -103,10 +164,19 @@ void handleIncDec()
 {
   bool wasChanged = false;
 
+  if (incDecCounter > 0)
+  {
+    incDecCounter--;
+  }
+
   if (digitalRead(incPin) == HIGH && digitalRead(decPin) == HIGH)
   {
     ledsOn = true;
-    currentLedVal = 0;
+    fader.set(0);
+  }
+  else if (incDecCounter > 0)
+  {
+    return;
   }
   else if (expectedLedVal < MAX_VAL && digitalRead(incPin) == HIGH)
   {
@@ -119,14 +189,13 @@ void handleIncDec()
     wasChanged = true;
     ledsOn = true;
     expectedLedVal -= 5;
-    currentLedVal = expectedLedVal > 0 ? expectedLedVal - 5 : 0;
   }
 
   if (wasChanged)
   {
     autoOffCounter = INITIAL_AUTO_OFF_VAL;
-    EEPROM.write(1, expectedLedVal);
-    delay(100);
+    incDecCounter = INC_DEC_TICKS;
+    settingsStore.changed();
   }
 }
 
@@ -173,25 +242,9 @@ void handleDetection()
 
 void handleLeds()
 {
-  bool wasChanged = false;
-
-  if (ledsOn && currentLedVal < expectedLedVal)
-  {
-    currentLedVal += 1;
-    wasChanged = true;
-  }
-
-  if (!ledsOn && currentLedVal > 0)
+  byte target = ledsOn ? expectedLedVal : 0;
+  if (target != fader.getTarget())
   {
-    currentLedVal -= 1;
-    wasChanged = true;
-  }
-
-  if (wasChanged)
-  {
-    for (byte i = 0; i < ledsCount; i++)
-    {
-      analogWrite(leds[i], currentLedVal);
-    }
+    fader.fadeTo(target, target == 0 || fader.getLevel() == 0 ? FADE_TIME : STEP_FADE_TIME);
   }
 }
@@ -6,16 +6,24 @@
 #include <FirmataParser.h>
 
 #include <EEPROM.h>
+#include <SettingsStore.h>
+#include <LedFader.h>
+#include <SleepService.h>
 
 #define TIME_RESOLUTION 10
 #define AUTO_OFF_MAX_VAL 1 * 60 * (1000 / TIME_RESOLUTION) // 1min
 #define INITIAL_AUTO_OFF_VAL 1 * 59 * (1000 / TIME_RESOLUTION) // 59s
 #define MAX_VAL 255
+#define FADE_TIME 1500     // ms, off to on and back
+#define STEP_FADE_TIME 200 // ms, between two lit levels
+#define INC_DEC_TICKS (100 / TIME_RESOLUTION) // one 5-unit step per 100ms while a button is held
+#define SETTINGS_ADDRESS 16                  // bytes 0-2 held the values before the store
+#define SETTINGS_SLOTS 16
 
 int leds[] = {10};
 byte ledsCount = 1;
+LedFader fader(leds, ledsCount);
 bool ledsOn = true;
-byte currentLedVal = 0;
 byte expectedLedVal = 100;
 byte expectedDimLedValue = 20;
 
@@ -33,43 +41,79 @@ int masterPin = 6;
 int incPin = 7;
 int decPin = 8;
 
+byte incDecCounter = 0;
+SettingsStore settingsStore(SETTINGS_ADDRESS, SETTINGS_SLOTS, 2);
+
 int signalPin = 13;
 int signalVal = 0;
 bool signalState = false;
 
 void setup()
 {
-  if (EEPROM.read(0) != 1)
-  {
-    EEPROM.write(0, 1);
-    EEPROM.write(1, expectedLedVal);
-    EEPROM.write(2, expectedDimLedValue);
-  }
-  else
-  {
-    expectedLedVal = EEPROM.read(1);
-    expectedDimLedValue = EEPROM.read(2);
-  }
+  loadSettings();
 
   pinMode(signalPin, OUTPUT);
   pinMode(incPin, INPUT);
   pinMode(decPin, INPUT);
   pinMode(masterPin, INPUT);
 
-  for (byte i = 0; i < ledsCount; i++)
-  {
-    pinMode(leds[i], OUTPUT);
-  }
+  fader.setup();
 
   for (byte i = 0; i < detectorsCount; i++)
   {
     pinMode(detectors[i], INPUT);
+    SleepService::wakeOnPin(detectors[i]);
   }
+  SleepService::wakeOnPin(incPin);
+  SleepService::wakeOnPin(decPin);
+  SleepService::wakeOnPin(masterPin);
+  SleepService::begin();
 }
 
 void loop()
 {
   handleTimer();
+  fader.update();
+  handleSleep();
+}
+
+void handleSleep()
+{
+  noInterrupts();
+  if (!isIdle())
+  {
+    // Timer1 keeps the PWM up while lit, the next millis() tick wakes the loop
+    SleepService::idle();
+    return;
+  }
+
+  SleepService::powerDown();
+  // millis() stood still, whatever woke it is handled right away
+  timeNow = millis() - TIME_RESOLUTION - 1;
+}
+
+// lights off, no countdown and no pin that needs the loop, only a pin change starts new work
+bool isIdle()
+{
+  if (ledsOn || fader.getLevel() > 0 || fader.isFading() || settingsStore.isPending())
+  {
+    return false;
+  }
+
+  if (digitalRead(incPin) == HIGH || digitalRead(decPin) == HIGH || digitalRead(masterPin) == HIGH)
+  {
+    return false;
+  }
+
+  for (byte i = 0; i < detectorsCount; i++)
+  {
+    if (digitalRead(detectors[i]) == HIGH)
+    {
+      return false;
+    }
+  }
+
+  return true;
 }
 
 void handleTimer()
@@ -81,11 +125,43 @@ void handleTimer()
   }
 }
 
+void loadSettings()
+{
+  byte settings[] = {expectedLedVal, expectedDimLedValue};
+  if (settingsStore.load(settings))
+  {
+    expectedLedVal = settings[0];
+    expectedDimLedValue = settings[1];
+    return;
+  }
+
+  // values written by the previous firmware move into the store once
+  if (EEPROM.read(0) == 1)
+  {
+    expectedLedVal = EEPROM.read(1);
+    expectedDimLedValue = EEPROM.read(2);
+  }
+  saveSettings();
+}
+
+void saveSettings()
+{
+  byte settings[] = {expectedLedVal, expectedDimLedValue};
+  settingsStore.save(settings);
+}
+
+void handleSettings()
+{
+  byte settings[] = {expectedLedVal, expectedDimLedValue};
+  settingsStore.handle(settings);
+}
+
 void handleEvents()
 {
   handleIncDec();
   handleAutoOnOff();
   handleLeds();
+  handleSettings();
   //handleSignal();
 }
 
@@ -119,10 +195,19 @@ void handleIncDec()
   bool wasChanged = false;
   byte *ledVal = isMasterOn ? &expectedLedVal : &expectedDimLedValue;
 
+  if (incDecCounter > 0)
+  {
+    incDecCounter--;
+  }
+
   if (digitalRead(incPin) == HIGH && digitalRead(decPin) == HIGH)
   {
     ledsOn = true;
-    currentLedVal = 0;
+    fader.set(0);
+  }
+  else if (incDecCounter > 0)
+  {
+    return;
   }
   else if (*ledVal < MAX_VAL && digitalRead(incPin) == HIGH)
   {
@@ -135,7 +220,6 @@ void handleIncDec()
     wasChanged = true;
     ledsOn = true;
     *ledVal -= 5;
-    currentLedVal = *ledVal > 0 ? *ledVal - 5 : 0;
   }
 
   if (wasChanged)
@@ -145,9 +229,8 @@ void handleIncDec()
     {
       wasDetected = true;
     }
-    EEPROM.write(1, expectedLedVal);
-    EEPROM.write(2, expectedDimLedValue);
-    delay(100);
+    incDecCounter = INC_DEC_TICKS;
+    settingsStore.changed();
   }
 }
 
@@ -199,37 +282,9 @@ void handleDetection()
 
 void handleLeds()
 {
-  bool wasChanged = false;
-
-  if (ledsOn && isMasterOn && currentLedVal < expectedLedVal)
-  {
-    currentLedVal += 1;
-    wasChanged = true;
-  }
-
-  if(ledsOn && !isMasterOn && currentLedVal < expectedDimLedValue)
-  {
-    currentLedVal += 1;
-    wasChanged = true;
-  }
-
-  if(ledsOn && !isMasterOn && currentLedVal > expectedDimLedValue)
-  {
-    currentLedVal -= 1;
-    wasChanged = true;
-  }
-
-  if (!ledsOn && currentLedVal > 0)
+  byte target = ledsOn ? (isMasterOn ? expectedLedVal : expectedDimLedValue) : 0;
+  if (target != fader.getTarget())
   {
-    currentLedVal -= 1;
-    wasChanged = true;
-  }
-
-  if (wasChanged)
-  {
-    for (byte i = 0; i < ledsCount; i++)
-    {
-      analogWrite(leds[i], currentLedVal);
-    }
+    fader.fadeTo(target, target == 0 || fader.getLevel() == 0 ? FADE_TIME : STEP_FADE_TIME);
   }
 }
@@ -1,12 +1,19 @@
 #include <EEPROM.h>
+#include <SettingsStore.h>
+#include <LedFader.h>
+#include <SleepService.h>
 
 #define TIME_RESOLUTION 100
 #define MAX_VAL 255
+#define FADE_TIME 1500     // ms, off to on and back
+#define STEP_FADE_TIME 200 // ms, between two lit levels
+#define SETTINGS_ADDRESS 16 // bytes 0-1 held the value before the store
+#define SETTINGS_SLOTS 16
 
 int leds[] = {10};
 byte ledsCount = 1;
+LedFader fader(leds, ledsCount);
 bool ledsOn = true;
-byte currentLedVal = 0;
 byte expectedLedVal = 100;
 
 unsigned long nextRead = 0;
@@ -14,35 +21,32 @@ unsigned long nextRead = 0;
 int incPin = 7;
 int decPin = 8;
 
+SettingsStore settingsStore(SETTINGS_ADDRESS, SETTINGS_SLOTS, 1);
+
 int signalPin = 13;
 int signalVal = 0;
 bool signalState = false;
 
 void setup()
 {
-  if (EEPROM.read(0) != 1)
-  {
-    EEPROM.write(0, 1);
-    EEPROM.write(1, expectedLedVal);
-  }
-  else
-  {
-    expectedLedVal = EEPROM.read(1);
-  }
+  loadSettings();
 
   pinMode(signalPin, OUTPUT);
   pinMode(incPin, INPUT);
   pinMode(decPin, INPUT);
 
-  for (byte i = 0; i < ledsCount; i++)
-  {
-    pinMode(leds[i], OUTPUT);
-  }
+  fader.setup();
+  SleepService::begin();
 }
 
 void loop()
 {
   handleTimer();
+  fader.update();
+
+  // always lit and blinking, so no power-down; the next millis() tick wakes the loop
+  noInterrupts();
+  SleepService::idle();
 }
 
 void handleTimer()
@@ -54,10 +58,26 @@ void handleTimer()
   }
 }
 
+void loadSettings()
+{
+  if (settingsStore.load(&expectedLedVal))
+  {
+    return;
+  }
+
+  // value written by the previous firmware moves into the store once
+  if (EEPROM.read(0) == 1)
+  {
+    expectedLedVal = EEPROM.read(1);
+  }
+  settingsStore.save(&expectedLedVal);
+}
+
 void handleEvents()
 {
   handleIncDec();
   handleLeds();
+  settingsStore.handle(&expectedLedVal);
   handleSignal();
 }
 
@@ -92,7 +112,7 @@ void handleIncDec()
   if (digitalRead(incPin) == HIGH && digitalRead(decPin) == HIGH)
   {
     ledsOn = true;
-    currentLedVal = 0;
+    fader.set(0);
   }
   else if (expectedLedVal < MAX_VAL && digitalRead(incPin) == HIGH)
   {
@@ -105,36 +125,19 @@ void handleIncDec()
     wasChanged = true;
     ledsOn = true;
     expectedLedVal -= 5;
-    currentLedVal = expectedLedVal > 0 ? expectedLedVal - 5 : 0;
   }
 
   if (wasChanged)
   {
-    EEPROM.write(1, expectedLedVal);
+    settingsStore.changed();
   }
 }
 
 void handleLeds()
 {
-  bool wasChanged = false;
-
-  if (ledsOn && currentLedVal < expectedLedVal)
-  {
-    currentLedVal += 1;
-    wasChanged = true;
-  }
-
-  if (!ledsOn && currentLedVal > 0)
-  {
-    currentLedVal -= 1;
-    wasChanged = true;
-  }
-
-  if (wasChanged)
+  byte target = ledsOn ? expectedLedVal : 0;
+  if (target != fader.getTarget())
   {
-    for (byte i = 0; i < ledsCount; i++)
-    {
-      analogWrite(leds[i], currentLedVal);
-    }
+    fader.fadeTo(target, target == 0 || fader.getLevel() == 0 ? FADE_TIME : STEP_FADE_TIME);
   }
 }
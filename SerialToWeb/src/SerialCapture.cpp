@@ -0,0 +1,98 @@
+#include "SerialCapture.h"
+
+void SerialCapture::begin(unsigned long baud)
+{
+    // the core UART interrupt fills this buffer, loop() only has to drain it in time
+    Serial.setRxBufferSize(CAPTURE_RX_BUFFER);
+    Serial.begin(baud);
+}
+
+void SerialCapture::handle()
+{
+    uint8_t buf[128];
+
+    if(Serial.hasOverrun())
+    {
+        overruns++;
+    }
+
+    int available;
+    while((available = Serial.available()) > 0)
+    {
+        size_t len = Serial.readBytes(buf, available < (int)sizeof(buf) ? available : sizeof(buf));
+        if(recorder != nullptr)
+        {
+            recorder->add(buf, len, micros64());
+        }
+
+        for(size_t i = 0; i < len; i++)
+        {
+            if(buf[i] == '\r')
+            {
+                continue;
+            }
+
+            if(isLineStart)
+            {
+                putTimestamp();
+                isLineStart = false;
+            }
+
+            put(buf[i]);
+            isLineStart = buf[i] == '\n';
+        }
+    }
+}
+
+void SerialCapture::put(uint8_t c)
+{
+    buffer[written & (CAPTURE_SIZE - 1)] = c;
+    written++;
+}
+
+void SerialCapture::putTimestamp()
+{
+    char buf[20];
+    unsigned long now = millis();
+    int len = sprintf(buf, "[%lu.%03lu] ", now / 1000, now % 1000);
+    for(int i = 0; i < len; i++)
+    {
+        put(buf[i]);
+    }
+}
+
+size_t SerialCapture::read(uint32_t &cursor, uint8_t *buf, size_t maxLen)
+{
+    while(true)
+    {
+        uint32_t end = written;
+        uint32_t oldest = end > CAPTURE_SIZE ? end - CAPTURE_SIZE : 0;
+        if(cursor > end)
+        {
+            // a cursor from before a restart, nothing to send until new bytes arrive
+            cursor = end;
+        }
+        else if(cursor < oldest)
+        {
+            cursor = oldest;
+        }
+
+        size_t len = end - cursor;
+        if(len > maxLen)
+        {
+            len = maxLen;
+        }
+
+        size_t offset = cursor & (CAPTURE_SIZE - 1);
+        size_t first = len < CAPTURE_SIZE - offset ? len : CAPTURE_SIZE - offset;
+        memcpy(buf, buffer + offset, first);
+        memcpy(buf + first, buffer, len - first);
+
+        // the writer may have overwritten the copied bytes meanwhile
+        if(written - cursor <= CAPTURE_SIZE)
+        {
+            cursor += len;
+            return len;
+        }
+    }
+}
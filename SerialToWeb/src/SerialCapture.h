@@ -0,0 +1,37 @@
+#pragma once
+
+#include <Arduino.h>
+#include <LogSource.h>
+
+#include "SerialRecorder.h"
+
+#define CAPTURE_SIZE 16384 // power of two
+#define CAPTURE_RX_BUFFER 4096
+
+/*
+Single writer ring of captured serial bytes, every line prefixed with the uptime.
+Positions are absolute byte counts, so any number of readers can follow the
+ring with their own cursor without copying it; a reader that falls behind
+skips to the oldest byte still kept.
+*/
+class SerialCapture : public LogSource
+{
+    private:
+        uint8_t buffer[CAPTURE_SIZE];
+        volatile uint32_t written = 0;
+        bool isLineStart = true;
+        uint32_t overruns = 0;
+        SerialRecorder *recorder = nullptr;
+
+        void put(uint8_t c);
+        void putTimestamp();
+
+    public:
+        void begin(unsigned long baud);
+        void setRecorder(SerialRecorder *recorder) { this->recorder = recorder; }
+        void handle();
+        size_t read(uint32_t &cursor, uint8_t *buf, size_t maxLen);
+        uint32_t getWritten() { return written; }
+        uint32_t getOldest() { return written > CAPTURE_SIZE ? written - CAPTURE_SIZE : 0; }
+        uint32_t getOverruns() { return overruns; }
+};
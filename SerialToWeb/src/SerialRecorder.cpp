@@ -0,0 +1,204 @@
+#include "SerialRecorder.h"
+
+bool SerialRecorder::start()
+{
+    if(isRecording)
+    {
+        return true;
+    }
+
+    if(!LittleFS.begin())
+    {
+        return false;
+    }
+
+    // continue after the file holding the newest blocks
+    uint32_t lastSequence = 0;
+    int lastIndex = -1;
+    for(byte i = 0; i < RECORD_FILES; i++)
+    {
+        File f = LittleFS.open(getFileName(i), "r");
+        if(!f)
+        {
+            continue;
+        }
+
+        uint32_t header[2];
+        if(f.read((uint8_t *)header, sizeof(header)) == sizeof(header) && header[0] == RECORD_MAGIC)
+        {
+            uint32_t last = header[1] + f.size() / RECORD_BLOCK_SIZE - 1;
+            if(lastIndex < 0 || last > lastSequence)
+            {
+                lastSequence = last;
+                lastIndex = i;
+            }
+        }
+
+        f.close();
+    }
+
+    sequence = lastIndex < 0 ? 0 : lastSequence + 1;
+    fileIndex = lastIndex < 0 ? 0 : (lastIndex + 1) % RECORD_FILES;
+    used = 0;
+    error = nullptr;
+
+    if(!openFile())
+    {
+        error = "cannot open file";
+        return false;
+    }
+
+    isRecording = true;
+    return true;
+}
+
+void SerialRecorder::stop()
+{
+    if(!isRecording)
+    {
+        return;
+    }
+
+    if(used > 0)
+    {
+        flushBlock();
+    }
+
+    file.close();
+    isRecording = false;
+}
+
+void SerialRecorder::add(const uint8_t *data, size_t len, uint64_t now)
+{
+    if(!isRecording)
+    {
+        return;
+    }
+
+    while(len > 0)
+    {
+        if(used == 0)
+        {
+            startBlock(now);
+        }
+
+        // worst case of both varints plus one data byte
+        if(RECORD_BLOCK_SIZE - used < 5 + 2 + 1)
+        {
+            flushBlock();
+            if(!isRecording)
+            {
+                return;
+            }
+            continue;
+        }
+
+        putVarint((uint32_t)(now - lastMicros));
+        size_t chunk = RECORD_BLOCK_SIZE - used - 2;
+        if(chunk > len)
+        {
+            chunk = len;
+        }
+
+        putVarint(chunk);
+        memcpy(block + used, data, chunk);
+        used += chunk;
+        lastMicros = now;
+        data += chunk;
+        len -= chunk;
+    }
+}
+
+void SerialRecorder::startBlock(uint64_t now)
+{
+    uint32_t magic = RECORD_MAGIC;
+    memset(block, 0, RECORD_HEADER_SIZE);
+    memcpy(block, &magic, sizeof(magic));
+    memcpy(block + 4, &sequence, sizeof(sequence));
+    memcpy(block + 8, &now, sizeof(now));
+    sequence++;
+    used = RECORD_HEADER_SIZE;
+    lastMicros = now;
+}
+
+void SerialRecorder::flushBlock()
+{
+    uint16_t u = used;
+    memcpy(block + 16, &u, sizeof(u));
+    memset(block + used, 0, RECORD_BLOCK_SIZE - used);
+    used = 0;
+
+    // a full filesystem never lets the file reach its size, nothing more would be stored
+    if(file.write(block, RECORD_BLOCK_SIZE) != RECORD_BLOCK_SIZE)
+    {
+        fail("write failed");
+        return;
+    }
+    blocks++;
+
+    if(file.size() >= RECORD_FILE_SIZE)
+    {
+        file.close();
+        fileIndex = (fileIndex + 1) % RECORD_FILES;
+        if(!openFile())
+        {
+            fail("cannot open file");
+        }
+    }
+}
+
+void SerialRecorder::fail(const char *reason)
+{
+    file.close();
+    isRecording = false;
+    error = reason;
+}
+
+bool SerialRecorder::openFile()
+{
+    file = LittleFS.open(getFileName(fileIndex), "w");
+    return file;
+}
+
+size_t SerialRecorder::putVarint(uint32_t value)
+{
+    size_t len = 0;
+    do
+    {
+        uint8_t b = value & 0x7F;
+        value >>= 7;
+        block[used++] = value ? b | 0x80 : b;
+        len++;
+    } while(value);
+
+    return len;
+}
+
+String SerialRecorder::getFileName(byte index)
+{
+    return String(RECORD_DIR) + "/" + String(index) + ".bin";
+}
+
+String SerialRecorder::list()
+{
+    String result = isRecording ? "recording\n" : error != nullptr ? "stopped: " + String(error) + "\n" : "stopped\n";
+    result += "blocks written: " + String(blocks) + "\n";
+
+    if(!LittleFS.begin())
+    {
+        return result;
+    }
+
+    for(byte i = 0; i < RECORD_FILES; i++)
+    {
+        String name = getFileName(i);
+        if(LittleFS.exists(name))
+        {
+            File f = LittleFS.open(name, "r");
+            result += name + " " + String(f.size()) + "\n";
+            f.close();
+        }
+    }
+
+    return result;
+}
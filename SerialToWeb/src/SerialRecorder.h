@@ -0,0 +1,47 @@
+#pragma once
+
+#include <Arduino.h>
+#include <LittleFS.h>
+
+#define RECORD_MAGIC 0x52575453UL // "STWR"
+#define RECORD_BLOCK_SIZE 4096
+#define RECORD_HEADER_SIZE 20
+#define RECORD_FILE_SIZE (RECORD_BLOCK_SIZE * 32UL)
+#define RECORD_FILES 4
+#define RECORD_DIR "/rec"
+
+/*
+Raw serial recording, written as fixed size blocks to RECORD_FILES rotating files.
+
+Block (little endian):
+    uint32 magic, uint32 sequence, uint64 start [us], uint16 used, uint16 reserved
+    records: varint delta [us] since the previous record (the first one since start),
+             varint length, data
+*/
+class SerialRecorder
+{
+    private:
+        uint8_t block[RECORD_BLOCK_SIZE];
+        size_t used = 0;
+        uint64_t lastMicros = 0;
+        uint32_t sequence = 0;
+        uint32_t blocks = 0;
+        byte fileIndex = 0;
+        bool isRecording = false;
+        const char *error = nullptr;
+        File file;
+
+        void startBlock(uint64_t now);
+        void flushBlock();
+        bool openFile();
+        void fail(const char *reason);
+        size_t putVarint(uint32_t value);
+        String getFileName(byte index);
+
+    public:
+        bool start();
+        void stop();
+        bool isActive() { return isRecording; }
+        void add(const uint8_t *data, size_t len, uint64_t now);
+        String list();
+};
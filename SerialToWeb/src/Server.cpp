@@ -1,14 +1,26 @@
 #include "Server.h"
 
-Server::Server(Logger *logger) :
+Server::Server(Logger *logger, SerialCapture *capture, SerialRecorder *recorder) :
     server(80),
-    logger(logger)
+    logger(logger),
+    capture(capture),
+    recorder(recorder),
+    captureStream(capture, "/capture/stream"),
+    logStream(logger, "/log/stream")
 {
 }
 
 void Server::setup()
 {
     server.on("/", std::bind(&Server::handleRoot, this, std::placeholders::_1));
+    captureStream.setup(&server);
+    logStream.setup(&server);
+    server.on("/capture", std::bind(&Server::handleCapture, this, std::placeholders::_1));
+    server.on("/log", std::bind(&Server::handleLog, this, std::placeholders::_1));
+    server.on("/record/start", std::bind(&Server::handleRecordStart, this, std::placeholders::_1));
+    server.on("/record/stop", std::bind(&Server::handleRecordStop, this, std::placeholders::_1));
+    server.on("/record/file", std::bind(&Server::handleRecordFile, this, std::placeholders::_1));
+    server.on("/record", std::bind(&Server::handleRecord, this, std::placeholders::_1));
 
     server.begin();
     logger->println("Server started");    
@@ -16,36 +28,76 @@ void Server::setup()
 
 void Server::handle()
 {   
-    const int max = 10;
-    char buf[max + 1];
-    buf[max] = 0;
-    int i = 0;
+    capture->handle();
+    captureStream.handle();
+    logStream.handle();
+}
+
+void Server::handleRoot(AsyncWebServerRequest *request)
+{
+    request->send(200, "text/html", LogStream::getPage("/capture/stream"));
+}
+
+void Server::handleCapture(AsyncWebServerRequest *request)
+{
+    SerialCapture *capture = this->capture;
+    uint32_t cursor = request->hasParam("from") ? request->getParam("from")->value().toInt() : capture->getOldest();
+    uint32_t end = capture->getWritten();
 
-    while(Serial.available())
+    AsyncWebServerResponse *response = request->beginChunkedResponse("text/plain", [capture, cursor, end](uint8_t *buffer, size_t maxLen, size_t index) mutable -> size_t
     {
-        buf[i] = (char)Serial.read();
-        i++;
-        if(i == max)
+        if(cursor >= end)
         {
-            logger->print(buf);
-            i = 0;
+            return 0;
         }
-    }
 
-    if(i > 0)
-    {
-        buf[i] = 0;
-        logger->print(buf);
-    }
+        return capture->read(cursor, buffer, min(maxLen, (size_t)(end - cursor)));
+    });
+
+    response->addHeader("X-Cursor", String(end));
+    response->addHeader("X-Overruns", String(capture->getOverruns()));
+    request->send(response);
 }
 
-void Server::handleRoot(AsyncWebServerRequest *request)
+void Server::handleLog(AsyncWebServerRequest *request)
+{
+    request->send(200, "text/html", LogStream::getPage("/log/stream"));
+}
+
+
+void Server::handleRecord(AsyncWebServerRequest *request)
+{
+    request->send(200, "text/plain", recorder->list());
+}
+
+void Server::handleRecordStart(AsyncWebServerRequest *request)
+{
+    bool started = recorder->start();
+    logger->println(started ? "Recording started" : "Cannot start recording");
+    request->send(started ? 200 : 500, "text/plain", started ? "recording" : "cannot start recording");
+}
+
+void Server::handleRecordStop(AsyncWebServerRequest *request)
 {
-    String src = "<html><head><script>setTimeout(function(){window.location.reload(1);}, 5000);</script></head><body><div>SerialToWeb logs:<div>";
+    recorder->stop();
+    logger->println("Recording stopped");
+    request->send(200, "text/plain", "stopped");
+}
 
-    src += logger->getLog();
+void Server::handleRecordFile(AsyncWebServerRequest *request)
+{
+    if(!request->hasParam("name"))
+    {
+        request->send(400, "text/plain", "invalid data");
+        return;
+    }
 
-    src += "</body></html>";
+    String name = String(RECORD_DIR) + "/" + request->getParam("name")->value();
+    if(name.indexOf("..") >= 0 || !LittleFS.exists(name))
+    {
+        request->send(404, "text/plain", "not found");
+        return;
+    }
 
-    request->send(200, "text/html", src);
+    request->send(LittleFS, name, "application/octet-stream", true);
 }
\ No newline at end of file
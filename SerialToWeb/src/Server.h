@@ -2,17 +2,31 @@
 
 #include <Arduino.h>
 #include <WiFiHandler.h>
+#include <LogStream.h>
+
+#include "SerialCapture.h"
+#include "SerialRecorder.h"
 
 class Server : public IDriver
 {
     private:        
         AsyncWebServer server;
         Logger *logger;
+        SerialCapture *capture;
+        SerialRecorder *recorder;
+        LogStream captureStream;
+        LogStream logStream;
   
         void handleRoot(AsyncWebServerRequest *request);
+        void handleCapture(AsyncWebServerRequest *request);
+        void handleLog(AsyncWebServerRequest *request);
+        void handleRecord(AsyncWebServerRequest *request);
+        void handleRecordStart(AsyncWebServerRequest *request);
+        void handleRecordStop(AsyncWebServerRequest *request);
+        void handleRecordFile(AsyncWebServerRequest *request);
   
     public:
-        Server(Logger *logger);
+        Server(Logger *logger, SerialCapture *capture, SerialRecorder *recorder);
         void setup();
         void handle(); 
-};
\ No newline at end of file
+};
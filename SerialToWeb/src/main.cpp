@@ -5,16 +5,21 @@
 #include <HttpAsyncClient.h>
 
 #include "Server.h"
+#include "SerialCapture.h"
+#include "SerialRecorder.h"
 
 #include "pwd.h"
 
-Logger logger(true, 5000U);
-Server server(&logger);
+Logger logger;
+SerialCapture capture;
+SerialRecorder recorder;
+Server server(&logger, &capture, &recorder);
 WiFiHandler wifiHandler(&logger, &server, ssid, password);
 
 void setup() 
 {
-  Serial.begin(115200);  
+  capture.begin(115200);
+  capture.setRecorder(&recorder);
   
   wifiHandler.setup();
 }
@@ -0,0 +1,99 @@
+#!/usr/bin/env python3
+"""Replays SerialToWeb recordings (see src/SerialRecorder.h for the block format).
+
+    replay.py rec/*.bin --dump                   print records
+    replay.py rec/*.bin --speed 10 > out.bin     write bytes to stdout, 10x faster
+    replay.py rec/*.bin --tcp localhost:5000     feed a test harness over TCP
+    replay.py rec/*.bin --port /dev/ttyUSB0      feed a serial port (needs pyserial)
+"""
+
+import argparse
+import socket
+import struct
+import sys
+import time
+
+MAGIC = 0x52575453
+BLOCK_SIZE = 4096
+HEADER = struct.Struct("<IIQHH")
+
+
+def varint(data, pos):
+    value = shift = 0
+    while True:
+        b = data[pos]
+        pos += 1
+        value |= (b & 0x7F) << shift
+        shift += 7
+        if not b & 0x80:
+            return value, pos
+
+
+def blocks(files):
+    result = []
+    for name in files:
+        with open(name, "rb") as f:
+            while True:
+                block = f.read(BLOCK_SIZE)
+                if len(block) < HEADER.size:
+                    break
+                magic, sequence, start, used, _ = HEADER.unpack_from(block)
+                if magic == MAGIC and HEADER.size <= used <= len(block):
+                    result.append((sequence, start, block[:used]))
+    return sorted(result)
+
+
+def records(files):
+    """Yields (time in us, bytes) ordered by block sequence."""
+    for _, start, block in blocks(files):
+        now = start
+        pos = HEADER.size
+        while pos < len(block):
+            delta, pos = varint(block, pos)
+            length, pos = varint(block, pos)
+            now += delta
+            yield now, block[pos:pos + length]
+            pos += length
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("files", nargs="+")
+    parser.add_argument("--speed", type=float, default=1.0, help="pace multiplier, 0 replays without delays")
+    parser.add_argument("--dump", action="store_true", help="print records instead of replaying them")
+    parser.add_argument("--tcp", help="host:port to connect to")
+    parser.add_argument("--port", help="serial port to write to")
+    parser.add_argument("--baud", type=int, default=115200)
+    args = parser.parse_args()
+
+    if args.dump:
+        first = None
+        for t, data in records(args.files):
+            first = t if first is None else first
+            print("%12.6f %4d %r" % ((t - first) / 1e6, len(data), data))
+        return
+
+    if args.tcp:
+        host, port = args.tcp.rsplit(":", 1)
+        conn = socket.create_connection((host, int(port)))
+        write = conn.sendall
+    elif args.port:
+        import serial
+        conn = serial.Serial(args.port, args.baud)
+        write = conn.write
+    else:
+        write = lambda data: (sys.stdout.buffer.write(data), sys.stdout.buffer.flush())
+
+    first = None
+    started = time.monotonic()
+    for t, data in records(args.files):
+        first = t if first is None else first
+        if args.speed > 0:
+            delay = (t - first) / 1e6 / args.speed - (time.monotonic() - started)
+            if delay > 0:
+                time.sleep(delay)
+        write(data)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,170 @@
+#include "LoadAllocator.h"
+
+LoadAllocator::LoadAllocator(unsigned long ratedLoad, byte priority)
+{
+    units[0].id = 0;
+    units[0].ratedLoad = ratedLoad;
+    units[0].priority = priority;
+    units[0].isOn = false;
+    units[0].wantsOn = false;
+    units[0].lastSeen = 0;
+}
+
+void LoadAllocator::setId(byte id)
+{
+    units[0].id = id;
+}
+
+void LoadAllocator::setState(bool isOn, bool wantsOn, unsigned long now)
+{
+    units[0].isOn = isOn;
+    units[0].wantsOn = wantsOn;
+    units[0].lastSeen = now;
+}
+
+String LoadAllocator::getStatus()
+{
+    char buf[40];
+    sprintf(buf, "%u %lu %u %u %u", units[0].id, units[0].ratedLoad, units[0].priority, units[0].isOn, units[0].wantsOn);
+    return String(buf);
+}
+
+void LoadAllocator::onUnit(String data, unsigned long now)
+{
+    unsigned int id, priority, isOn, wantsOn;
+    unsigned long ratedLoad;
+    if(sscanf(data.c_str(), "%u %lu %u %u %u", &id, &ratedLoad, &priority, &isOn, &wantsOn) != 5 || id == units[0].id)
+    {
+        return;
+    }
+
+    byte i = 1;
+    while(i < count && units[i].id != id)
+    {
+        i++;
+    }
+
+    if(i == count)
+    {
+        if(count < MAX_UNITS)
+        {
+            count++;
+        }
+        else
+        {
+            // replace the unit that was not seen for the longest time
+            i = 1;
+            for(byte j = 2; j < count; j++)
+            {
+                if(units[j].lastSeen < units[i].lastSeen)
+                {
+                    i = j;
+                }
+            }
+        }
+    }
+
+    units[i].id = id;
+    units[i].ratedLoad = ratedLoad;
+    units[i].priority = priority;
+    units[i].isOn = isOn;
+    units[i].wantsOn = wantsOn;
+    units[i].lastSeen = now;
+}
+
+void LoadAllocator::onLease(String data, unsigned long now)
+{
+    hasLease = data.indexOf(" " + String(units[0].id) + " ") >= 0;
+    leaseTime = now;
+}
+
+bool LoadAllocator::isFresh(unitInfo &unit, unsigned long now)
+{
+    return now - unit.lastSeen < UNIT_TIMEOUT;
+}
+
+bool LoadAllocator::isCooperative(unsigned long now)
+{
+    for(byte i = 1; i < count; i++)
+    {
+        if(isFresh(units[i], now))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool LoadAllocator::isLeader(unsigned long now)
+{
+    for(byte i = 1; i < count; i++)
+    {
+        if(isFresh(units[i], now) && units[i].id < units[0].id)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool LoadAllocator::isAllowed(unsigned long now)
+{
+    return hasLease && leaseTime > 0 && now - leaseTime < LEASE_TIMEOUT;
+}
+
+String LoadAllocator::allocate(float availablePower, unsigned long activePower, float offMargin, unsigned long now)
+{
+    byte order[MAX_UNITS];
+    byte n = 0;
+    float managedLoad = 0;
+
+    for(byte i = 0; i < count; i++)
+    {
+        if(!isFresh(units[i], now))
+        {
+            continue;
+        }
+
+        if(units[i].isOn)
+        {
+            managedLoad += units[i].ratedLoad;
+        }
+
+        // insertion sort, highest priority first, then lowest id
+        byte j = n++;
+        while(j > 0 && (units[order[j - 1]].priority < units[i].priority ||
+                        (units[order[j - 1]].priority == units[i].priority && units[order[j - 1]].id > units[i].id)))
+        {
+            order[j] = order[j - 1];
+            j--;
+        }
+        order[j] = i;
+    }
+
+    float baseLoad = activePower > managedLoad ? activePower - managedLoad : 0;
+    float remaining = availablePower - baseLoad;
+    bool hasNewGrant = false;
+    String result = " ";
+
+    for(byte k = 0; k < n; k++)
+    {
+        unitInfo &unit = units[order[k]];
+        if(!unit.wantsOn)
+        {
+            continue;
+        }
+
+        // units already on keep their lease within the off margin, only one unit is switched on per sample
+        if((unit.isOn && remaining + offMargin >= unit.ratedLoad) ||
+           (!unit.isOn && !hasNewGrant && remaining >= unit.ratedLoad))
+        {
+            remaining -= unit.ratedLoad;
+            hasNewGrant = hasNewGrant || !unit.isOn;
+            result += String(unit.id) + " ";
+        }
+    }
+
+    return result;
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <Arduino.h>
+
+#define MAX_UNITS 8
+#define UNIT_TIMEOUT 1000UL * 30
+#define LEASE_TIMEOUT 1000UL * 30
+
+struct unitInfo
+{
+    byte id;
+    unsigned long ratedLoad;
+    byte priority;
+    bool isOn;
+    bool wantsOn;
+    unsigned long lastSeen;
+};
+
+/*
+Socket units announce themselves on the "socket" telemetry topic as
+"<id> <rated load> <priority> <is on> <wants on>". The fresh unit with the
+lowest id is the leader: after every PV sample it splits the available PV
+power greedily by priority and publishes the ids allowed to be on as the
+"lease" topic. A unit that sees other units only keeps its load on while
+it holds a fresh lease.
+*/
+class LoadAllocator
+{
+    private:
+        unitInfo units[MAX_UNITS]; // units[0] is this unit
+        byte count = 1;
+        bool hasLease = false;
+        unsigned long leaseTime = 0;
+
+        bool isFresh(unitInfo &unit, unsigned long now);
+
+    public:
+        LoadAllocator(unsigned long ratedLoad, byte priority);
+        void setId(byte id);
+        void setState(bool isOn, bool wantsOn, unsigned long now);
+        String getStatus();
+        void onUnit(String data, unsigned long now);
+        void onLease(String data, unsigned long now);
+        bool isCooperative(unsigned long now);
+        bool isLeader(unsigned long now);
+        bool isAllowed(unsigned long now);
+        String allocate(float availablePower, unsigned long activePower, float offMargin, unsigned long now);
+        byte getCount() { return count; }
+};
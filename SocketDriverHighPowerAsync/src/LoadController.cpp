@@ -0,0 +1,66 @@
+#include "LoadController.h"
+
+bool LoadController::update(int voltage, unsigned long power, unsigned long activePower, unsigned long now)
+{
+    if(!hasSample)
+    {
+        this->voltage = voltage;
+        this->power = power;
+        trend = 0;
+        hasSample = true;
+    }
+    else
+    {
+        float previousPower = this->power;
+        float dt = (now - lastSample) / 1000.0;
+        this->voltage += config.alpha * (voltage - this->voltage);
+        this->power += config.alpha * ((float)power - this->power);
+
+        if(dt > 0)
+        {
+            trend += config.trendAlpha * ((this->power - previousPower) / dt - trend);
+        }
+    }
+
+    lastSample = now;
+
+    if(isOn && now - lastChange < config.minOnTime)
+    {
+        return isOn;
+    }
+
+    if(!isOn && lastChange > 0 && now - lastChange < config.minOffTime)
+    {
+        return isOn;
+    }
+
+    float predictedPower = getPredictedPower();
+
+    if(isOn)
+    {
+        return this->voltage >= config.offVoltage && predictedPower >= (float)activePower - config.offMargin;
+    }
+
+    return this->voltage >= config.onVoltage && trend * config.horizon > -config.offMargin;
+}
+
+void LoadController::setState(bool isOn, unsigned long now)
+{
+    if(this->isOn != isOn)
+    {
+        this->isOn = isOn;
+        lastChange = now;
+    }
+}
+
+void LoadController::reset()
+{
+    hasSample = false;
+    trend = 0;
+}
+
+float LoadController::getPredictedPower()
+{
+    float predicted = power + trend * config.horizon;
+    return predicted < 0 ? 0 : predicted;
+}
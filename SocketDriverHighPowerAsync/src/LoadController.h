@@ -0,0 +1,40 @@
+#pragma once
+
+#include <Arduino.h>
+
+struct loadConfig
+{
+    float onVoltage = 260;         // smoothed PV voltage needed to turn on
+    float offVoltage = 240;        // smoothed PV voltage below which it turns off
+    float offMargin = 100;         // W of PV power under the active load before turning off
+    float alpha = 0.3;             // smoothing factor of PV voltage and power
+    float trendAlpha = 0.2;        // smoothing factor of the PV power trend
+    unsigned long horizon = 60;    // s, how far ahead the trend is projected
+    unsigned long minOnTime = 1000UL * 60 * 5;
+    unsigned long minOffTime = 1000UL * 60 * 2;
+};
+
+class LoadController
+{
+    private:
+        loadConfig config;
+        bool hasSample = false;
+        bool isOn = false;
+        unsigned long lastSample = 0;
+        unsigned long lastChange = 0;
+        float voltage = 0;
+        float power = 0;
+        float trend = 0; // W/s
+
+    public:
+        /*
+        Feeds a fresh sample and returns the state the load should be in.
+        */
+        bool update(int voltage, unsigned long power, unsigned long activePower, unsigned long now);
+        void setState(bool isOn, unsigned long now);
+        void reset();
+        float getVoltage() { return voltage; }
+        float getPower() { return power; }
+        float getPredictedPower();
+        loadConfig &getConfig() { return config; }
+};
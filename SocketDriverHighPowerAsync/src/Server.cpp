@@ -1,11 +1,13 @@
 #include "Server.h"
 
-Server::Server(Logger *logger) :
+Server::Server(Logger *logger, Scheduler *scheduler, unsigned long ratedLoad, byte priority) :
     server(80),
-    checkParamsTimer(std::bind(&Server::handleCheckParamsEvent, this), 1000 * 30),
-    checkPinTimer(std::bind(&Server::handlePinEvent, this), 1000 * 60),
     logger(logger),
-    handler(logger)
+    scheduler(scheduler),
+    handler(logger, scheduler, &Server::handleParamsReceived, this),
+    subscriber(this),
+    allocator(ratedLoad, priority),
+    logStream(logger, "/log/stream")
 {
     info.error = "";
 }
@@ -13,34 +15,46 @@ Server::Server(Logger *logger) :
 void Server::setup()
 {
     server.on("/", std::bind(&Server::handleRoot, this, std::placeholders::_1));
+    server.on("/log/live", std::bind(&Server::handleLiveLog, this, std::placeholders::_1));
+    logStream.setup(&server);
     server.on("/log", std::bind(&Server::handleLog, this, std::placeholders::_1));
+    METRICS_SETUP(&server);
+    server.on("/tasks", std::bind(&Server::handleTasks, this, std::placeholders::_1));
     server.on("/on", std::bind(&Server::handleOn, this, std::placeholders::_1));
     server.on("/off", std::bind(&Server::handleOff, this, std::placeholders::_1));
 
 
     server.begin();
-    checkParamsTimer.start();
-    checkPinTimer.start();
+    allocator.setId(WiFi.localIP()[3]);
+    subscriber.begin();
+
+    checkParamsTask = scheduler->every("params", 1000UL * 30, std::bind(&Server::handleCheckParamsEvent, this));
+    checkPinTask = scheduler->every("pin", 1000UL * 60, std::bind(&Server::handlePinEvent, this));
+    telemetryTask = scheduler->every("telemetry", 20, std::bind(&TelemetrySubscriber::handle, &subscriber));
+    scheduler->every("log", 200, std::bind(&LogStream::handle, &logStream));
     logger->println("Server started");    
 }
 
 void Server::handle()
 {
-    checkParamsTimer.update();
-    checkPinTimer.update();
 }
 
 void Server::setConnected()
 {
-    checkParamsTimer.resume();
-    checkPinTimer.resume();
+    subscriber.begin();
+    scheduler->setEnabled(checkParamsTask, true);
+    scheduler->setEnabled(checkPinTask, true);
+    scheduler->setEnabled(telemetryTask, true);
 }
 
 void Server::setDisconnected()
 {
-    checkParamsTimer.pause();
-    checkPinTimer.pause();
+    scheduler->setEnabled(checkParamsTask, false);
+    scheduler->setEnabled(checkPinTask, false);
+    scheduler->setEnabled(telemetryTask, false);
+    subscriber.stop();
     info.error = "Connection lost";
+    controller.reset();
     turnOff();
 }
 
@@ -49,74 +63,167 @@ void Server::handleLog(AsyncWebServerRequest *request)
     request->send(200, "text/html", this->logger->getLog());
 }
 
+void Server::handleLiveLog(AsyncWebServerRequest *request)
+{
+    request->send(200, "text/html", LogStream::getPage("/log/stream"));
+}
+
+void Server::handleTasks(AsyncWebServerRequest *request)
+{
+    request->send(200, "text/plain", scheduler->getStats());
+}
+
 void Server::handleOn(AsyncWebServerRequest *request)
 {
+    METRICS_HANDLER("on");
     turnOn();
     request->send(200, "text/html", "on");
 }
 
 void Server::handleOff(AsyncWebServerRequest *request)
 {
+    METRICS_HANDLER("off");
     turnOff();
     request->send(200, "text/html", "off");
 }
 
 void Server::handleRoot(AsyncWebServerRequest *request)
 {
+    METRICS_HANDLER("root");
     String src = "<div>High power Socket Driver is ";
     src += (isOn ? "on" : "off");
     src += "</div>";
     src += "<div>Status: ";
     src += (info.error.length() > 0 ? info.error : isOn ? "OK" : "low pv input");
     src += "</div>";
+    src += "<div>PV voltage: " + String(controller.getVoltage(), 1) + " V</div>";
+    src += "<div>PV power: " + String(controller.getPower(), 0) + " W, predicted: " + String(controller.getPredictedPower(), 0) + " W</div>";
+    src += "<div>Active power: " + String(info.activePower) + " W</div>";
+    src += "<div>Units: " + String(allocator.getCount());
+    src += (allocator.isCooperative(millis()) ? (allocator.isLeader(millis()) ? ", leader" : ", follower") : ", standalone");
+    src += "</div>";
 
     request->send(200, "text/html", src);
 }
 
 void Server::handleCheckParamsEvent()
 {
+    if(subscriber.getAge() < 1000UL * 60)
+    {
+        return;
+    }
+
     client.httpGet(&handler, "http://192.168.100.30:80/api/paramsCache");
-    info = handler.getInfo();
-    logger->println("voltage: " + String(info.voltage) + " power: " + String(info.power) + " active pover: " + String(info.activePower));    
 }
 
-void Server::handlePinEvent()
+void Server::onTelemetry(String topic, uint32_t sequence, String data)
+{
+    if(topic == "qpigs")
+    {
+        handleSample(ParamsResponseHandler::parse(data));
+    }
+    else if(topic == "socket")
+    {
+        allocator.onUnit(data, millis());
+    }
+    else if(topic == "lease" && !allocator.isLeader(millis()))
+    {
+        allocator.onLease(data, millis());
+        applyState();
+    }
+}
+
+void Server::handleSample(pvInfo sample)
+{
+    METRICS_SCOPE("sample");
+    info = sample;
+    if(info.error.length() > 0)
+    {
+        return;
+    }
+
+    lastSample = millis();
+    wantsOn = controller.update(info.voltage, info.power, info.activePower, lastSample);
+
+    allocator.setState(isOn, wantsOn, lastSample);
+    publisher.publish("socket", allocator.getStatus());
+
+    if(allocator.isCooperative(lastSample) && allocator.isLeader(lastSample))
+    {
+        String lease = allocator.allocate(controller.getPredictedPower(), info.activePower, controller.getConfig().offMargin, lastSample);
+        publisher.publish("lease", lease);
+        allocator.onLease(lease, lastSample);
+    }
+
+    applyState();
+}
+
+void Server::applyState()
 {
-    if(!isOn && info.voltage >= 260)
+    unsigned long now = millis();
+    bool shouldBeOn = wantsOn && (!allocator.isCooperative(now) || allocator.isAllowed(now));
+    if(shouldBeOn && !isOn)
     {
         turnOn();
     }
-    else if(isOn && info.power < (info.activePower - 100UL))
+    else if(!shouldBeOn && isOn)
     {
         turnOff();
     }
 }
 
+void Server::handleParamsReceived(void *server)
+{
+    Server *self = (Server *)server;
+    self->handleSample(self->handler.getInfo());
+}
+
+void Server::handlePinEvent()
+{
+    if(isOn && millis() - lastSample > 1000UL * 60 * 5)
+    {
+        info.error = "No fresh pv data";
+        controller.reset();
+        turnOff();
+    }
+}
+
 void Server::turnOn()
 {
     isOn = true;
+    controller.setState(isOn, millis());
     analogWrite(pin, 255);
-    logger->println("turn on");
+    logger->println("turn on, voltage: " + String(info.voltage) + " power: " + String(info.power) + " active power: " + String(info.activePower));
 }
 
 void Server::turnOff()
 {
     isOn = false;
+    controller.setState(isOn, millis());
     analogWrite(pin, 0);
-    logger->println("turn off");
+    logger->println("turn off, voltage: " + String(info.voltage) + " power: " + String(info.power) + " active power: " + String(info.activePower));
 }
 
 void ParamsResponseHandler::onData(String data)
 {
     LoggerResponseHandler::onData(data);
-    info.voltage = data.substring(64, 67).toInt();
-    info.power = data.substring(97, 102).toInt();
-    info.activePower = data.substring(27, 31).toInt();
-    info.error = "";
+    info = parse(data);
+    scheduler->defer(onReceived, arg);
+}
+
+pvInfo ParamsResponseHandler::parse(String data)
+{
+    pvInfo result;
+    result.voltage = data.substring(64, 67).toInt();
+    result.power = data.substring(97, 102).toInt();
+    result.activePower = data.substring(27, 31).toInt();
+    result.error = "";
+    return result;
 }
 
 void ParamsResponseHandler::onError(String error)
 {
     LoggerResponseHandler::onError(error); 
     info.error = error;
+    scheduler->defer(onReceived, arg);
 }
\ No newline at end of file
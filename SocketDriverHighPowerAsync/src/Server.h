@@ -1,11 +1,17 @@
 #pragma once
 
 #include <Arduino.h>
-#include <TickTwo.h>
 
 #include <WiFiHandler.h>
 #include <HttpAsyncClient.h>
 #include <LoggerResponseHandler.h>
+#include <Telemetry.h>
+#include <LogStream.h>
+#include <Scheduler.h>
+#include <Metrics.h>
+
+#include "LoadController.h"
+#include "LoadAllocator.h"
 
 struct pvInfo
 {
@@ -19,40 +25,60 @@ class ParamsResponseHandler : public LoggerResponseHandler
 {
     private:
         pvInfo info;        
+        Scheduler *scheduler;
+        DeferredCallback onReceived;
+        void *arg;
 
     public:
-        ParamsResponseHandler(Logger *logger) : LoggerResponseHandler(logger) {}
+        ParamsResponseHandler(Logger *logger, Scheduler *scheduler, DeferredCallback onReceived, void *arg) :
+            LoggerResponseHandler(logger), scheduler(scheduler), onReceived(onReceived), arg(arg) {}
         void onData(String data);
         void onError(String error);
         pvInfo getInfo() { return info; }
+        static pvInfo parse(String data);
 };
 
-class Server : public IDriver
+class Server : public IDriver, public TelemetryHandler
 {
     private:        
         AsyncWebServer server;
-        TickTwo checkParamsTimer;
-        TickTwo checkPinTimer;
         HttpAsyncClient client;
         Logger *logger;
+        Scheduler *scheduler;
+        TaskId checkParamsTask = -1;
+        TaskId checkPinTask = -1;
+        TaskId telemetryTask = -1;
         ParamsResponseHandler handler;
+        TelemetrySubscriber subscriber;
+        TelemetryPublisher publisher;
+        LoadController controller;
+        LoadAllocator allocator;
+        LogStream logStream;
         pvInfo info;
+        unsigned long lastSample = 0;
         bool isOn = false;
+        bool wantsOn = false;
         int pin = 5;
 
         void handleCheckParamsEvent();
         void handlePinEvent();
+        static void handleParamsReceived(void *server);
+        void handleSample(pvInfo sample);
+        void applyState();
         void handleRoot(AsyncWebServerRequest *request);
         void handleLog(AsyncWebServerRequest *request);        
+        void handleLiveLog(AsyncWebServerRequest *request);        
+        void handleTasks(AsyncWebServerRequest *request);        
         void handleOn(AsyncWebServerRequest *request);        
         void handleOff(AsyncWebServerRequest *request);        
         void turnOn();
         void turnOff();
 
     public:
-        Server(Logger *logger);
+        Server(Logger *logger, Scheduler *scheduler, unsigned long ratedLoad, byte priority);
         void setup();
         void handle(); 
         void setDisconnected();
         void setConnected();
+        void onTelemetry(String topic, uint32_t sequence, String data);
 };
\ No newline at end of file
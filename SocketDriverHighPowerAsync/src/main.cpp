@@ -3,6 +3,8 @@
 #include <TimeService.h>
 #include <Logger.h>
 #include <HttpAsyncClient.h>
+#include <Scheduler.h>
+#include <Metrics.h>
 
 #include "Server.h"
 
@@ -10,7 +12,8 @@
 
 TimeService timeService;
 Logger logger;
-Server server(&logger);
+Scheduler scheduler;
+Server server(&logger, &scheduler, 2000, 1); // rated load [W], priority
 WiFiHandler wifiHandler(&logger, &server, ssid, password);
 
 void setup() 
@@ -25,5 +28,9 @@ void setup()
 
 void loop() 
 {
+  METRICS_LOOP();
   wifiHandler.handle();
+  scheduler.handle();
+  METRICS_LOOP_END();
+  scheduler.sleep();
 }
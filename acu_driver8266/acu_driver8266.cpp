@@ -16,7 +16,7 @@ ACUDrivier::ACUDrivier(IPAddress &id,
 
 void ACUDrivier::begin()
 {
-    Serial.begin(9600);
+    Serial.begin(ACU_BAUD_RATE);
 
     WiFi.mode(WIFI_STA);
     WiFi.config(this->ip, this->gateway, this->subnet, this->dns1, this->dns2);
@@ -105,6 +105,7 @@ void ACUDrivier::handle()
 {
     this->server.handleClient();
 
+    this->handleSerial();
     this->handleTimeEvents();
 
     if (this->otaEnabled)
@@ -129,14 +130,21 @@ void ACUDrivier::handleTimeEvents()
             this->getTime();                        
         }
 
-        if(this->timer % 100 == 0){
-            Serial.println("GeT");
-            delay(100);
-            if(Serial.available())
-            {
-                String result = Serial.readString();
-                this->value = result.toInt();
-            }
+        if (this->timer % 100 == 0)
+        {
+            AcuFrame::send(Serial, ACU_GET_VALUE, nullptr, 0);
+        }
+    }
+}
+
+void ACUDrivier::handleSerial()
+{
+    while (Serial.available())
+    {
+        if (this->frame.parse(Serial.read()) && this->frame.type == ACU_VALUE && this->frame.length >= 2)
+        {
+            this->value = this->frame.getUInt16(0);
+            this->valueTime = millis();
         }
     }
 }
@@ -165,7 +173,8 @@ void ACUDrivier::handleRoot()
 {
     String src = "<div>ACU Driver</div>";    
 
-    src += String(this->value);
+    src += "<div>Value: " + String(this->value) + " (" + String(this->value / 16.0f, 2) + ")</div>";
+    src += "<div>Age: " + String(this->valueTime > 0 ? (millis() - this->valueTime) / 1000 : 0) + " s</div>";
 
     this->server.send(200, "text/html", src);
 }
@@ -12,6 +12,8 @@
 #include <CRC16.h>
 #include "FS.h"
 
+#include <AcuProtocol.h>
+
 struct DateTime
 {
     int year;
@@ -42,7 +44,9 @@ private:
     int timer = 0;
     bool otaEnabled = false;
     uint value = 0;
-    
+    unsigned long valueTime = 0;
+    AcuFrame frame;
+
     void onWifiDisconnect(const WiFiEventStationModeDisconnected &event);
     void onWifiConnected(const WiFiEventStationModeConnected &event);
     void handleNotFound();
@@ -53,6 +57,7 @@ private:
     void handleOTA();
     void handleReset();
     void handleRoot();
+    void handleSerial();
     DateTime getDate();
 
 public:
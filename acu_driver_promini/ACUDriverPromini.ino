@@ -1,39 +1,64 @@
-#include <EEPROM.h>
+#include <AcuProtocol.h>
 
-#define TIME_RESOLUTION 100
-#define MAX_VAL 255
+// 256 samples of 10 bit decimated by 16 give a 14 bit value
+#define OVERSAMPLING 256
+#define DECIMATION_SHIFT 4
 
-int vals[] = {0, 0, 0, 0};
-unsigned long val = 0;
+volatile uint32_t sum = 0;
+volatile uint16_t count = 0;
+volatile uint16_t value = 0;
+
+AcuFrame frame;
+
+ISR(ADC_vect)
+{
+  sum += ADC;
+  count++;
+
+  if(count == OVERSAMPLING)
+  {
+    value = sum >> DECIMATION_SHIFT;
+    sum = 0;
+    count = 0;
+  }
+}
 
 void setup()
 {
   pinMode(A0, INPUT);
-  Serial.begin(4800);
+  Serial.begin(ACU_BAUD_RATE);
+
+  // AVcc reference, A0, free running with interrupt, prescaler 128
+  ADMUX = _BV(REFS0);
+  ADCSRB = 0;
+  ADCSRA = _BV(ADEN) | _BV(ADATE) | _BV(ADIE) | _BV(ADPS2) | _BV(ADPS1) | _BV(ADPS0);
+  ADCSRA |= _BV(ADSC);
 }
 
 void loop()
 {
-  if(Serial.available())
+  while(Serial.available())
   {
-    String cmd = Serial.readString();
-
-    if(cmd.startsWith("GeT"))
+    if(frame.parse(Serial.read()) && frame.type == ACU_GET_VALUE)
     {
-      for(int i=0; i < 4; i++)
-      {
-        vals[i] = analogRead(A0);
-        delay(50);
-      }
+      sendValue();
+    }
+  }
+}
 
-      val = 0;
-      for(int i=0; i< 4; i++){
-        val += vals[i];
-      }
+void sendValue()
+{
+  uint16_t v;
+  noInterrupts();
+  v = value;
+  interrupts();
 
-      val = (int)(val / 4);
+  byte payload[4] = {
+    (byte)(v & 0xFF),
+    (byte)(v >> 8),
+    (byte)(OVERSAMPLING & 0xFF),
+    (byte)(OVERSAMPLING >> 8)
+  };
 
-        Serial.println(val);      
-    }
-  }
+  AcuFrame::send(Serial, ACU_VALUE, payload, sizeof(payload));
 }
@@ -1,8 +1,9 @@
 #include "LedHandler.h"
 
-LedHandler::LedHandler(int ledPin) : timer(std::bind(&LedHandler::handleLed, this), 100)
+LedHandler::LedHandler(int ledPin, byte interval) : timer(std::bind(&LedHandler::handleLed, this), 100)
 {
     this->ledPin = ledPin;
+    this->interval = interval;
 }
 
 void LedHandler::setMaxValue(int value)
@@ -15,7 +15,8 @@ class LedHandler {
         void handleLed();
 
     public:
-        LedHandler(int ledPin);
+        // interval is the PWM step of every 100 ms fade tick
+        LedHandler(int ledPin, byte interval = 1);
         void setMaxValue(int value);
         int getMaxValue();
         void turnOn();
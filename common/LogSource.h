@@ -0,0 +1,18 @@
+#pragma once
+
+#include <Arduino.h>
+
+/*
+Append only text addressed by absolute positions: getWritten() is the total number
+of bytes ever written, getOldest() the first position still kept.
+*/
+class LogSource
+{
+    public:
+        virtual uint32_t getWritten() = 0;
+        virtual uint32_t getOldest() = 0;
+        /*
+        Copies up to maxLen bytes from cursor and advances it, a cursor older than getOldest() is moved forward.
+        */
+        virtual size_t read(uint32_t &cursor, uint8_t *buf, size_t maxLen) = 0;
+};
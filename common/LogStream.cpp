@@ -0,0 +1,86 @@
+#include "LogStream.h"
+
+LogStream::LogStream(LogSource *source, const char *url) :
+    events(url),
+    source(source)
+{
+}
+
+void LogStream::setup(AsyncWebServer *server)
+{
+    cursor = source->getWritten();
+    events.onConnect(std::bind(&LogStream::onConnect, this, std::placeholders::_1));
+    server->addHandler(&events);
+}
+
+void LogStream::handle()
+{
+    if(millis() - lastSend < LOG_STREAM_INTERVAL)
+    {
+        return;
+    }
+
+    lastSend = millis();
+
+    if(events.count() == 0)
+    {
+        cursor = source->getWritten();
+        return;
+    }
+
+    if(events.avgPacketsWaiting() > LOG_STREAM_MAX_WAITING)
+    {
+        return;
+    }
+
+    char buf[LOG_STREAM_CHUNK + 1];
+    while(cursor != source->getWritten() && readLines(cursor, buf, LOG_STREAM_CHUNK) > 0)
+    {
+        events.send(buf, NULL, cursor);
+    }
+}
+
+void LogStream::onConnect(AsyncEventSourceClient *client)
+{
+    uint32_t clientCursor = client->lastId() > 0 ? client->lastId() : source->getOldest();
+    char buf[LOG_STREAM_CHUNK + 1];
+
+    while(clientCursor < cursor && readLines(clientCursor, buf, min((uint32_t)LOG_STREAM_CHUNK, cursor - clientCursor)) > 0)
+    {
+        client->send(buf, NULL, clientCursor);
+    }
+}
+
+size_t LogStream::readLines(uint32_t &cursor, char *buf, size_t maxLen)
+{
+    uint32_t start = cursor;
+    size_t len = source->read(start, (uint8_t *)buf, maxLen);
+    uint32_t skipped = start - len - cursor;
+
+    size_t end = len;
+    while(end > 0 && buf[end - 1] != '\n')
+    {
+        end--;
+    }
+
+    // a line longer than a whole chunk is sent as it is
+    if(end == 0 && len == maxLen)
+    {
+        end = len;
+    }
+
+    buf[end] = 0;
+    cursor += skipped + end;
+    return end;
+}
+
+String LogStream::getPage(const char *url)
+{
+    String src = "<html><body><pre id=\"log\"></pre><script>";
+    src += "var log=document.getElementById('log');";
+    src += "new EventSource('";
+    src += url;
+    src += "').onmessage=function(e){log.textContent+=e.data+'\\n';window.scrollTo(0,document.body.scrollHeight);};";
+    src += "</script></body></html>";
+    return src;
+}
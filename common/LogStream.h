@@ -0,0 +1,32 @@
+#pragma once
+
+#include <Arduino.h>
+#include <ESPAsyncWebServer.h>
+
+#include <LogSource.h>
+
+#define LOG_STREAM_CHUNK 1024
+#define LOG_STREAM_INTERVAL 200
+#define LOG_STREAM_MAX_WAITING 8
+
+/*
+Server-sent events stream of a LogSource. Only complete lines are sent and the event id is
+the cursor after them, so a reconnecting EventSource resumes where it stopped.
+*/
+class LogStream
+{
+    private:
+        AsyncEventSource events;
+        LogSource *source;
+        uint32_t cursor = 0;
+        unsigned long lastSend = 0;
+
+        void onConnect(AsyncEventSourceClient *client);
+        size_t readLines(uint32_t &cursor, char *buf, size_t maxLen);
+
+    public:
+        LogStream(LogSource *source, const char *url);
+        void setup(AsyncWebServer *server);
+        void handle();
+        static String getPage(const char *url);
+};
@@ -7,7 +7,7 @@ void Logger::print(String str)
         Serial.print(str);
     }
     
-    str = str;
+    written += str.length();
 
     if (str.length() > this->maxLog)
     {
@@ -45,4 +45,23 @@ String Logger::getLog()
     String result = "Logs:</br>" + this->log;
     result.replace("\r\n", "</br>");
     return result;
+}
+
+size_t Logger::read(uint32_t &cursor, uint8_t *buf, size_t maxLen)
+{
+    uint32_t oldest = getOldest();
+    if(cursor < oldest || cursor > written)
+    {
+        cursor = oldest;
+    }
+
+    size_t len = written - cursor;
+    if(len > maxLen)
+    {
+        len = maxLen;
+    }
+
+    memcpy(buf, this->log.c_str() + (cursor - oldest), len);
+    cursor += len;
+    return len;
 }
\ No newline at end of file
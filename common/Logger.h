@@ -2,11 +2,14 @@
 
 #include <Arduino.h>
 
-class Logger {
+#include <LogSource.h>
+
+class Logger : public LogSource {
     private:
         String log = "";
         bool logToSerial;
         unsigned int maxLog;        
+        uint32_t written = 0;
 
     public:
         Logger(bool logToSerial = true, unsigned int maxLog = 1000) : logToSerial(logToSerial), maxLog(maxLog) {}
@@ -15,4 +18,7 @@ class Logger {
         void println(String str);
         void println(const char c[]);
         String getLog();
+        uint32_t getWritten() { return written; }
+        uint32_t getOldest() { return written - log.length(); }
+        size_t read(uint32_t &cursor, uint8_t *buf, size_t maxLen);
 };
\ No newline at end of file
@@ -0,0 +1,279 @@
+#include "Scheduler.h"
+
+Scheduler::Scheduler()
+{
+    for(byte i = 0; i < SCHEDULER_MAX_TASKS; i++)
+    {
+        tasks[i].isUsed = false;
+        tasks[i].isActive = false;
+    }
+}
+
+TaskId Scheduler::every(const char *name, unsigned long interval, TaskCallback callback)
+{
+    return add(name, interval, true, callback);
+}
+
+TaskId Scheduler::after(const char *name, unsigned long delay, TaskCallback callback)
+{
+    return add(name, delay, false, callback);
+}
+
+TaskId Scheduler::add(const char *name, unsigned long interval, bool isPeriodic, TaskCallback callback)
+{
+    // a periodic task without an interval would always be due and handle() would never return
+    if(isPeriodic && interval == 0)
+    {
+        return -1;
+    }
+
+    for(byte i = 0; i < SCHEDULER_MAX_TASKS; i++)
+    {
+        taskInfo &task = tasks[i];
+        if(task.isUsed)
+        {
+            continue;
+        }
+
+        task.name = name;
+        task.callback = callback;
+        task.interval = interval;
+        task.deadline = millis() + interval;
+        task.isPeriodic = isPeriodic;
+        task.isUsed = true;
+        task.isActive = true;
+        task.isEnabled = true;
+        task.runs = 0;
+        task.totalMicros = 0;
+        task.maxMicros = 0;
+        push(i);
+
+        return i;
+    }
+
+    return -1;
+}
+
+void Scheduler::cancel(TaskId id)
+{
+    // removed from the heap when it reaches the top
+    if(id >= 0 && id < SCHEDULER_MAX_TASKS)
+    {
+        tasks[id].isActive = false;
+    }
+}
+
+void Scheduler::setEnabled(TaskId id, bool isEnabled)
+{
+    if(id >= 0 && id < SCHEDULER_MAX_TASKS)
+    {
+        tasks[id].isEnabled = isEnabled;
+    }
+}
+
+bool IRAM_ATTR Scheduler::defer(DeferredCallback callback, void *arg)
+{
+    bool result = false;
+
+    noInterrupts();
+    byte next = (deferredHead + 1) % SCHEDULER_MAX_DEFERRED;
+    if(next != deferredTail)
+    {
+        deferred[deferredHead].callback = callback;
+        deferred[deferredHead].arg = arg;
+        deferredHead = next;
+        result = true;
+    }
+    else
+    {
+        deferredDropped++;
+    }
+    interrupts();
+
+    return result;
+}
+
+void Scheduler::handle()
+{
+    runDeferred();
+
+    unsigned long now = millis();
+    while(heapSize > 0)
+    {
+        byte i = heap[0];
+        taskInfo &task = tasks[i];
+
+        if(!task.isActive)
+        {
+            pop();
+            task.isUsed = false;
+            continue;
+        }
+
+        if((long)(task.deadline - now) > 0)
+        {
+            break;
+        }
+
+        pop();
+        if(task.isEnabled)
+        {
+            run(task);
+        }
+
+        if(task.isPeriodic && task.isActive)
+        {
+            task.deadline += task.interval;
+            if((long)(task.deadline - now) <= 0)
+            {
+                // missed periods are skipped rather than run back to back
+                task.deadline = now + task.interval;
+            }
+            push(i);
+        }
+        else
+        {
+            task.isActive = false;
+            task.isUsed = false;
+        }
+    }
+}
+
+void Scheduler::run(taskInfo &task)
+{
+    unsigned long start = micros();
+    task.callback();
+    uint32_t duration = micros() - start;
+
+    task.runs++;
+    task.totalMicros += duration;
+    if(duration > task.maxMicros)
+    {
+        task.maxMicros = duration;
+    }
+}
+
+void Scheduler::runDeferred()
+{
+    while(deferredTail != deferredHead)
+    {
+        deferredWork work = deferred[deferredTail];
+        deferredTail = (deferredTail + 1) % SCHEDULER_MAX_DEFERRED;
+        work.callback(work.arg);
+    }
+}
+
+unsigned long Scheduler::timeToNext()
+{
+    if(deferredTail != deferredHead)
+    {
+        return 0;
+    }
+
+    if(heapSize == 0)
+    {
+        return SCHEDULER_MAX_SLEEP;
+    }
+
+    // cancelled tasks are dropped on the next handle()
+    taskInfo &next = tasks[heap[0]];
+    if(!next.isActive)
+    {
+        return 0;
+    }
+
+    long wait = (long)(next.deadline - millis());
+    return wait > 0 ? wait : 0;
+}
+
+void Scheduler::sleep()
+{
+    unsigned long wait = timeToNext();
+    if(wait > SCHEDULER_MAX_SLEEP)
+    {
+        wait = SCHEDULER_MAX_SLEEP;
+    }
+
+    if(wait > 0)
+    {
+        delay(wait);
+    }
+}
+
+bool Scheduler::isBefore(byte a, byte b)
+{
+    return (long)(tasks[a].deadline - tasks[b].deadline) < 0;
+}
+
+void Scheduler::push(byte task)
+{
+    byte i = heapSize++;
+    heap[i] = task;
+
+    while(i > 0)
+    {
+        byte parent = (i - 1) / 2;
+        if(!isBefore(heap[i], heap[parent]))
+        {
+            break;
+        }
+
+        byte tmp = heap[i];
+        heap[i] = heap[parent];
+        heap[parent] = tmp;
+        i = parent;
+    }
+}
+
+void Scheduler::pop()
+{
+    heap[0] = heap[--heapSize];
+
+    byte i = 0;
+    while(true)
+    {
+        byte left = i * 2 + 1;
+        byte right = left + 1;
+        byte smallest = i;
+
+        if(left < heapSize && isBefore(heap[left], heap[smallest]))
+        {
+            smallest = left;
+        }
+
+        if(right < heapSize && isBefore(heap[right], heap[smallest]))
+        {
+            smallest = right;
+        }
+
+        if(smallest == i)
+        {
+            break;
+        }
+
+        byte tmp = heap[i];
+        heap[i] = heap[smallest];
+        heap[smallest] = tmp;
+        i = smallest;
+    }
+}
+
+String Scheduler::getStats()
+{
+    String result = "task runs avg[us] max[us]\n";
+
+    for(byte i = 0; i < SCHEDULER_MAX_TASKS; i++)
+    {
+        taskInfo &task = tasks[i];
+        if(!task.isUsed)
+        {
+            continue;
+        }
+
+        result += String(task.name) + " " + String(task.runs) + " ";
+        result += String(task.runs > 0 ? task.totalMicros / task.runs : 0) + " " + String(task.maxMicros) + "\n";
+    }
+
+    result += "deferred dropped " + String(deferredDropped) + "\n";
+    return result;
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <Arduino.h>
+#include <functional>
+
+#define SCHEDULER_MAX_TASKS 16
+#define SCHEDULER_MAX_DEFERRED 16
+#define SCHEDULER_MAX_SLEEP 50
+
+typedef std::function<void()> TaskCallback;
+typedef void (*DeferredCallback)(void *arg);
+typedef int8_t TaskId;
+
+struct taskInfo
+{
+    const char *name;
+    TaskCallback callback;
+    unsigned long interval;
+    unsigned long deadline;
+    bool isPeriodic;
+    bool isUsed;
+    bool isActive;
+    bool isEnabled;
+    uint32_t runs;
+    uint32_t totalMicros;
+    uint32_t maxMicros;
+};
+
+struct deferredWork
+{
+    DeferredCallback callback;
+    void *arg;
+};
+
+/*
+Cooperative scheduler: tasks are kept in a min-heap of deadlines and run from handle(),
+sleep() waits until the next deadline. defer() can be called from interrupts and network
+callbacks, the work runs on the next handle() in the loop context. every() and after()
+return -1 when the task table is full or a periodic interval is 0.
+*/
+class Scheduler
+{
+    private:
+        taskInfo tasks[SCHEDULER_MAX_TASKS];
+        byte heap[SCHEDULER_MAX_TASKS];
+        byte heapSize = 0;
+        deferredWork deferred[SCHEDULER_MAX_DEFERRED];
+        volatile byte deferredHead = 0;
+        volatile byte deferredTail = 0;
+        uint32_t deferredDropped = 0;
+
+        TaskId add(const char *name, unsigned long interval, bool isPeriodic, TaskCallback callback);
+        bool isBefore(byte a, byte b);
+        void push(byte task);
+        void pop();
+        void run(taskInfo &task);
+        void runDeferred();
+
+    public:
+        Scheduler();
+        TaskId every(const char *name, unsigned long interval, TaskCallback callback);
+        TaskId after(const char *name, unsigned long delay, TaskCallback callback);
+        void cancel(TaskId id);
+        void setEnabled(TaskId id, bool isEnabled);
+        bool defer(DeferredCallback callback, void *arg);
+        void handle();
+        unsigned long timeToNext();
+        void sleep();
+        String getStats();
+};
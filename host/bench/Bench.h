@@ -0,0 +1,99 @@
+#pragma once
+
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include <Sim.h>
+#include <SimHttp.h>
+
+// summary of one measured quantity
+class Samples
+{
+    private:
+        std::vector<double> values;
+
+    public:
+        void add(double value) { values.push_back(value); }
+        size_t count() const { return values.size(); }
+
+        double avg() const
+        {
+            double sum = 0;
+            for(double v : values)
+            {
+                sum += v;
+            }
+            return values.empty() ? 0 : sum / values.size();
+        }
+
+        double percentile(double p) const
+        {
+            if(values.empty())
+            {
+                return 0;
+            }
+
+            std::vector<double> sorted = values;
+            std::sort(sorted.begin(), sorted.end());
+            size_t index = (size_t)(p / 100.0 * (sorted.size() - 1) + 0.5);
+            return sorted[index];
+        }
+
+        double max() const { return values.empty() ? 0 : *std::max_element(values.begin(), values.end()); }
+
+        void print(const char *name, const char *unit) const
+        {
+            printf("  %-32s n=%-6zu avg=%10.1f p95=%10.1f max=%10.1f %s\n", name, count(), avg(), percentile(95), max(), unit);
+        }
+};
+
+// allocations made between construction and print()
+class HeapChurn
+{
+    private:
+        sim::HeapStats start;
+        uint64_t startTime;
+
+    public:
+        HeapChurn() : start(sim::heap()), startTime(sim::now()) {}
+
+        void print(const char *name, size_t operations)
+        {
+            sim::HeapStats end = sim::heap();
+            uint64_t allocations = end.allocations - start.allocations;
+            uint64_t bytes = end.bytes - start.bytes;
+            double seconds = (sim::now() - startTime) / 1e6;
+            printf("  %-32s %8.1f allocs/op %10.1f B/op %10.1f allocs/s  live %+lld B\n", name,
+                operations ? (double)allocations / operations : 0.0,
+                operations ? (double)bytes / operations : 0.0,
+                seconds > 0 ? allocations / seconds : 0.0,
+                (long long)(end.live - start.live));
+        }
+};
+
+inline bool isQuick(int argc, char **argv)
+{
+    for(int i = 1; i < argc; i++)
+    {
+        if(strcmp(argv[i], "--quick") == 0)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+inline int check(bool condition, const char *message)
+{
+    if(!condition)
+    {
+        printf("FAILED: %s\n", message);
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,240 @@
+#include <Arduino.h>
+#include <InverterSimulator.h>
+#include <fstream>
+
+#include "ESBDriver.h"
+#include "Bench.h"
+
+/*
+ESB driver against the simulated inverter: latency and throughput of /params and /stats over
+the 2400 baud link, behaviour with injected serial faults and the mode controller over days
+of simulated sun.
+*/
+
+static IPAddress ip(192, 168, 100, 49);
+static ESBDriver driver(ip, "ssid", "password");
+static InverterSimulator inverter(&Serial);
+
+// time one pass of the sketch loop takes on the device
+static uint64_t loopCost = 1000;
+
+static void loop()
+{
+    driver.handle();
+    sim::advance(loopCost);
+}
+
+static void runFor(uint64_t us)
+{
+    uint64_t end = sim::now() + us;
+    while(sim::now() < end)
+    {
+        loop();
+    }
+}
+
+// requests arrive at random points of the loop when spread over spacing [us], back to back otherwise
+static void measure(const char *path, int requests, uint64_t spacing, Samples &latency, int &invalid, bool (*isValid)(const std::string &))
+{
+    uint64_t start = sim::now();
+    for(int i = 0; i < requests; i++)
+    {
+        uint64_t delay = spacing > 0 ? random(spacing) : 0;
+        sim::HttpResult result = sim::http(80, "GET", path, loop, "", "", 30000000, delay);
+        latency.add(result.latency / 1000.0);
+        invalid += result.status != 200 || !isValid(result.body) ? 1 : 0;
+    }
+
+    if(spacing == 0)
+    {
+        double seconds = (sim::now() - start) / 1e6;
+        printf("  %-32s %.2f requests/s\n", (std::string("GET ") + path + " back to back").c_str(), requests / seconds);
+    }
+}
+
+static bool isParams(const std::string &body)
+{
+    // QPIGS without '(' plus the two CRC bytes, PV power is the last field read by the driver
+    return body.size() >= 104 && body.compare(0, 5, "230.0") == 0 && isdigit(body[97]);
+}
+
+static bool isStats(const std::string &body)
+{
+    // four "NNNNNNNN<crc>" answers joined with '.'
+    return body.size() == 43 && std::all_of(body.begin(), body.begin() + 8, ::isdigit);
+}
+
+int main(int argc, char **argv)
+{
+    bool quick = isQuick(argc, argv);
+    int requests = quick ? 10 : 50;
+    int days = quick ? 2 : 7;
+    int failed = 0;
+
+    // 2024-06-01 00:00 in the driver's UTC+1
+    sim::setEpoch(1717196400);
+    Serial.attach(&inverter);
+    driver.begin();
+    runFor(60000000);
+
+    printf("bench_esb\n");
+
+    printf("protocol\n");
+    {
+        sim::HttpResult params = sim::http(80, "GET", "/params", loop);
+        failed += check(isParams(params.body), "unexpected /params");
+        sim::HttpResult stats = sim::http(80, "GET", "/stats", loop, "", "", 30000000);
+        failed += check(isStats(stats.body), "unexpected /stats");
+        sim::HttpResult sbu = sim::http(80, "GET", "/sbu", loop);
+        failed += check(sbu.body == "ACK" && inverter.getPriority() == InverterSimulator::Sbu, "POP02 rejected");
+        sim::HttpResult sub = sim::http(80, "GET", "/sub", loop);
+        failed += check(sub.body == "ACK" && inverter.getPriority() == InverterSimulator::SolarFirst, "POP01 rejected");
+        failed += check(inverter.getCounters().crcErrors == 0, "inverter saw CRC errors");
+        printf("  %u requests, %u CRC errors, %u unknown\n", inverter.getCounters().requests, inverter.getCounters().crcErrors, inverter.getCounters().unknown);
+    }
+
+    printf("request latency\n");
+    {
+        Samples params;
+        Samples stats;
+        int invalid = 0;
+        measure("/params", requests, 0, params, invalid, isParams);
+        measure("/stats", requests, 0, stats, invalid, isStats);
+        params.print("GET /params back to back", "ms");
+        stats.print("GET /stats back to back", "ms");
+
+        Samples spread;
+        measure("/params", requests * 4, 10000000, spread, invalid, isParams);
+        spread.print("GET /params during polling", "ms");
+        failed += check(invalid == 0, "invalid responses without faults");
+    }
+
+    printf("injected faults\n");
+    {
+        InverterSimulator::Faults faults;
+        faults.dropRate = 0.05;
+        faults.corruptRate = 0.05;
+        faults.nakRate = 0.02;
+        inverter.setFaults(faults);
+        inverter.setLatency(50000, 150000);
+
+        Samples params;
+        Samples stats;
+        int invalid = 0;
+        measure("/params", requests * 4, 10000000, params, invalid, isParams);
+        measure("/stats", requests, 0, stats, invalid, isStats);
+        params.print("GET /params during polling", "ms");
+        stats.print("GET /stats back to back", "ms");
+        const InverterSimulator::Counters &counters = inverter.getCounters();
+        printf("  %u dropped, %u corrupted, %u NAK, %d invalid responses served\n", counters.dropped, counters.corrupted, counters.naks, invalid);
+
+        inverter.setFaults(InverterSimulator::Faults());
+        inverter.setLatency(50000, 20000);
+    }
+
+    printf("mode controller, %d days\n", days);
+    {
+        sim::HttpResult mode = sim::http(80, "GET", "/mode?enabled=1", loop);
+        failed += check(mode.status == 200, "mode not enabled");
+
+        // out of range values are refused whole, unknown arguments do not touch the saved config
+        std::string saved = sim::fsRoot() + MODE_CONFIG_FILE;
+        const char *invalid[] = {"/mode?sbuSoc=300", "/mode?minDwell=-1", "/mode?subPvVoltage=-5", "/mode?sbuPvVoltage=7000", "/mode?subSoc=10&sbuSoc=5"};
+        for(const char *path : invalid)
+        {
+            failed += check(sim::http(80, "GET", path, loop).status == 400, "invalid mode config accepted");
+        }
+        remove(saved.c_str());
+        failed += check(sim::http(80, "GET", "/mode?_=123", loop).status == 200 && !std::ifstream(saved).good(), "mode config saved without a change");
+        mode = sim::http(80, "GET", "/mode?enabled=1", loop);
+        failed += check(mode.body.find("sbuSoc=75\n") != std::string::npos && mode.body.find("minDwell=15\n") != std::string::npos &&
+            std::ifstream(saved).good(), "mode config changed by refused requests");
+
+        inverter.setPvCurve(InverterSimulator::sunnyDays(4000, 5, 21, 0.6, 7));
+        inverter.setLoadCurve(InverterSimulator::constantLoad(700, 300, 7));
+        loopCost = 20000;
+
+        uint32_t changes = inverter.getCounters().priorityChanges;
+        double pvEnergy = inverter.getPvEnergy();
+        double gridEnergy = inverter.getGridEnergy();
+        Samples dwell;
+        double minSoc = 100;
+        uint64_t sbuTime = 0;
+        uint64_t lastChange = 0;
+        InverterSimulator::OutputPriority priority = inverter.getPriority();
+        uint64_t end = sim::now() + days * 86400000000ULL;
+
+        while(sim::now() < end)
+        {
+            uint64_t before = sim::now();
+            loop();
+
+            if(inverter.getPriority() == InverterSimulator::Sbu)
+            {
+                sbuTime += sim::now() - before;
+            }
+
+            if(inverter.getPriority() != priority)
+            {
+                if(lastChange > 0)
+                {
+                    dwell.add((sim::now() - lastChange) / 60e6);
+                }
+                lastChange = sim::now();
+                priority = inverter.getPriority();
+            }
+
+            minSoc = std::min(minSoc, inverter.getSoc());
+        }
+
+        changes = inverter.getCounters().priorityChanges - changes;
+        printf("  %-32s %.1f per day\n", "priority changes", (double)changes / days);
+        dwell.print("time between changes", "min");
+        printf("  %-32s %.1f h per day\n", "in SBU", sbuTime / 3600e6 / days);
+        printf("  %-32s %.1f %%\n", "lowest SOC", minSoc);
+        printf("  %-32s %.1f kWh PV, %.1f kWh utility per day\n", "energy", (inverter.getPvEnergy() - pvEnergy) / 1000 / days,
+            (inverter.getGridEnergy() - gridEnergy) / 1000 / days);
+
+        failed += check(changes >= (uint32_t)days, "mode controller never switched");
+        failed += check(dwell.count() == 0 || dwell.percentile(0) >= 15, "switched within the minimum dwell");
+
+        sim::HttpResult history = sim::http(80, "GET", "/history/days?format=csv", loop);
+        failed += check(std::count(history.body.begin(), history.body.end(), '\n') >= days, "no day energy recorded");
+    }
+
+    printf("refused switches\n");
+    {
+        // conditions for the other work type, an inverter answering NAK to every POP
+        sim::HttpResult workType = sim::http(80, "GET", "/worktype", loop);
+        bool isSbu = workType.body == "sbu";
+        inverter.setPvCurve([isSbu](time_t) { return isSbu ? 0.0 : 4000.0; });
+        inverter.setBattery(4800, isSbu ? 30 : 95);
+        InverterSimulator::Faults faults;
+        faults.isRefusingPop = true;
+        inverter.setFaults(faults);
+
+        uint32_t pops = inverter.getCounters().commands.at("POP");
+        uint64_t longest = 0;
+        uint64_t end = sim::now() + 2 * 3600000000ULL;
+        while(sim::now() < end)
+        {
+            uint64_t before = sim::now();
+            driver.handle();
+            longest = std::max(longest, sim::now() - before);
+            sim::advance(loopCost);
+        }
+
+        pops = inverter.getCounters().commands.at("POP") - pops;
+        printf("  %-32s %u in 2 h\n", "POP attempts", pops);
+        printf("  %-32s %.1f ms\n", "longest handle() while polling", longest / 1000.0);
+        failed += check(pops >= 1 && pops <= 2 * 60 / 15 + 1, "refused switch not retried once per dwell");
+        failed += check(longest < 20000, "handle() blocked on the inverter");
+
+        inverter.setFaults(InverterSimulator::Faults());
+    }
+
+    sim::HeapStats heap = sim::heap();
+    printf("heap peak %lld B, live %lld B, %llu allocations\n", (long long)heap.peak, (long long)heap.live, (unsigned long long)heap.allocations);
+
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,155 @@
+#include <Arduino.h>
+#include <Logger.h>
+#include <TimeService.h>
+#include <Metrics.h>
+
+#include "LightDriver.h"
+#include "Bench.h"
+
+/*
+Fish tank LED driver: latency of its pages and JSON endpoints, heap churn per request and how
+evenly the 100 ms fade steps land on the PWM pin for a given loop cost.
+*/
+
+static TimeService timeService;
+static Logger logger;
+static LightDriver driver(&logger, &timeService);
+static WiFiHandler wifiHandler(&logger, &driver, "ssid", "password");
+static const uint8_t LED_OUTPUT = 5;
+
+// time one pass of the sketch loop takes on the device
+static uint64_t loopCost = 1000;
+
+static void loop()
+{
+    METRICS_LOOP();
+    wifiHandler.handle();
+    sim::advance(loopCost);
+}
+
+static void runFor(uint64_t us)
+{
+    uint64_t end = sim::now() + us;
+    while(sim::now() < end)
+    {
+        loop();
+    }
+}
+
+// runs the loop until the PWM pin settles on target and reports the spacing of the fade steps
+static bool measureFade(int target, Samples &steps, uint64_t &duration)
+{
+    sim::clearPinLog();
+    uint64_t start = sim::now();
+    while(sim::pinValue(LED_OUTPUT) != target && sim::now() - start < 60000000)
+    {
+        loop();
+    }
+
+    uint64_t last = start;
+    for(const sim::PinEvent &event : sim::pinLog())
+    {
+        if(event.pin == LED_OUTPUT)
+        {
+            steps.add((event.time - last) / 1000.0);
+            last = event.time;
+        }
+    }
+
+    duration = last - start;
+    return sim::pinValue(LED_OUTPUT) == target;
+}
+
+int main(int argc, char **argv)
+{
+    bool quick = isQuick(argc, argv);
+    int requests = quick ? 20 : 200;
+    int failed = 0;
+
+    // 12:00 in Warsaw, inside the lighting hours
+    sim::setEpoch(1699959600);
+    wifiHandler.setup();
+    timeService.begin();
+    runFor(1000000);
+
+    printf("bench_fishtank\n");
+
+    printf("request latency\n");
+    const char *paths[] = {"/", "/log", "/metrics"};
+    for(const char *path : paths)
+    {
+        Samples latency;
+        Samples wall;
+        HeapChurn churn;
+        for(int i = 0; i < requests; i++)
+        {
+            sim::HttpResult result = sim::http(80, "GET", path, loop);
+            failed += check(result.status == 200, "request failed");
+            latency.add(result.latency);
+            wall.add(result.wall / 1000.0);
+        }
+
+        std::string name = std::string("GET ") + path;
+        latency.print((name + " virtual").c_str(), "us");
+        wall.print((name + " host").c_str(), "us");
+        churn.print((name + " heap").c_str(), requests);
+    }
+
+    {
+        Samples latency;
+        HeapChurn churn;
+        for(int i = 0; i < requests; i++)
+        {
+            std::string body = "{\"value\":" + std::to_string(100 + i % 100) + "}";
+            sim::HttpResult result = sim::http(80, "POST", "/brightness", loop, body, "application/json");
+            failed += check(result.status == 200, "brightness failed");
+            latency.add(result.latency);
+        }
+
+        latency.print("POST /brightness virtual", "us");
+        churn.print("POST /brightness heap", requests);
+    }
+
+    // brightness 0 keeps the light dark through the timed events, unlike /onoff
+    printf("fade timing\n");
+    sim::http(80, "POST", "/brightness", loop, "{\"value\":255}", "application/json");
+    runFor(30000000);
+    uint64_t costs[] = {100, 1000, 7000};
+    for(uint64_t cost : costs)
+    {
+        loopCost = cost;
+
+        Samples steps;
+        uint64_t fadeOut;
+        uint64_t fadeIn;
+        sim::HttpResult result = sim::http(80, "POST", "/brightness", loop, "{\"value\":0}", "application/json");
+        failed += check(result.status == 200 && measureFade(0, steps, fadeOut), "led did not fade out");
+
+        result = sim::http(80, "POST", "/brightness", loop, "{\"value\":255}", "application/json");
+        failed += check(result.status == 200 && measureFade(255, steps, fadeIn), "led did not fade in");
+
+        std::string name = "step interval, loop " + std::to_string(cost) + " us";
+        steps.print(name.c_str(), "ms");
+        printf("  %-32s %.2f s out, %.2f s in, expected 25.50 s\n", "full range fade", fadeOut / 1e6, fadeIn / 1e6);
+    }
+    loopCost = 1000;
+
+    printf("wifi loss\n");
+    {
+        sim::clearPinLog();
+        uint64_t start = sim::now();
+        sim::wifiDisconnect();
+        runFor(30000000);
+        failed += check(sim::pinValue(LED_OUTPUT) == 0, "led not off without wifi");
+        printf("  %-32s %.2f s\n", "led dark after", (sim::pinLog().back().time - start) / 1e6);
+
+        sim::wifiConnect();
+        runFor(quick ? 90000000 : 120000000);
+        failed += check(sim::pinValue(LED_OUTPUT) == 255, "led not back on after reconnect");
+    }
+
+    sim::HeapStats heap = sim::heap();
+    printf("heap peak %lld B, live %lld B, %llu allocations\n", (long long)heap.peak, (long long)heap.live, (unsigned long long)heap.allocations);
+
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,181 @@
+#include <Arduino.h>
+#include <Logger.h>
+#include <TimeService.h>
+#include <Metrics.h>
+
+#include "LightsDriver.h"
+#include "Bench.h"
+
+/*
+Lights driver: the REST API kept from the synchronous sketch, request latency of its pages and
+how quickly a motion detector lights the auto lights while requests keep coming in.
+*/
+
+static const int leds[] = {5, 4};
+static const int detectors[] = {12};
+static String names[] = {"Plafon", "Glowne"};
+
+static TimeService timeService;
+static Logger logger;
+static LightsDriver driver(&logger, &timeService, leds, 2, detectors, 1, names, "LightsDriverHost");
+static WiFiHandler wifiHandler(&logger, &driver, "ssid", "password");
+
+// time one pass of the sketch loop takes on the device
+static uint64_t loopCost = 1000;
+
+static void loop()
+{
+    METRICS_LOOP();
+    wifiHandler.handle();
+    sim::advance(loopCost);
+}
+
+static void runFor(uint64_t us)
+{
+    uint64_t end = sim::now() + us;
+    while(sim::now() < end)
+    {
+        loop();
+    }
+}
+
+static sim::HttpResult postJson(const char *path, const std::string &body)
+{
+    return sim::http(80, "POST", path, loop, body, "application/json");
+}
+
+int main(int argc, char **argv)
+{
+    bool quick = isQuick(argc, argv);
+    int requests = quick ? 20 : 200;
+    int failed = 0;
+
+    // 22:00 in Warsaw, dark time for the default 7 - 15 settings
+    sim::setEpoch(1699995600);
+    wifiHandler.setup();
+    timeService.begin();
+    runFor(1000000);
+
+    printf("bench_lights\n");
+
+    printf("rest api\n");
+    {
+        sim::HttpResult result = postJson("/brightness", "{\"id\":1,\"value\":120}");
+        failed += check(result.status == 200 && result.response.header("Access-Control-Allow-Origin") == "*", "brightness failed");
+        result = postJson("/onoff", "{\"id\":2,\"value\":1}");
+        failed += check(result.status == 200, "onoff failed");
+        result = sim::http(80, "POST", "/led", loop, "id=2&val=80", "application/x-www-form-urlencoded");
+        failed += check(result.status == 200, "led failed");
+        result = postJson("/onoff?local=1", "{\"id\":9,\"value\":1}");
+        failed += check(result.status == 400, "invalid id accepted");
+        result = postJson("/onoff?local=1", "{\"id\":2,\"value\":0}");
+        failed += check(result.status == 303 && result.response.header("Location") == "/", "local request not redirected");
+        result = postJson("/save", "{\"from\":7,\"to\":15}");
+        failed += check(result.status == 200, "save failed");
+        result = sim::http(80, "OPTIONS", "/auto", loop);
+        failed += check(result.status == 200 && !result.response.header("Access-Control-Allow-Methods").empty(), "options failed");
+        result = sim::http(80, "OPTIONS", "/reset", loop);
+        failed += check(result.status == 200 && result.body.find("Resetting") == std::string::npos, "preflight of /reset reset the device");
+        result = sim::http(80, "OPTIONS", "/ota", loop);
+        failed += check(result.status == 200 && result.body.find("OTA") == std::string::npos, "preflight of /ota enabled OTA");
+        result = sim::http(80, "GET", "/missing", loop);
+        failed += check(result.status == 404, "missing page found");
+
+        runFor(3000000);
+        result = sim::http(80, "GET", "/conf", loop);
+        failed += check(result.status == 200, "conf failed");
+        failed += check(sim::pinValue(leds[0]) == 120 && sim::pinValue(leds[1]) == 0, "leds not at the requested values");
+    }
+
+    printf("request latency\n");
+    const char *paths[] = {"/", "/conf", "/log", "/metrics"};
+    for(const char *path : paths)
+    {
+        Samples latency;
+        Samples wall;
+        HeapChurn churn;
+        for(int i = 0; i < requests; i++)
+        {
+            sim::HttpResult result = sim::http(80, "GET", path, loop);
+            failed += check(result.status == 200, "request failed");
+            latency.add(result.latency);
+            wall.add(result.wall / 1000.0);
+        }
+
+        std::string name = std::string("GET ") + path;
+        latency.print((name + " virtual").c_str(), "us");
+        wall.print((name + " host").c_str(), "us");
+        churn.print((name + " heap").c_str(), requests);
+    }
+
+    // every pass of the loop serves a request, the detector edges are still handled on time
+    printf("motion under load\n");
+    {
+        postJson("/onoff", "{\"id\":1,\"value\":0}");
+        sim::HttpResult result = postJson("/auto", "{\"id\":1,\"value\":1}");
+        failed += check(result.status == 200, "auto failed");
+        runFor(3000000);
+
+        Samples onDelay;
+        Samples offDelay;
+        int served = 0;
+        for(int c = 0; c < (quick ? 3 : 10); c++)
+        {
+            // motion lands anywhere in the loop pass
+            runFor(random(1000000));
+            uint64_t start = sim::now();
+            sim::setDigitalInputEdge(detectors[0], HIGH);
+            while(sim::pinValue(leds[0]) == 0 && sim::now() - start < 10000000)
+            {
+                served += sim::http(80, "GET", "/", loop).status == 200 ? 1 : 0;
+            }
+            failed += check(sim::pinValue(leds[0]) > 0, "motion did not turn the light on");
+            onDelay.add((sim::now() - start) / 1000.0);
+
+            runFor(5000000);
+            sim::setDigitalInputEdge(detectors[0], LOW);
+            start = sim::now();
+            while(sim::pinValue(leds[0]) != 0 && sim::now() - start < 120000000)
+            {
+                served += sim::http(80, "GET", "/conf", loop).status == 200 ? 1 : 0;
+            }
+            failed += check(sim::pinValue(leds[0]) == 0, "light did not go off after the hold time");
+            offDelay.add((sim::now() - start) / 1e6);
+        }
+
+        onDelay.print("motion to light on", "ms");
+        offDelay.print("no motion to light off", "s");
+        printf("  %-32s %d\n", "requests served meanwhile", served);
+    }
+
+    printf("detector noise\n");
+    {
+        // pulses shorter than the debounce time are not motion
+        for(int i = 0; i < 10; i++)
+        {
+            sim::setDigitalInputEdge(detectors[0], HIGH);
+            runFor(5000);
+            sim::setDigitalInputEdge(detectors[0], LOW);
+            runFor(200000);
+        }
+        runFor(1000000);
+        failed += check(sim::pinValue(leds[0]) == 0, "noise turned the light on");
+
+        // a burst longer than the edge queue between two loop passes, the pin level wins
+        for(int i = 0; i < 101; i++)
+        {
+            sim::setDigitalInputEdge(detectors[0], i % 2 == 0 ? HIGH : LOW);
+        }
+        runFor(1000000);
+        failed += check(sim::pinValue(leds[0]) > 0, "light not on after an edge burst");
+        sim::setDigitalInputEdge(detectors[0], LOW);
+        runFor(65000000);
+        failed += check(sim::pinValue(leds[0]) == 0, "light not off after an edge burst");
+        printf("  %-32s ok\n", "short pulses and edge bursts");
+    }
+
+    sim::HeapStats heap = sim::heap();
+    printf("heap peak %lld B, live %lld B, %llu allocations\n", (long long)heap.peak, (long long)heap.live, (unsigned long long)heap.allocations);
+
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,227 @@
+#include <Arduino.h>
+#include <LittleFS.h>
+#include <stdlib.h>
+#include <chrono>
+#include <fstream>
+#include <iterator>
+#include <map>
+
+#include "SerialRecorder.h"
+#include "Bench.h"
+
+/*
+SerialRecorder against its readers: chunks of random length and pace are recorded across
+several files, then decoded back from the blocks on the simulated LittleFS and, when Python is
+available, replayed by tools/replay.py. Both must give back the recorded bytes exactly; the
+decoder also checks every timestamp. A second recording must continue after the newest block,
+and a full filesystem must stop the recording with the failure in its status.
+*/
+
+struct Chunk
+{
+    uint64_t time;
+    std::vector<uint8_t> data;
+};
+
+static uint32_t getVarint(const std::vector<uint8_t> &block, size_t &pos)
+{
+    uint32_t value = 0;
+    for(int shift = 0; pos < block.size(); shift += 7)
+    {
+        uint8_t b = block[pos++];
+        value |= (uint32_t)(b & 0x7F) << shift;
+        if(!(b & 0x80))
+        {
+            break;
+        }
+    }
+
+    return value;
+}
+
+// every valid block of the recording files, by sequence
+static std::map<uint32_t, std::vector<uint8_t>> readBlocks()
+{
+    std::map<uint32_t, std::vector<uint8_t>> blocks;
+    for(int i = 0; i < RECORD_FILES; i++)
+    {
+        std::ifstream file(sim::fsRoot() + RECORD_DIR + "/" + std::to_string(i) + ".bin", std::ios::binary);
+        std::vector<uint8_t> block(RECORD_BLOCK_SIZE);
+        while(file.read((char *)block.data(), RECORD_BLOCK_SIZE))
+        {
+            uint32_t magic, sequence;
+            uint16_t used;
+            memcpy(&magic, block.data(), 4);
+            memcpy(&sequence, block.data() + 4, 4);
+            memcpy(&used, block.data() + 16, 2);
+            if(magic == RECORD_MAGIC && used >= RECORD_HEADER_SIZE && used <= RECORD_BLOCK_SIZE)
+            {
+                blocks[sequence] = std::vector<uint8_t>(block.begin(), block.begin() + used);
+            }
+        }
+    }
+
+    return blocks;
+}
+
+static std::vector<Chunk> decode(const std::map<uint32_t, std::vector<uint8_t>> &blocks)
+{
+    std::vector<Chunk> chunks;
+    for(const auto &entry : blocks)
+    {
+        const std::vector<uint8_t> &block = entry.second;
+        uint64_t now;
+        memcpy(&now, block.data() + 8, 8);
+        size_t pos = RECORD_HEADER_SIZE;
+        while(pos < block.size())
+        {
+            now += getVarint(block, pos);
+            uint32_t length = getVarint(block, pos);
+            Chunk chunk = {now, std::vector<uint8_t>(block.begin() + pos, block.begin() + std::min(pos + length, block.size()))};
+            chunks.push_back(chunk);
+            pos += length;
+        }
+    }
+
+    return chunks;
+}
+
+// chunks split at block ends come back as several records with the same time
+static bool matches(const std::vector<Chunk> &recorded, const std::vector<Chunk> &decoded)
+{
+    size_t r = 0, offset = 0;
+    for(const Chunk &chunk : decoded)
+    {
+        if(r >= recorded.size() || chunk.time != recorded[r].time ||
+            offset + chunk.data.size() > recorded[r].data.size() ||
+            !std::equal(chunk.data.begin(), chunk.data.end(), recorded[r].data.begin() + offset))
+        {
+            return false;
+        }
+
+        offset += chunk.data.size();
+        if(offset == recorded[r].data.size())
+        {
+            r++;
+            offset = 0;
+        }
+    }
+
+    return r == recorded.size() && offset == 0;
+}
+
+static std::vector<uint8_t> replay()
+{
+    std::vector<uint8_t> bytes;
+#if defined(REPLAY_TOOL) && defined(PYTHON)
+    std::string command = std::string(PYTHON) + " " + REPLAY_TOOL + " --speed 0";
+    for(int i = 0; i < RECORD_FILES; i++)
+    {
+        std::string name = sim::fsRoot() + RECORD_DIR + "/" + std::to_string(i) + ".bin";
+        if(std::ifstream(name).good())
+        {
+            command += " " + name;
+        }
+    }
+
+    FILE *out = popen(command.c_str(), "r");
+    if(out)
+    {
+        int c;
+        while((c = fgetc(out)) != EOF)
+        {
+            bytes.push_back(c);
+        }
+        pclose(out);
+    }
+#endif
+    return bytes;
+}
+
+int main()
+{
+    int failed = 0;
+    // ~75 blocks, three of the four files, so nothing is overwritten
+    int count = 2000;
+
+    printf("bench_recorder\n");
+
+    LittleFS.format();
+    srand(1);
+
+    SerialRecorder recorder;
+    failed += check(recorder.start(), "recording did not start");
+
+    std::vector<Chunk> recorded;
+    std::vector<uint8_t> stream;
+    uint64_t now = 1000000;
+    auto start = std::chrono::steady_clock::now();
+    for(int i = 0; i < count; i++)
+    {
+        // bursts of a few us up to pauses of minutes, so every varint width is used
+        now += rand() % 4 == 0 ? rand() % 200000000 : rand() % 3000;
+        Chunk chunk = {now, std::vector<uint8_t>(1 + rand() % 300)};
+        for(uint8_t &b : chunk.data)
+        {
+            b = rand();
+        }
+
+        recorder.add(chunk.data.data(), chunk.data.size(), now);
+        recorded.push_back(chunk);
+        stream.insert(stream.end(), chunk.data.begin(), chunk.data.end());
+    }
+    recorder.stop();
+    auto end = std::chrono::steady_clock::now();
+
+    std::map<uint32_t, std::vector<uint8_t>> blocks = readBlocks();
+    std::vector<Chunk> decoded = decode(blocks);
+    int files = 0;
+    for(int i = 0; i < RECORD_FILES; i++)
+    {
+        files += std::ifstream(sim::fsRoot() + RECORD_DIR + "/" + std::to_string(i) + ".bin").good();
+    }
+
+    printf("  %-32s %d chunks, %zu bytes, %zu blocks in %d files\n", "recorded", count, stream.size(), blocks.size(), files);
+    printf("  %-32s %.1f ns/byte\n", "add and flush (host)", std::chrono::duration<double, std::nano>(end - start).count() / stream.size());
+
+    if(check(!blocks.empty(), "no blocks written"))
+    {
+        return 1;
+    }
+
+    failed += check(files >= 3, "recording did not rotate over files");
+    failed += check(blocks.size() == (--blocks.end())->first + 1, "block sequence has gaps");
+    failed += check(matches(recorded, decoded), "decoded records differ from the recorded chunks");
+
+    std::vector<uint8_t> replayed = replay();
+#if defined(REPLAY_TOOL) && defined(PYTHON)
+    printf("  %-32s %zu bytes\n", "replay.py --speed 0", replayed.size());
+    failed += check(replayed == stream, "replay.py output differs from the recorded bytes");
+#endif
+
+    // a new recording goes to the next file and continues the sequence
+    uint32_t last = (--blocks.end())->first;
+    failed += check(recorder.start(), "second recording did not start");
+    uint8_t data[] = {1, 2, 3};
+    recorder.add(data, sizeof(data), now + 1000);
+    recorder.stop();
+    blocks = readBlocks();
+    failed += check(blocks.count(last + 1) == 1 && blocks.size() == last + 2, "second recording did not continue the sequence");
+
+    // a full filesystem stops the recording and says so instead of counting blocks never stored
+    LittleFS.format();
+    sim::setFsSize(8 * RECORD_BLOCK_SIZE);
+    failed += check(recorder.start(), "recording on a small filesystem did not start");
+    std::vector<uint8_t> chunk(200);
+    for(int i = 0; i < 500 && recorder.isActive(); i++)
+    {
+        recorder.add(chunk.data(), chunk.size(), now + i * 1000);
+    }
+    String status = recorder.list();
+    printf("  %-32s %s", "full filesystem", status.c_str());
+    failed += check(!recorder.isActive(), "recording kept going on a full filesystem");
+    failed += check(status.startsWith("stopped: write failed"), "failed write not reported");
+    failed += check(status.indexOf(String(RECORD_DIR) + "/0.bin " + String(8 * RECORD_BLOCK_SIZE) + "\n") >= 0, "blocks lost before the filesystem was full");
+
+    return failed ? 1 : 0;
+}
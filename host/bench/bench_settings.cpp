@@ -0,0 +1,131 @@
+#include <Arduino.h>
+#include <EEPROM.h>
+
+#include "SettingsStore.h"
+#include "Bench.h"
+
+/*
+SettingsStore with the layout of the ProMini light sketches (2 bytes, 16 slots): EEPROM wear
+over many saves, a corrupted newest slot, a save torn before its CRC and a held button that
+changes the value every 100 ms.
+*/
+
+#define SLOTS 16
+#define SIZE 2
+
+struct Settings
+{
+    byte brightness;
+    byte mode;
+};
+
+static uint32_t maxWrites(SettingsStore &store, int address)
+{
+    uint32_t writes = 0;
+    for(int i = address; i < address + store.getLength(); i++)
+    {
+        writes = std::max(writes, EEPROM.getWrites(i));
+    }
+
+    return writes;
+}
+
+static bool loads(int address, byte brightness)
+{
+    SettingsStore store(address, SLOTS, SIZE);
+    Settings settings = {0, 0};
+    return store.load(&settings) && settings.brightness == brightness;
+}
+
+int main()
+{
+    int failed = 0;
+
+    printf("bench_settings\n");
+
+    printf("wear\n");
+    {
+        const int address = 16;
+        const int saves = 1001;
+        SettingsStore store(address, SLOTS, SIZE);
+        Settings settings = {0, 1};
+        failed += check(!store.load(&settings), "erased EEPROM loaded");
+        for(int i = 0; i < saves; i++)
+        {
+            settings.brightness = i;
+            store.save(&settings);
+        }
+
+        uint32_t writes = maxWrites(store, address);
+        printf("  %-32s %d saves, %u writes at most to one byte\n", "16 slots", store.getSaves(), writes);
+        failed += check(store.getSaves() == saves, "saves skipped");
+        // the sequence byte changes on every save of its slot, the rest only when the data does
+        failed += check(writes <= (saves + SLOTS - 1) / SLOTS, "writes not spread over the slots");
+        failed += check(loads(address, (saves - 1) & 0xFF), "last save not loaded");
+    }
+
+    printf("corrupted slot\n");
+    {
+        const int address = 128;
+        SettingsStore store(address, SLOTS, SIZE);
+        Settings settings = {10, 1};
+        store.save(&settings);
+        settings.brightness = 20;
+        store.save(&settings);
+
+        // the newest slot is the second one, flip a data bit
+        int slot = address + SIZE + 2;
+        EEPROM.write(slot + 1, EEPROM.read(slot + 1) ^ 0x01);
+        failed += check(loads(address, 10), "corrupted slot not skipped");
+    }
+
+    printf("torn save\n");
+    {
+        const int address = 256;
+        SettingsStore store(address, SLOTS, SIZE);
+        Settings settings = {30, 1};
+        store.save(&settings);
+
+        // reset after the sequence and data of the next slot, before its CRC
+        int slot = address + SIZE + 2;
+        EEPROM.update(slot, 1);
+        EEPROM.update(slot + 1, 40);
+        EEPROM.update(slot + 2, 1);
+        failed += check(loads(address, 30), "torn save loaded");
+
+        // the next save takes the torn slot and is loaded
+        SettingsStore restarted(address, SLOTS, SIZE);
+        failed += check(restarted.load(&settings), "previous save lost");
+        settings.brightness = 50;
+        failed += check(restarted.save(&settings), "save after the torn one failed");
+        failed += check(loads(address, 50), "save after the torn one not loaded");
+    }
+
+    printf("held button\n");
+    {
+        const int address = 384;
+        SettingsStore store(address, SLOTS, SIZE);
+        Settings settings = {0, 1};
+        int steps = 50;
+        for(int i = 0; i < steps; i++)
+        {
+            settings.brightness += 5;
+            store.changed();
+            store.handle(&settings);
+            delay(100);
+        }
+
+        unsigned long start = millis();
+        while(store.isPending() && millis() - start < 5000)
+        {
+            store.handle(&settings);
+            delay(10);
+        }
+
+        printf("  %-32s %d steps, %u saves after %lu ms\n", "100 ms steps", steps, store.getSaves(), millis() - start);
+        failed += check(store.getSaves() == 1, "held steps not coalesced into one save");
+        failed += check(loads(address, settings.brightness), "final value not saved");
+    }
+
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,193 @@
+#include <Arduino.h>
+#include <WiFiUdp.h>
+#include <Logger.h>
+#include <Scheduler.h>
+#include <Telemetry.h>
+
+#include "Server.h"
+#include "Bench.h"
+
+/*
+High-power socket driver against simulated telemetry: request latency of its pages, heap churn
+of the steady loop and how quickly the load follows the published PV samples.
+*/
+
+static Logger logger;
+static Scheduler scheduler;
+static Server server(&logger, &scheduler, 2000, 1);
+static WiFiHandler wifiHandler(&logger, &server, "ssid", "password");
+static WiFiUDP inverter;
+static uint32_t sequence = 0;
+static const uint8_t LOAD_PIN = 5;
+
+static void loop()
+{
+    METRICS_LOOP();
+    wifiHandler.handle();
+    scheduler.handle();
+    METRICS_LOOP_END();
+    scheduler.sleep();
+}
+
+static void runFor(uint64_t us)
+{
+    uint64_t end = sim::now() + us;
+    while(sim::now() < end)
+    {
+        loop();
+    }
+}
+
+// value of an unlabelled sample in Prometheus text
+static double metricValue(const std::string &body, const std::string &name)
+{
+    size_t pos = body.find("\n" + name + " ");
+    return pos == std::string::npos ? 0 : atof(body.c_str() + pos + name.size() + 2);
+}
+
+// QPIGS answer without the leading '(' as the ESB driver publishes it
+static void publishSample(int pvVoltage, int pvPower, int activePower)
+{
+    char data[128];
+    snprintf(data, sizeof(data), "230.0 50.0 230.0 50.0 %04d %04d 010 400 26.50 010 085 0035 05.0 %03d.0 00.00 00000 00010110 00 00 %05d 010",
+        activePower + 50, activePower, pvVoltage, pvPower);
+
+    char header[32];
+    snprintf(header, sizeof(header), "qpigs %u\n", ++sequence);
+
+    inverter.beginPacketMulticast(IPAddress(239, 255, 100, 1), TELEMETRY_PORT, WiFi.localIP());
+    inverter.write((const uint8_t *)header, strlen(header));
+    inverter.write((const uint8_t *)data, strlen(data));
+    inverter.endPacket();
+}
+
+static uint64_t lastSwitch(int value)
+{
+    const std::vector<sim::PinEvent> &log = sim::pinLog();
+    for(auto it = log.rbegin(); it != log.rend(); ++it)
+    {
+        if(it->pin == LOAD_PIN)
+        {
+            return it->value == value ? it->time : 0;
+        }
+    }
+
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    bool quick = isQuick(argc, argv);
+    int requests = quick ? 20 : 200;
+    int failed = 0;
+
+    wifiHandler.setup();
+    inverter.begin(TELEMETRY_PORT + 1);
+    runFor(1000000);
+
+    printf("bench_socket\n");
+
+    printf("request latency\n");
+    const char *paths[] = {"/", "/tasks", "/metrics", "/log"};
+    for(const char *path : paths)
+    {
+        Samples latency;
+        Samples wall;
+        HeapChurn churn;
+        for(int i = 0; i < requests; i++)
+        {
+            sim::HttpResult result = sim::http(80, "GET", path, loop);
+            failed += check(result.status == 200, "request failed");
+            latency.add(result.latency);
+            wall.add(result.wall / 1000.0);
+        }
+
+        std::string name = std::string("GET ") + path;
+        latency.print((name + " virtual").c_str(), "us");
+        wall.print((name + " host").c_str(), "us");
+        churn.print((name + " heap").c_str(), requests);
+    }
+
+    printf("steady loop\n");
+    {
+        HeapChurn churn;
+        uint64_t seconds = quick ? 60 : 600;
+        for(uint64_t s = 0; s < seconds; s += 10)
+        {
+            publishSample(200, 100, 300);
+            runFor(10000000);
+        }
+        churn.print("loop with telemetry every 10 s", seconds / 10);
+
+        // the scheduler sleep is reported apart from the work of an iteration
+        std::string metrics = sim::http(80, "GET", "/metrics", loop).body;
+        double loopCount = metricValue(metrics, "loop_duration_us_count");
+        double sleepCount = metricValue(metrics, "sleep_duration_us_count");
+        double work = loopCount > 0 ? metricValue(metrics, "loop_duration_us_sum") / loopCount : 0;
+        double sleep = sleepCount > 0 ? metricValue(metrics, "sleep_duration_us_sum") / sleepCount : 0;
+        printf("  %-32s %.0f us work, %.0f us sleep\n", "loop iteration", work, sleep);
+        failed += check(sleepCount > 0 && work < sleep, "loop duration includes the scheduler sleep");
+    }
+
+    printf("load control\n");
+    {
+        // PV comes up well above the load, the socket should follow within the controller's dwell times
+        Samples onDelay;
+        Samples offDelay;
+        int cycles = quick ? 2 : 6;
+        for(int c = 0; c < cycles; c++)
+        {
+            uint64_t start = sim::now();
+            uint64_t deadline = start + 20 * 60 * 1000000ULL;
+            while(lastSwitch(255) < start && sim::now() < deadline)
+            {
+                publishSample(300, 3500, 500);
+                runFor(10000000);
+            }
+            failed += check(lastSwitch(255) >= start, "socket did not turn on");
+            onDelay.add((lastSwitch(255) - start) / 1e6);
+
+            start = sim::now();
+            deadline = start + 20 * 60 * 1000000ULL;
+            while(lastSwitch(0) < start && sim::now() < deadline)
+            {
+                publishSample(220, 200, 2500);
+                runFor(10000000);
+            }
+            failed += check(lastSwitch(0) >= start, "socket did not turn off");
+            offDelay.add((lastSwitch(0) - start) / 1e6);
+        }
+
+        onDelay.print("PV surplus to socket on", "s");
+        offDelay.print("PV drop to socket off", "s");
+    }
+
+    printf("live log\n");
+    {
+        sim::EventStream stream;
+        stream.connect(80, "/log/stream");
+        runFor(500000);
+
+        Samples delay;
+        for(int i = 0; i < (quick ? 5 : 50); i++)
+        {
+            size_t before = stream.events().size();
+            uint64_t start = sim::now();
+            logger.println("bench line " + String(i));
+            while(stream.events().size() == before && sim::now() - start < 5000000)
+            {
+                loop();
+            }
+            uint64_t end = stream.events().size() > before ? stream.eventTimes().back() : sim::now();
+            delay.add((end - start) / 1000.0);
+        }
+
+        delay.print("log line to SSE event", "ms");
+        failed += check(delay.max() < 1000, "log stream too slow");
+    }
+
+    sim::HeapStats heap = sim::heap();
+    printf("heap peak %lld B, live %lld B, %llu allocations\n", (long long)heap.peak, (long long)heap.live, (unsigned long long)heap.allocations);
+
+    return failed ? 1 : 0;
+}
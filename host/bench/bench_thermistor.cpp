@@ -0,0 +1,103 @@
+#include <Arduino.h>
+#include <math.h>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+
+#include "Thermistor.h"
+#include "ThermistorTable.h"
+#include "Bench.h"
+
+/*
+Thermistor table against the calibration log it was generated from: error at every logged
+reading, behaviour over the whole ADC range and the cost of a conversion next to the float
+formula of the playground sketch the log was taken with.
+*/
+
+struct Pair
+{
+    int raw;
+    double celsius;
+};
+
+static std::vector<Pair> readCalibration(const char *path)
+{
+    std::vector<Pair> pairs;
+    std::ifstream file(path);
+    std::string line;
+    while(std::getline(file, line))
+    {
+        if(line.empty() || line[0] == '#')
+        {
+            continue;
+        }
+
+        std::istringstream fields(line);
+        Pair pair;
+        if(fields >> pair.raw >> pair.celsius)
+        {
+            pairs.push_back(pair);
+        }
+    }
+
+    return pairs;
+}
+
+// playground Thermistor2 formula, 10k NTC and 10k divider
+static double steinhart(int raw)
+{
+    double temp = log(10000.0 * ((1024.0 / raw - 1)));
+    temp = 1 / (0.001129148 + (0.000234125 + (0.0000000876741 * temp * temp)) * temp);
+    return temp - 273.15;
+}
+
+template<typename F>
+static double nanosPerCall(F convert, int rounds)
+{
+    volatile double sink = 0;
+    auto start = std::chrono::steady_clock::now();
+    for(int r = 0; r < rounds; r++)
+    {
+        for(int raw = 1; raw < 1024; raw++)
+        {
+            sink = sink + convert(raw);
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() / (rounds * 1023.0);
+}
+
+int main(int argc, char **argv)
+{
+    bool quick = isQuick(argc, argv);
+    int failed = 0;
+
+    printf("bench_thermistor\n");
+
+    std::vector<Pair> pairs = readCalibration(THERMISTOR_CALIBRATION);
+    Samples error;
+    for(const Pair &pair : pairs)
+    {
+        error.add(fabs(Thermistor::toTenths(pair.raw) - pair.celsius * 10));
+    }
+    printf("  %-32s %zu points, %d knots\n", "calibration", pairs.size(), THERMISTOR_POINTS);
+    error.print("error", "tenths");
+
+    bool isMonotonic = true;
+    for(int raw = 1; raw < 1024; raw++)
+    {
+        isMonotonic &= Thermistor::toTenths(raw) >= Thermistor::toTenths(raw - 1);
+    }
+    printf("  %-32s %.1f..%.1f C\n", "range over 0..1023", Thermistor::toTenths(0) / 10.0, Thermistor::toTenths(1023) / 10.0);
+
+    int rounds = quick ? 200 : 5000;
+    printf("  %-32s %.1f ns\n", "table lookup", nanosPerCall([](int raw) { return (double)Thermistor::toTenths(raw); }, rounds));
+    printf("  %-32s %.1f ns\n", "float formula", nanosPerCall(steinhart, rounds));
+
+    failed += check(!pairs.empty(), "calibration log not found");
+    failed += check(error.max() <= 1.0, "table off by more than 0.1C");
+    failed += check(isMonotonic, "conversion is not monotonic");
+    failed += check(THERMISTOR_C(6.0) == 60 && THERMISTOR_C(2.3) == 23 && THERMISTOR_C(-0.5) == -5, "setpoint macro rounds wrong");
+
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,238 @@
+#include <Arduino.h>
+#include <EEPROM.h>
+#include <math.h>
+#include <random>
+
+#include "WateringEngine.h"
+#include "Bench.h"
+
+/*
+WateringEngine on four simulated pots over two weeks, next to the fixed schedule it replaced
+(every pot read every 20 minutes, 10 s of pump above the threshold): wakeups, probe reads,
+pump time, time spent above the threshold and EEPROM wear. Then the learned drying rates and
+gains against the simulated ones, the estimates load() rebuilds from the ring, and a record
+torn by a reset.
+*/
+
+#define POTS 4
+#define FIXED_CHECK 20 // min
+#define FIXED_DOSE 10  // s
+
+// same thresholds and targets as podlewacz
+static const int thresholds[POTS] = {160, 510, 510, 510};
+static const int targets[POTS] = {120, 400, 400, 400};
+
+struct Pot
+{
+    double rate; // reading per minute, on average over a day
+    double gain; // reading per second of pump
+    double moisture;
+};
+
+struct Result
+{
+    int wakeups;
+    int reads;
+    int pumpSeconds;
+    int minutesAbove;
+};
+
+static const Pot pots[POTS] = {{0.02, 4, 120}, {0.08, 10, 400}, {0.04, 6, 400}, {0.15, 12, 400}};
+
+// one minute of drying, faster by day than by night
+static void dry(Pot &pot, int channel, int minute, Result &result)
+{
+    pot.moisture = std::min(1023.0, pot.moisture + pot.rate * (1 + 0.6 * sin(2 * M_PI * minute / 1440)));
+    if(pot.moisture > thresholds[channel])
+    {
+        result.minutesAbove++;
+    }
+}
+
+static int probe(const Pot &pot, std::mt19937 &random)
+{
+    return constrain((int)(pot.moisture + 0.5) + (int)(random() % 7) - 3, 0, 1023);
+}
+
+static void water(Pot &pot, int dose, Result &result)
+{
+    pot.moisture = std::max(0.0, pot.moisture - pot.gain * dose);
+    result.pumpSeconds += dose;
+}
+
+static Result runFixed(Pot simulated[], int days)
+{
+    Result result = {};
+    std::mt19937 random(1);
+    for(int minute = 0; minute < days * 1440; minute++)
+    {
+        if(minute % FIXED_CHECK == 0)
+        {
+            result.wakeups++;
+            for(int i = 0; i < POTS; i++)
+            {
+                result.reads++;
+                if(probe(simulated[i], random) > thresholds[i])
+                {
+                    water(simulated[i], FIXED_DOSE, result);
+                }
+            }
+        }
+
+        for(int i = 0; i < POTS; i++)
+        {
+            dry(simulated[i], i, minute, result);
+        }
+    }
+
+    return result;
+}
+
+// the loop of podlewacz: wake for the earliest due channel, check the due ones
+static Result runEngine(WateringEngine &engine, Pot simulated[], int days)
+{
+    Result result = {};
+    std::mt19937 random(1);
+    unsigned int minutesLeft[POTS] = {};
+    unsigned int minutesSinceCheck[POTS] = {};
+    int minute = 0;
+    while(minute < days * 1440)
+    {
+        result.wakeups++;
+        unsigned int sleep = WATERING_MAX_CHECK;
+        for(int i = 0; i < POTS; i++)
+        {
+            if(minutesLeft[i] == 0)
+            {
+                result.reads++;
+                water(simulated[i], engine.check(i, probe(simulated[i], random), minutesSinceCheck[i]), result);
+                minutesSinceCheck[i] = 0;
+                minutesLeft[i] = engine.nextCheck(i);
+            }
+            sleep = std::min(sleep, minutesLeft[i]);
+        }
+
+        for(int i = 0; i < POTS; i++)
+        {
+            minutesLeft[i] -= sleep;
+            minutesSinceCheck[i] += sleep;
+        }
+
+        for(unsigned int m = 0; m < sleep; m++, minute++)
+        {
+            for(int i = 0; i < POTS; i++)
+            {
+                dry(simulated[i], i, minute, result);
+            }
+        }
+    }
+
+    return result;
+}
+
+static void printResult(const char *name, const Result &result, int days)
+{
+    printf("  %-32s %5d wakeups %6d reads %6d s pump %5.1f %% above threshold\n", name, result.wakeups, result.reads,
+        result.pumpSeconds, 100.0 * result.minutesAbove / (days * 1440 * POTS));
+}
+
+static bool isNear(double value, double expected, double tolerance)
+{
+    return fabs(value - expected) <= tolerance * expected;
+}
+
+static bool isSame(WateringEngine &a, WateringEngine &b, byte channel)
+{
+    return a.getDryingRate(channel) == b.getDryingRate(channel) && a.getGain(channel) == b.getGain(channel) &&
+        a.nextCheck(channel) == b.nextCheck(channel);
+}
+
+int main()
+{
+    int failed = 0;
+    int days = 14;
+
+    printf("bench_watering\n");
+
+    printf("%d days, %d pots\n", days, POTS);
+    Pot fixedPots[POTS] = {pots[0], pots[1], pots[2], pots[3]};
+    Result fixed = runFixed(fixedPots, days);
+    printResult("fixed 20 min checks", fixed, days);
+
+    WateringEngine engine(0, POTS, thresholds, targets);
+    engine.load();
+    Pot enginePots[POTS] = {pots[0], pots[1], pots[2], pots[3]};
+    Result planned = runEngine(engine, enginePots, days);
+    printResult("WateringEngine", planned, days);
+
+    uint32_t maxWrites = 0;
+    for(int i = 0; i < engine.getLength(); i++)
+    {
+        maxWrites = std::max(maxWrites, EEPROM.getWrites(i));
+    }
+    printf("  %-32s %u writes, %u at most to one byte, %.0f years to 100k\n", "EEPROM", engine.getWrites(), maxWrites,
+        100000.0 / maxWrites * days / 365);
+
+    failed += check(planned.wakeups * 2 < fixed.wakeups, "no fewer wakeups than the fixed schedule");
+    failed += check(planned.reads * 4 < fixed.reads, "no fewer probe reads than the fixed schedule");
+    // checks planned at the predicted crossing let pots sit above the threshold for a while, the
+    // drying rate varies over the day and is unknown until learned
+    failed += check(planned.minutesAbove * 10 <= days * 1440 * POTS, "pots above the threshold more than 10 % of the time");
+    failed += check(100000.0 / maxWrites * days / 365 > 10, "EEPROM wears out within 10 years");
+
+    printf("learning\n");
+    WateringEngine loaded(0, POTS, thresholds, targets);
+    loaded.load();
+    for(int i = 0; i < POTS; i++)
+    {
+        // the engine keeps moisture as reading / 4
+        double rate = engine.getDryingRate(i) * 4;
+        double gain = engine.getGain(i) * 4;
+        printf("  pot %d %-26s rate %.3f/min (%.3f) gain %.2f/s (%.2f), after load() %.3f/min %.2f/s\n", i + 1, "",
+            rate, pots[i].rate, gain, pots[i].gain, loaded.getDryingRate(i) * 4, loaded.getGain(i) * 4);
+
+        failed += check(isNear(rate, pots[i].rate, 0.3), "drying rate not learned");
+        failed += check(isNear(gain, pots[i].gain, 0.3), "gain not learned");
+        // the ring keeps the last WATERING_HISTORY checks only, the averages start over from them
+        failed += check(isNear(loaded.getDryingRate(i), engine.getDryingRate(i), 0.5), "load() lost the drying rate");
+        failed += check(isNear(loaded.getGain(i), engine.getGain(i), 0.5), "load() lost the gain");
+        failed += check(loaded.nextCheck(i) > 0, "load() did not find the newest record");
+    }
+
+    printf("torn record\n");
+    {
+        // a ring that has not wrapped yet replays every check, so load() must give the same state
+        const int address = 512;
+        WateringEngine live(address, 1, thresholds + 1, targets + 1);
+        live.load();
+        const int readings[] = {400, 420, 450, 470, 530};
+        const unsigned int minutes[] = {0, 120, 240, 120, 180};
+        byte dose = 0;
+        for(int i = 0; i < 5; i++)
+        {
+            dose = live.check(0, readings[i], minutes[i]);
+        }
+        failed += check(dose > 0, "no dose above the threshold");
+
+        WateringEngine restored(address, 1, thresholds + 1, targets + 1);
+        restored.load();
+        failed += check(isSame(live, restored, 0), "load() differs from the live estimates");
+
+        // reset in the middle of the next record: sequence and moisture written, the rest is not
+        int slot = address + 5 * WATERING_RECORD_SIZE;
+        EEPROM.update(slot, 5);
+        EEPROM.update(slot + 1, 440 >> 2);
+        WateringEngine torn(address, 1, thresholds + 1, targets + 1);
+        torn.load();
+        failed += check(isSame(live, torn, 0), "torn record was replayed");
+        printf("  %-32s rate %.4f gain %.3f next %u min\n", "after the torn record", torn.getDryingRate(0), torn.getGain(0), torn.nextCheck(0));
+
+        // the next check overwrites the torn slot and continues the sequence
+        failed += check(live.check(0, 440, 60) == torn.check(0, 440, 60), "doses differ after the torn record");
+        WateringEngine reloaded(address, 1, thresholds + 1, targets + 1);
+        reloaded.load();
+        failed += check(isSame(live, reloaded, 0) && isSame(torn, reloaded, 0), "sequence did not continue after the torn record");
+    }
+
+    return failed ? 1 : 0;
+}
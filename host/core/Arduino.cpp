@@ -0,0 +1,159 @@
+#include "Arduino.h"
+
+#include <map>
+
+EspClass ESP;
+
+namespace sim
+{
+    void recordPin(uint8_t pin, int value);
+    int readDigitalInput(uint8_t pin);
+    int readAnalogInput(uint8_t pin);
+}
+
+namespace
+{
+    std::map<uint8_t, std::pair<std::function<void()>, int>> &isrs()
+    {
+        // never destroyed, globals still unregister from it at exit
+        static std::map<uint8_t, std::pair<std::function<void()>, int>> *isrs = new std::map<uint8_t, std::pair<std::function<void()>, int>>();
+        return *isrs;
+    }
+}
+
+unsigned long millis()
+{
+    return sim::now() / 1000;
+}
+
+unsigned long micros()
+{
+    return sim::now();
+}
+
+uint64_t micros64()
+{
+    return sim::now();
+}
+
+void delay(unsigned long ms)
+{
+    sim::advance(ms * 1000ULL);
+}
+
+void delayMicroseconds(unsigned int us)
+{
+    sim::advance(us);
+}
+
+void yield()
+{
+    sim::runPending();
+}
+
+void pinMode(uint8_t pin, uint8_t mode)
+{
+}
+
+void digitalWrite(uint8_t pin, uint8_t value)
+{
+    sim::recordPin(pin, value ? HIGH : LOW);
+}
+
+int digitalRead(uint8_t pin)
+{
+    return sim::readDigitalInput(pin);
+}
+
+int analogRead(uint8_t pin)
+{
+    return sim::readAnalogInput(pin);
+}
+
+void analogWrite(uint8_t pin, int value)
+{
+    sim::recordPin(pin, value);
+}
+
+void analogWriteRange(uint32_t range)
+{
+}
+
+void analogWriteFreq(uint32_t freq)
+{
+}
+
+void attachInterrupt(uint8_t pin, std::function<void()> callback, int mode)
+{
+    isrs()[pin] = {callback, mode};
+}
+
+void attachInterruptArg(uint8_t pin, void (*callback)(void *), void *arg, int mode)
+{
+    isrs()[pin] = {[callback, arg]() { callback(arg); }, mode};
+}
+
+void detachInterrupt(uint8_t pin)
+{
+    isrs().erase(pin);
+}
+
+namespace sim
+{
+    void setDigitalInputEdge(uint8_t pin, int value)
+    {
+        int previous = readDigitalInput(pin);
+        setDigitalInput(pin, value);
+
+        auto it = isrs().find(pin);
+        if(it == isrs().end() || previous == value)
+        {
+            return;
+        }
+
+        int mode = it->second.second;
+        if(mode == CHANGE || (mode == RISING && value) || (mode == FALLING && !value))
+        {
+            it->second.first();
+        }
+    }
+}
+
+void noInterrupts()
+{
+}
+
+void interrupts()
+{
+}
+
+long random(long max)
+{
+    return max <= 0 ? 0 : rand() % max;
+}
+
+long random(long min, long max)
+{
+    return min >= max ? min : min + random(max - min);
+}
+
+void randomSeed(unsigned long seed)
+{
+    srand(seed);
+}
+
+long map(long value, long fromLow, long fromHigh, long toLow, long toHigh)
+{
+    return (value - fromLow) * (toHigh - toLow) / (fromHigh - fromLow) + toLow;
+}
+
+void configTzTime(const char *tz, const char *server1, const char *server2, const char *server3)
+{
+    setenv("TZ", tz, 1);
+    tzset();
+}
+
+void configTime(const char *tz, const char *server1, const char *server2, const char *server3)
+{
+    configTzTime(tz, server1, server2, server3);
+}
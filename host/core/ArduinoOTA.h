@@ -0,0 +1,29 @@
+#pragma once
+
+#include "ESP8266WiFi.h"
+
+typedef enum
+{
+    OTA_AUTH_ERROR,
+    OTA_BEGIN_ERROR,
+    OTA_CONNECT_ERROR,
+    OTA_RECEIVE_ERROR,
+    OTA_END_ERROR
+} ota_error_t;
+
+// firmware updates have no meaning on the host, the callbacks are never called
+class ArduinoOTAClass
+{
+    public:
+        void setHostname(const char *hostname) {}
+        void setPassword(const char *password) {}
+        void setPort(uint16_t port) {}
+        void onStart(std::function<void()> fn) {}
+        void onEnd(std::function<void()> fn) {}
+        void onProgress(std::function<void(unsigned int, unsigned int)> fn) {}
+        void onError(std::function<void(ota_error_t)> fn) {}
+        void begin(bool useMDNS = true) {}
+        void handle() {}
+};
+
+inline ArduinoOTAClass ArduinoOTA;
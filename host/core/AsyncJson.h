@@ -0,0 +1,56 @@
+#pragma once
+
+#include <ArduinoJson.h>
+
+#include "ESPAsyncWebServer.h"
+
+#define DYNAMIC_JSON_DOCUMENT_SIZE 1024
+
+typedef std::function<void(AsyncWebServerRequest *request, JsonVariant &json)> ArJsonRequestHandlerFunction;
+
+class AsyncCallbackJsonWebHandler : public AsyncWebHandler
+{
+    private:
+        String uri;
+        WebRequestMethodComposite method = HTTP_POST | HTTP_PUT | HTTP_PATCH;
+        ArJsonRequestHandlerFunction onRequest;
+        size_t maxJsonBufferSize;
+        std::string body;
+
+    public:
+        AsyncCallbackJsonWebHandler(const String &uri, ArJsonRequestHandlerFunction onRequest = nullptr, size_t maxJsonBufferSize = DYNAMIC_JSON_DOCUMENT_SIZE) :
+            uri(uri), onRequest(onRequest), maxJsonBufferSize(maxJsonBufferSize) {}
+
+        void setMethod(WebRequestMethodComposite method) { this->method = method; }
+        void onRequestHandler(ArJsonRequestHandlerFunction fn) { onRequest = fn; }
+
+        bool canHandle(AsyncWebServerRequest *request)
+        {
+            return onRequest && (method & request->method()) && AsyncCallbackWebHandler::matches(uri, request->url()) &&
+                request->contentType().equalsIgnoreCase("application/json");
+        }
+
+        void handleBody(AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total)
+        {
+            if(index == 0)
+            {
+                body.clear();
+            }
+
+            body.append((const char *)data, len);
+        }
+
+        void handleRequest(AsyncWebServerRequest *request)
+        {
+            DynamicJsonDocument doc(maxJsonBufferSize);
+            if(body.empty() || deserializeJson(doc, body))
+            {
+                request->send(500);
+                return;
+            }
+
+            JsonVariant json = doc.as<JsonVariant>();
+            onRequest(request, json);
+            body.clear();
+        }
+};
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <stdint.h>
+
+// same defaults as the CRC library used on the devices: polynome 0x1021, no reflection (XMODEM)
+class CRC16
+{
+    private:
+        uint16_t polynome;
+        uint16_t startMask;
+        uint16_t endMask;
+        bool reverseIn;
+        bool reverseOut;
+        uint16_t crc;
+
+        static uint8_t reverse8(uint8_t in)
+        {
+            uint8_t out = 0;
+            for(int i = 0; i < 8; i++)
+            {
+                out = (out << 1) | ((in >> i) & 1);
+            }
+            return out;
+        }
+
+        static uint16_t reverse16(uint16_t in)
+        {
+            return (reverse8(in & 0xFF) << 8) | reverse8(in >> 8);
+        }
+
+    public:
+        CRC16(uint16_t polynome = 0x1021, uint16_t XORstart = 0, uint16_t XORend = 0, bool reverseIn = false, bool reverseOut = false) :
+            polynome(polynome), startMask(XORstart), endMask(XORend), reverseIn(reverseIn), reverseOut(reverseOut), crc(XORstart) {}
+
+        void restart() { crc = startMask; }
+        void reset() { restart(); }
+
+        void add(uint8_t value)
+        {
+            if(reverseIn)
+            {
+                value = reverse8(value);
+            }
+
+            crc ^= (uint16_t)value << 8;
+            for(int i = 0; i < 8; i++)
+            {
+                crc = crc & 0x8000 ? (crc << 1) ^ polynome : crc << 1;
+            }
+        }
+
+        void add(const uint8_t *array, uint16_t length)
+        {
+            while(length--)
+            {
+                add(*array++);
+            }
+        }
+
+        uint16_t getCRC() const
+        {
+            uint16_t result = reverseOut ? reverse16(crc) : crc;
+            return result ^ endMask;
+        }
+};
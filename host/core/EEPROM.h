@@ -0,0 +1,41 @@
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+
+#define HOST_EEPROM_SIZE 1024
+
+// ATmega328 EEPROM, erased to 0xFF, with the number of writes each byte has taken
+class EEPROMClass
+{
+    private:
+        uint8_t data[HOST_EEPROM_SIZE];
+        uint32_t writes[HOST_EEPROM_SIZE] = {};
+
+    public:
+        EEPROMClass() { memset(data, 0xFF, sizeof(data)); }
+
+        uint8_t read(int address) { return address >= 0 && address < HOST_EEPROM_SIZE ? data[address] : 0xFF; }
+
+        void write(int address, uint8_t value)
+        {
+            if(address >= 0 && address < HOST_EEPROM_SIZE)
+            {
+                data[address] = value;
+                writes[address]++;
+            }
+        }
+
+        void update(int address, uint8_t value)
+        {
+            if(read(address) != value)
+            {
+                write(address, value);
+            }
+        }
+
+        uint16_t length() { return HOST_EEPROM_SIZE; }
+        uint32_t getWrites(int address) { return address >= 0 && address < HOST_EEPROM_SIZE ? writes[address] : 0; }
+};
+
+inline EEPROMClass EEPROM;
@@ -0,0 +1,231 @@
+#include "ESP8266WebServer.h"
+
+#include <strings.h>
+
+namespace
+{
+    HTTPMethod parseMethod(const std::string &method)
+    {
+        if(method == "HEAD") return HTTP_HEAD;
+        if(method == "POST") return HTTP_POST;
+        if(method == "PUT") return HTTP_PUT;
+        if(method == "PATCH") return HTTP_PATCH;
+        if(method == "DELETE") return HTTP_DELETE;
+        if(method == "OPTIONS") return HTTP_OPTIONS;
+        return HTTP_GET;
+    }
+}
+
+void ESP8266WebServer::onData(std::shared_ptr<sim::Connection> connection, const uint8_t *data, size_t len)
+{
+    std::string &buffer = buffers[connection.get()];
+    buffer.append((const char *)data, len);
+
+    sim::HttpMessage message;
+    if(sim::parseHttpRequest(buffer, message))
+    {
+        buffers.erase(connection.get());
+        pending.push_back({connection, message});
+    }
+}
+
+void ESP8266WebServer::handleClient()
+{
+    sim::runPending();
+    if(pending.empty())
+    {
+        return;
+    }
+
+    pendingRequest request = pending.front();
+    pending.pop_front();
+
+    connection = request.connection;
+    current = request.message;
+    currentMethod = parseMethod(current.method);
+    currentArgs.clear();
+    responseHeaders.clear();
+    contentLength = CONTENT_LENGTH_NOT_SET;
+    isChunked = false;
+    isSent = false;
+
+    for(auto &param : current.params)
+    {
+        currentArgs.push_back({String(param.first), String(param.second)});
+    }
+
+    if(strncasecmp(current.header("Content-Type").c_str(), "application/x-www-form-urlencoded", 33) == 0)
+    {
+        std::vector<std::pair<std::string, std::string>> form;
+        sim::parseParams(current.body, form);
+        for(auto &param : form)
+        {
+            currentArgs.push_back({String(param.first), String(param.second)});
+        }
+    }
+    else if(!current.body.empty())
+    {
+        currentArgs.push_back({String("plain"), String(current.body)});
+    }
+
+    THandlerFunction handler = notFoundHandler;
+    for(auto &r : routes)
+    {
+        if(r.uri == current.path.c_str() && (r.method == HTTP_ANY || r.method == currentMethod))
+        {
+            handler = r.handler;
+            break;
+        }
+    }
+
+    if(handler)
+    {
+        handler();
+    }
+    else
+    {
+        send(404, "text/plain", "Not found");
+    }
+
+    finish();
+}
+
+void ESP8266WebServer::finish()
+{
+    if(!connection)
+    {
+        return;
+    }
+
+    if(!isSent)
+    {
+        send(500, "text/plain", "no response");
+    }
+
+    // a chunked response left open is ended by the server when the handler returns
+    if(isChunked)
+    {
+        connection->send(std::string("0\r\n\r\n"));
+    }
+
+    connection->close();
+    connection.reset();
+}
+
+String ESP8266WebServer::arg(const String &name) const
+{
+    for(auto &a : currentArgs)
+    {
+        if(a.first == name)
+        {
+            return a.second;
+        }
+    }
+
+    return String();
+}
+
+bool ESP8266WebServer::hasArg(const String &name) const
+{
+    for(auto &a : currentArgs)
+    {
+        if(a.first == name)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void ESP8266WebServer::sendHeader(const String &name, const String &value, bool first)
+{
+    if(first)
+    {
+        responseHeaders.insert(responseHeaders.begin(), {name, value});
+    }
+    else
+    {
+        responseHeaders.push_back({name, value});
+    }
+}
+
+void ESP8266WebServer::send(int code, const char *contentType, const String &content)
+{
+    if(!connection || isSent)
+    {
+        return;
+    }
+
+    isSent = true;
+    isChunked = contentLength == CONTENT_LENGTH_UNKNOWN;
+
+    std::string head = "HTTP/1.1 " + std::to_string(code) + " " + sim::statusText(code) + "\r\n";
+    head += std::string("Content-Type: ") + (contentType != nullptr ? contentType : "text/html") + "\r\n";
+    for(auto &h : responseHeaders)
+    {
+        head += h.first.str() + ": " + h.second.str() + "\r\n";
+    }
+
+    if(isChunked)
+    {
+        head += "Transfer-Encoding: chunked\r\n";
+    }
+    else
+    {
+        size_t length = contentLength == CONTENT_LENGTH_NOT_SET ? content.length() : contentLength;
+        head += "Content-Length: " + std::to_string(length) + "\r\n";
+    }
+
+    head += "Connection: close\r\n\r\n";
+    connection->send(head);
+
+    if(content.length() > 0)
+    {
+        sendContent(content);
+    }
+}
+
+void ESP8266WebServer::sendContent(const char *content, size_t size)
+{
+    if(!connection)
+    {
+        return;
+    }
+
+    if(!isChunked)
+    {
+        connection->send((const uint8_t *)content, size);
+        return;
+    }
+
+    char len[16];
+    snprintf(len, sizeof(len), "%zx\r\n", size);
+    std::string chunk = len;
+    chunk.append(content, size);
+    chunk += "\r\n";
+    connection->send(chunk);
+
+    if(size == 0)
+    {
+        isChunked = false;
+    }
+}
+
+size_t ESP8266WebServer::streamFile(File &file, const String &contentType)
+{
+    size_t size = file.size();
+    setContentLength(size);
+    send(200, contentType.c_str(), "");
+
+    uint8_t buf[1460];
+    size_t total = 0;
+    size_t len;
+    while((len = file.read(buf, sizeof(buf))) > 0)
+    {
+        sendContent((const char *)buf, len);
+        total += len;
+    }
+
+    return total;
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include "ESP8266WiFi.h"
+#include "SimNet.h"
+#include "FS.h"
+
+enum HTTPMethod
+{
+    HTTP_ANY,
+    HTTP_GET,
+    HTTP_HEAD,
+    HTTP_POST,
+    HTTP_PUT,
+    HTTP_PATCH,
+    HTTP_DELETE,
+    HTTP_OPTIONS
+};
+
+#define CONTENT_LENGTH_UNKNOWN ((size_t)-1)
+#define CONTENT_LENGTH_NOT_SET ((size_t)-2)
+
+// requests queue up on the loopback and are served one per handleClient(), like the real server
+class ESP8266WebServer : public sim::Listener
+{
+    public:
+        typedef std::function<void()> THandlerFunction;
+
+    private:
+        struct route
+        {
+            String uri;
+            HTTPMethod method;
+            THandlerFunction handler;
+        };
+
+        struct pendingRequest
+        {
+            std::shared_ptr<sim::Connection> connection;
+            sim::HttpMessage message;
+        };
+
+        uint16_t port;
+        std::vector<route> routes;
+        THandlerFunction notFoundHandler;
+        std::map<sim::Connection *, std::string> buffers;
+        std::deque<pendingRequest> pending;
+
+        std::shared_ptr<sim::Connection> connection;
+        sim::HttpMessage current;
+        HTTPMethod currentMethod = HTTP_GET;
+        std::vector<std::pair<String, String>> currentArgs;
+        std::vector<std::pair<String, String>> responseHeaders;
+        size_t contentLength = CONTENT_LENGTH_NOT_SET;
+        bool isChunked = false;
+        bool isSent = false;
+
+        void finish();
+
+    public:
+        ESP8266WebServer(int port = 80) : port(port) {}
+        ~ESP8266WebServer() { close(); }
+
+        void begin() { sim::listen(port, this); }
+        void begin(uint16_t port) { this->port = port; begin(); }
+        void close() { sim::unlisten(port, this); }
+        void stop() { close(); }
+        void handleClient();
+
+        void on(const String &uri, THandlerFunction handler) { on(uri, HTTP_ANY, handler); }
+        void on(const String &uri, HTTPMethod method, THandlerFunction fn) { routes.push_back({uri, method, fn}); }
+        void onNotFound(THandlerFunction fn) { notFoundHandler = fn; }
+
+        String uri() const { return String(current.path); }
+        HTTPMethod method() const { return currentMethod; }
+        int args() const { return currentArgs.size(); }
+        String arg(const String &name) const;
+        String arg(int i) const { return i >= 0 && i < (int)currentArgs.size() ? currentArgs[i].second : String(); }
+        String argName(int i) const { return i >= 0 && i < (int)currentArgs.size() ? currentArgs[i].first : String(); }
+        bool hasArg(const String &name) const;
+        String header(const String &name) const { return String(current.header(name.c_str())); }
+        bool hasHeader(const String &name) const { return !current.header(name.c_str()).empty(); }
+
+        void sendHeader(const String &name, const String &value, bool first = false);
+        void setContentLength(size_t contentLength) { this->contentLength = contentLength; }
+        void send(int code, const char *contentType = nullptr, const String &content = String());
+        void send(int code, const String &contentType, const String &content) { send(code, contentType.c_str(), content); }
+        void send_P(int code, const char *contentType, const char *content) { send(code, contentType, String(content)); }
+        void sendContent(const String &content) { sendContent(content.c_str(), content.length()); }
+        void sendContent(const char *content, size_t size);
+        void sendContent_P(const char *content) { sendContent(content, strlen(content)); }
+        size_t streamFile(File &file, const String &contentType);
+
+        void onData(std::shared_ptr<sim::Connection> connection, const uint8_t *data, size_t len);
+        void onClose(std::shared_ptr<sim::Connection> connection) { buffers.erase(connection.get()); }
+};
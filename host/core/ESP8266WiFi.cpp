@@ -0,0 +1,151 @@
+#include "ESP8266WiFi.h"
+
+#include <stdio.h>
+
+ESP8266WiFiClass WiFi;
+
+namespace
+{
+    uint64_t latency = 1000;
+}
+
+bool IPAddress::fromString(const char *address)
+{
+    unsigned int a, b, c, d;
+    if(sscanf(address, "%u.%u.%u.%u", &a, &b, &c, &d) != 4 || a > 255 || b > 255 || c > 255 || d > 255)
+    {
+        return false;
+    }
+
+    bytes[0] = a;
+    bytes[1] = b;
+    bytes[2] = c;
+    bytes[3] = d;
+    return true;
+}
+
+String IPAddress::toString() const
+{
+    char buf[16];
+    snprintf(buf, sizeof(buf), "%u.%u.%u.%u", bytes[0], bytes[1], bytes[2], bytes[3]);
+    return String(buf);
+}
+
+bool ESP8266WiFiClass::config(IPAddress ip, IPAddress gateway, IPAddress subnet, IPAddress dns1, IPAddress dns2)
+{
+    this->ip = ip;
+    this->gateway = gateway;
+    this->subnet = subnet;
+    return true;
+}
+
+wl_status_t ESP8266WiFiClass::begin(const char *ssid, const char *password)
+{
+    this->ssid = ssid;
+    if(!ip.isSet())
+    {
+        ip = IPAddress(192, 168, 100, 50);
+    }
+
+    if(isAvailable)
+    {
+        sim::post(sim::now() + 100000, [this]() {
+            if(this->isAvailable)
+            {
+                setStatus(WL_CONNECTED);
+            }
+        });
+    }
+
+    return wifiStatus;
+}
+
+bool ESP8266WiFiClass::disconnect(bool wifiOff)
+{
+    wifiStatus = WL_DISCONNECTED;
+    return true;
+}
+
+WiFiEventHandler ESP8266WiFiClass::onStationModeConnected(std::function<void(const WiFiEventStationModeConnected &)> handler)
+{
+    WiFiEventHandler result = std::make_shared<WiFiEventHandlerOpaque>();
+    result->onConnected = handler;
+    handlers.push_back(result);
+    return result;
+}
+
+WiFiEventHandler ESP8266WiFiClass::onStationModeDisconnected(std::function<void(const WiFiEventStationModeDisconnected &)> handler)
+{
+    WiFiEventHandler result = std::make_shared<WiFiEventHandlerOpaque>();
+    result->onDisconnected = handler;
+    handlers.push_back(result);
+    return result;
+}
+
+void ESP8266WiFiClass::setStatus(wl_status_t status)
+{
+    bool isConnected = status == WL_CONNECTED;
+    if(isConnected == (wifiStatus == WL_CONNECTED))
+    {
+        wifiStatus = status;
+        return;
+    }
+
+    wifiStatus = status;
+
+    // copied, a handler may register or drop handlers
+    std::vector<std::weak_ptr<WiFiEventHandlerOpaque>> current = handlers;
+    for(auto &weak : current)
+    {
+        WiFiEventHandler handler = weak.lock();
+        if(!handler)
+        {
+            continue;
+        }
+
+        if(isConnected && handler->onConnected)
+        {
+            WiFiEventStationModeConnected event = {ssid, {0}, 1};
+            handler->onConnected(event);
+        }
+        else if(!isConnected && handler->onDisconnected)
+        {
+            WiFiEventStationModeDisconnected event = {ssid, {0}, 8};
+            handler->onDisconnected(event);
+        }
+    }
+}
+
+void ESP8266WiFiClass::setAvailable(bool isAvailable)
+{
+    this->isAvailable = isAvailable;
+    setStatus(isAvailable ? WL_CONNECTED : WL_DISCONNECTED);
+}
+
+namespace sim
+{
+    void setLocalIP(uint8_t a, uint8_t b, uint8_t c, uint8_t d)
+    {
+        WiFi.setLocalIP(IPAddress(a, b, c, d));
+    }
+
+    void setNetworkLatency(uint64_t us)
+    {
+        latency = us;
+    }
+
+    uint64_t getNetworkLatency()
+    {
+        return latency;
+    }
+
+    void wifiDisconnect()
+    {
+        WiFi.setAvailable(false);
+    }
+
+    void wifiConnect()
+    {
+        WiFi.setAvailable(true);
+    }
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "Arduino.h"
+#include "IPAddress.h"
+
+typedef enum
+{
+    WIFI_OFF = 0,
+    WIFI_STA = 1,
+    WIFI_AP = 2,
+    WIFI_AP_STA = 3
+} WiFiMode_t;
+
+typedef enum
+{
+    WIFI_NONE_SLEEP = 0,
+    WIFI_LIGHT_SLEEP = 1,
+    WIFI_MODEM_SLEEP = 2
+} WiFiSleepType_t;
+
+typedef enum
+{
+    WL_IDLE_STATUS = 0,
+    WL_NO_SSID_AVAIL = 1,
+    WL_SCAN_COMPLETED = 2,
+    WL_CONNECTED = 3,
+    WL_CONNECT_FAILED = 4,
+    WL_CONNECTION_LOST = 5,
+    WL_WRONG_PASSWORD = 6,
+    WL_DISCONNECTED = 7
+} wl_status_t;
+
+struct WiFiEventStationModeConnected
+{
+    String ssid;
+    uint8_t bssid[6];
+    uint8_t channel;
+};
+
+struct WiFiEventStationModeDisconnected
+{
+    String ssid;
+    uint8_t bssid[6];
+    uint8_t reason;
+};
+
+struct WiFiEventHandlerOpaque
+{
+    std::function<void(const WiFiEventStationModeConnected &)> onConnected;
+    std::function<void(const WiFiEventStationModeDisconnected &)> onDisconnected;
+};
+
+typedef std::shared_ptr<WiFiEventHandlerOpaque> WiFiEventHandler;
+
+class ESP8266WiFiClass
+{
+    private:
+        WiFiMode_t wifiMode = WIFI_OFF;
+        wl_status_t wifiStatus = WL_IDLE_STATUS;
+        String ssid;
+        IPAddress ip;
+        IPAddress gateway;
+        IPAddress subnet;
+        bool isAvailable = true;
+        std::vector<std::weak_ptr<WiFiEventHandlerOpaque>> handlers;
+
+    public:
+        bool mode(WiFiMode_t mode) { wifiMode = mode; return true; }
+        WiFiMode_t getMode() { return wifiMode; }
+        bool config(IPAddress ip, IPAddress gateway, IPAddress subnet, IPAddress dns1 = IPAddress(), IPAddress dns2 = IPAddress());
+        wl_status_t begin(const char *ssid, const char *password = nullptr);
+        wl_status_t begin(const String &ssid, const String &password) { return begin(ssid.c_str(), password.c_str()); }
+        bool disconnect(bool wifiOff = false);
+        bool reconnect() { begin(ssid.c_str()); return true; }
+        wl_status_t status() { return wifiStatus; }
+        bool isConnected() { return wifiStatus == WL_CONNECTED; }
+        bool setSleepMode(WiFiSleepType_t type) { return true; }
+        bool setAutoReconnect(bool autoReconnect) { return true; }
+        bool hostname(const char *name) { return true; }
+        String SSID() { return ssid; }
+        int32_t RSSI() { return -60; }
+        String macAddress() { return "5C:CF:7F:00:00:01"; }
+        IPAddress localIP() { return ip; }
+        IPAddress gatewayIP() { return gateway; }
+        IPAddress subnetMask() { return subnet; }
+
+        WiFiEventHandler onStationModeConnected(std::function<void(const WiFiEventStationModeConnected &)> handler);
+        WiFiEventHandler onStationModeDisconnected(std::function<void(const WiFiEventStationModeDisconnected &)> handler);
+
+        // host side
+        void setLocalIP(IPAddress ip) { this->ip = ip; }
+        void setStatus(wl_status_t status);
+        void setAvailable(bool isAvailable);
+};
+
+extern ESP8266WiFiClass WiFi;
@@ -0,0 +1,14 @@
+#pragma once
+
+#include "ESP8266WiFi.h"
+
+class MDNSResponder
+{
+    public:
+        bool begin(const char *hostName) { return true; }
+        bool begin(const String &hostName) { return true; }
+        void update() {}
+        bool addService(const char *service, const char *proto, uint16_t port) { return true; }
+};
+
+inline MDNSResponder MDNS;
@@ -0,0 +1,146 @@
+#include "ESPAsyncTCP.h"
+
+class AsyncClient::ClientConnection : public sim::Connection, public std::enable_shared_from_this<ClientConnection>
+{
+    public:
+        std::shared_ptr<handlers> state;
+        sim::Listener *listener;
+        bool open = true;
+
+        ClientConnection(std::shared_ptr<handlers> state, sim::Listener *listener) : state(state), listener(listener) {}
+
+        void send(const uint8_t *data, size_t len)
+        {
+            if(!open)
+            {
+                return;
+            }
+
+            // kept zero terminated, clients tend to read the payload as a C string
+            std::string copy((const char *)data, len);
+            AsyncClient::post(state, [copy](handlers &h) {
+                if(h.onData)
+                {
+                    std::string buffer = copy;
+                    h.onData(h.dataArg, h.client, &buffer[0], copy.size());
+                }
+            });
+        }
+
+        void close()
+        {
+            if(!open)
+            {
+                return;
+            }
+
+            open = false;
+            AsyncClient::post(state, [](handlers &h) {
+                h.isConnected = false;
+                if(h.onDisconnect)
+                {
+                    h.onDisconnect(h.disconnectArg, h.client);
+                }
+            });
+        }
+
+        bool isOpen()
+        {
+            return open;
+        }
+};
+
+AsyncClient::AsyncClient() : state(std::make_shared<handlers>())
+{
+    state->client = this;
+}
+
+AsyncClient::~AsyncClient()
+{
+    state->client = nullptr;
+    if(connection && connection->open)
+    {
+        connection->open = false;
+        sim::Listener *listener = connection->listener;
+        std::shared_ptr<ClientConnection> c = connection;
+        sim::post(sim::now() + sim::getNetworkLatency(), [listener, c]() { listener->onClose(c); });
+    }
+}
+
+void AsyncClient::post(std::shared_ptr<handlers> state, std::function<void(handlers &)> event)
+{
+    sim::post(sim::now() + sim::getNetworkLatency(), [state, event]() {
+        if(state->client != nullptr)
+        {
+            event(*state);
+        }
+    });
+}
+
+bool AsyncClient::connect(IPAddress ip, uint16_t port)
+{
+    sim::Listener *listener = sim::findListener(port);
+    if(listener == nullptr || WiFi.status() != WL_CONNECTED)
+    {
+        post(state, [](handlers &h) {
+            if(h.onError)
+            {
+                h.onError(h.errorArg, h.client, ERR_CONN);
+            }
+        });
+
+        return true;
+    }
+
+    connection = std::make_shared<ClientConnection>(state, listener);
+    post(state, [](handlers &h) {
+        h.isConnected = true;
+        if(h.onConnect)
+        {
+            h.onConnect(h.connectArg, h.client);
+        }
+    });
+
+    return true;
+}
+
+bool AsyncClient::connect(const char *host, uint16_t port)
+{
+    return connect(IPAddress(), port);
+}
+
+void AsyncClient::close(bool now)
+{
+    if(!connection || !connection->open)
+    {
+        return;
+    }
+
+    std::shared_ptr<ClientConnection> c = connection;
+    c->close();
+    sim::post(sim::now() + sim::getNetworkLatency(), [c]() { c->listener->onClose(c); });
+}
+
+size_t AsyncClient::write(const char *data)
+{
+    return write(data, strlen(data));
+}
+
+size_t AsyncClient::write(const char *data, size_t size, uint8_t apiflags)
+{
+    if(!connection || !connection->open)
+    {
+        return 0;
+    }
+
+    std::shared_ptr<ClientConnection> c = connection;
+    std::string copy(data, size);
+    sim::post(sim::now() + sim::getNetworkLatency(), [c, copy]() {
+        if(c->open)
+        {
+            c->listener->onData(c, (const uint8_t *)copy.data(), copy.size());
+        }
+    });
+
+    return size;
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <memory>
+
+#include "ESP8266WiFi.h"
+#include "SimNet.h"
+
+class AsyncClient;
+
+typedef std::function<void(void *, AsyncClient *)> AcConnectHandler;
+typedef std::function<void(void *, AsyncClient *, void *data, size_t len)> AcDataHandler;
+typedef std::function<void(void *, AsyncClient *, int8_t error)> AcErrorHandler;
+typedef std::function<void(void *, AsyncClient *, uint32_t time)> AcTimeoutHandler;
+
+#define ERR_CONN -13
+
+class AsyncClient
+{
+    private:
+        struct handlers
+        {
+            AsyncClient *client;
+            AcConnectHandler onConnect;
+            void *connectArg = nullptr;
+            AcConnectHandler onDisconnect;
+            void *disconnectArg = nullptr;
+            AcDataHandler onData;
+            void *dataArg = nullptr;
+            AcErrorHandler onError;
+            void *errorArg = nullptr;
+            bool isConnected = false;
+        };
+
+        class ClientConnection;
+
+        // shared with posted events, client is cleared when the AsyncClient is deleted
+        std::shared_ptr<handlers> state;
+        std::shared_ptr<ClientConnection> connection;
+
+        static void post(std::shared_ptr<handlers> state, std::function<void(handlers &)> event);
+
+    public:
+        AsyncClient();
+        ~AsyncClient();
+
+        void onConnect(AcConnectHandler cb, void *arg = nullptr) { state->onConnect = cb; state->connectArg = arg; }
+        void onDisconnect(AcConnectHandler cb, void *arg = nullptr) { state->onDisconnect = cb; state->disconnectArg = arg; }
+        void onData(AcDataHandler cb, void *arg = nullptr) { state->onData = cb; state->dataArg = arg; }
+        void onError(AcErrorHandler cb, void *arg = nullptr) { state->onError = cb; state->errorArg = arg; }
+        void onTimeout(AcTimeoutHandler cb, void *arg = nullptr) {}
+
+        bool connect(IPAddress ip, uint16_t port);
+        bool connect(const char *host, uint16_t port);
+        void close(bool now = false);
+        void stop() { close(); }
+        bool connected() { return state->isConnected; }
+        bool canSend() { return state->isConnected; }
+        size_t space() { return 2920; }
+        size_t add(const char *data, size_t size, uint8_t apiflags = 0) { return write(data, size); }
+        bool send() { return true; }
+        size_t write(const char *data);
+        size_t write(const char *data, size_t size, uint8_t apiflags = 0);
+        IPAddress remoteIP() { return IPAddress(127, 0, 0, 1); }
+};
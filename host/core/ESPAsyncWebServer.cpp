@@ -0,0 +1,444 @@
+#include "ESPAsyncWebServer.h"
+
+#include <strings.h>
+
+namespace
+{
+    WebRequestMethod parseMethod(const std::string &method)
+    {
+        if(method == "POST") return HTTP_POST;
+        if(method == "DELETE") return HTTP_DELETE;
+        if(method == "PUT") return HTTP_PUT;
+        if(method == "PATCH") return HTTP_PATCH;
+        if(method == "HEAD") return HTTP_HEAD;
+        if(method == "OPTIONS") return HTTP_OPTIONS;
+        return HTTP_GET;
+    }
+
+    const String empty;
+}
+
+std::string AsyncWebServerResponse::head(bool isChunked, size_t contentLength)
+{
+    std::string result = "HTTP/1.1 " + std::to_string(code) + " " + sim::statusText(code) + "\r\n";
+    if(contentType.length() > 0)
+    {
+        result += "Content-Type: " + contentType.str() + "\r\n";
+    }
+
+    for(auto &header : headers)
+    {
+        result += header.first.str() + ": " + header.second.str() + "\r\n";
+    }
+
+    result += isChunked ? "Transfer-Encoding: chunked\r\n" : "Content-Length: " + std::to_string(contentLength) + "\r\n";
+    result += "Connection: close\r\n\r\n";
+    return result;
+}
+
+std::string AsyncBasicResponse::serialize()
+{
+    return head(false, content.size()) + content;
+}
+
+std::string AsyncChunkedResponse::serialize()
+{
+    std::string result = head(true, 0);
+    uint8_t buffer[1460];
+    size_t index = 0;
+
+    while(true)
+    {
+        size_t len = filler(buffer, sizeof(buffer), index);
+        if(len == RESPONSE_TRY_AGAIN)
+        {
+            continue;
+        }
+
+        char size[16];
+        snprintf(size, sizeof(size), "%zx\r\n", len);
+        result += size;
+        result.append((const char *)buffer, len);
+        result += "\r\n";
+        index += len;
+
+        if(len == 0)
+        {
+            return result;
+        }
+    }
+}
+
+AsyncWebServerRequest::AsyncWebServerRequest(AsyncWebServer *server, std::shared_ptr<sim::Connection> connection, const sim::HttpMessage &message) :
+    server(server), connection(connection), message(message)
+{
+    requestMethod = parseMethod(message.method);
+    requestUrl = String(message.path);
+
+    for(auto &param : message.params)
+    {
+        parameters.push_back(AsyncWebParameter(String(param.first), String(param.second), false));
+    }
+
+    if(strncasecmp(message.header("Content-Type").c_str(), "application/x-www-form-urlencoded", 33) == 0)
+    {
+        std::vector<std::pair<std::string, std::string>> form;
+        sim::parseParams(message.body, form);
+        for(auto &param : form)
+        {
+            parameters.push_back(AsyncWebParameter(String(param.first), String(param.second), true));
+        }
+    }
+}
+
+AsyncWebServerRequest::~AsyncWebServerRequest()
+{
+    if(!isKept)
+    {
+        connection->close();
+    }
+}
+
+const char *AsyncWebServerRequest::methodToString() const
+{
+    switch(requestMethod)
+    {
+        case HTTP_POST: return "POST";
+        case HTTP_DELETE: return "DELETE";
+        case HTTP_PUT: return "PUT";
+        case HTTP_PATCH: return "PATCH";
+        case HTTP_HEAD: return "HEAD";
+        case HTTP_OPTIONS: return "OPTIONS";
+        default: return "GET";
+    }
+}
+
+bool AsyncWebServerRequest::hasParam(const String &name, bool post, bool file) const
+{
+    return getParam(name, post, file) != nullptr;
+}
+
+AsyncWebParameter *AsyncWebServerRequest::getParam(const String &name, bool post, bool file) const
+{
+    for(auto &param : parameters)
+    {
+        if(param.name() == name && param.isPost() == post)
+        {
+            return const_cast<AsyncWebParameter *>(&param);
+        }
+    }
+
+    return nullptr;
+}
+
+AsyncWebParameter *AsyncWebServerRequest::getParam(size_t index) const
+{
+    return index < parameters.size() ? const_cast<AsyncWebParameter *>(&parameters[index]) : nullptr;
+}
+
+bool AsyncWebServerRequest::hasArg(const char *name) const
+{
+    for(auto &param : parameters)
+    {
+        if(param.name() == name)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+const String &AsyncWebServerRequest::arg(const String &name) const
+{
+    for(auto &param : parameters)
+    {
+        if(param.name() == name)
+        {
+            return param.value();
+        }
+    }
+
+    return empty;
+}
+
+const String &AsyncWebServerRequest::arg(size_t index) const
+{
+    return index < parameters.size() ? parameters[index].value() : empty;
+}
+
+const String &AsyncWebServerRequest::argName(size_t index) const
+{
+    return index < parameters.size() ? parameters[index].name() : empty;
+}
+
+void AsyncWebServerRequest::send(AsyncWebServerResponse *response)
+{
+    if(isSent)
+    {
+        delete response;
+        return;
+    }
+
+    isSent = true;
+    connection->send(response->serialize());
+    delete response;
+}
+
+void AsyncWebServerRequest::send(int code, const String &contentType, const String &content)
+{
+    send(beginResponse(code, contentType, content));
+}
+
+void AsyncWebServerRequest::send(FS &fs, const String &path, const String &contentType, bool download)
+{
+    File file = fs.open(path, "r");
+    if(!file)
+    {
+        send(404);
+        return;
+    }
+
+    std::string content(file.size(), 0);
+    file.read((uint8_t *)&content[0], content.size());
+    file.close();
+    send(new AsyncBasicResponse(200, contentType, content));
+}
+
+AsyncWebServerResponse *AsyncWebServerRequest::beginResponse(int code, const String &contentType, const String &content)
+{
+    return new AsyncBasicResponse(code, contentType, content.str());
+}
+
+AsyncWebServerResponse *AsyncWebServerRequest::beginChunkedResponse(const String &contentType, AwsResponseFiller callback)
+{
+    return new AsyncChunkedResponse(contentType, callback);
+}
+
+void AsyncWebServerRequest::redirect(const String &url)
+{
+    AsyncWebServerResponse *response = beginResponse(302);
+    response->addHeader("Location", url);
+    send(response);
+}
+
+bool AsyncCallbackWebHandler::matches(const String &uri, const String &url)
+{
+    if(uri.length() == 0)
+    {
+        return true;
+    }
+
+    if(uri.endsWith("*"))
+    {
+        return url.startsWith(uri.substring(0, uri.length() - 1));
+    }
+
+    return uri == url || url.startsWith(uri + "/");
+}
+
+bool AsyncCallbackWebHandler::canHandle(AsyncWebServerRequest *request)
+{
+    return onRequest && (method & request->method()) && matches(uri, request->url());
+}
+
+void AsyncCallbackWebHandler::handleBody(AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total)
+{
+    if(onBody)
+    {
+        onBody(request, data, len, index, total);
+    }
+}
+
+std::string AsyncEventSource::format(const char *message, const char *event, uint32_t id, uint32_t reconnect)
+{
+    std::string result;
+    if(reconnect)
+    {
+        result += "retry: " + std::to_string(reconnect) + "\r\n";
+    }
+
+    if(id)
+    {
+        result += "id: " + std::to_string(id) + "\r\n";
+    }
+
+    if(event != nullptr)
+    {
+        result += std::string("event: ") + event + "\r\n";
+    }
+
+    std::string data = message != nullptr ? message : "";
+    size_t pos = 0;
+    do
+    {
+        size_t end = data.find_first_of("\r\n", pos);
+        result += "data: " + data.substr(pos, end == std::string::npos ? std::string::npos : end - pos) + "\r\n";
+        if(end == std::string::npos)
+        {
+            break;
+        }
+
+        pos = data[end] == '\r' && end + 1 < data.size() && data[end + 1] == '\n' ? end + 2 : end + 1;
+    } while(pos < data.size());
+
+    return result + "\r\n";
+}
+
+void AsyncEventSourceClient::send(const char *message, const char *event, uint32_t id, uint32_t reconnect)
+{
+    connection->send(AsyncEventSource::format(message, event, id, reconnect));
+}
+
+void AsyncEventSource::prune()
+{
+    for(size_t i = 0; i < clients.size();)
+    {
+        if(clients[i]->connected())
+        {
+            i++;
+        }
+        else
+        {
+            clients.erase(clients.begin() + i);
+        }
+    }
+}
+
+void AsyncEventSource::send(const char *message, const char *event, uint32_t id, uint32_t reconnect)
+{
+    prune();
+    std::string data = format(message, event, id, reconnect);
+    for(auto &client : clients)
+    {
+        client->getConnection()->send(data);
+    }
+}
+
+size_t AsyncEventSource::count()
+{
+    prune();
+    return clients.size();
+}
+
+void AsyncEventSource::close()
+{
+    for(auto &client : clients)
+    {
+        client->close();
+    }
+
+    clients.clear();
+}
+
+bool AsyncEventSource::canHandle(AsyncWebServerRequest *request)
+{
+    return request->method() == HTTP_GET && request->url() == url;
+}
+
+void AsyncEventSource::handleRequest(AsyncWebServerRequest *request)
+{
+    request->keep();
+    request->getConnection()->send(std::string("HTTP/1.1 200 OK\r\nContent-Type: text/event-stream\r\nCache-Control: no-cache\r\nConnection: keep-alive\r\n\r\n"));
+
+    uint32_t lastId = request->hasHeader("Last-Event-ID") ? request->header("Last-Event-ID").toInt() : 0;
+    clients.emplace_back(new AsyncEventSourceClient(this, request->getConnection(), lastId));
+    if(connectHandler)
+    {
+        connectHandler(clients.back().get());
+    }
+}
+
+AsyncWebServer::~AsyncWebServer()
+{
+    end();
+}
+
+void AsyncWebServer::begin()
+{
+    sim::listen(port, this);
+}
+
+void AsyncWebServer::end()
+{
+    sim::unlisten(port, this);
+}
+
+AsyncCallbackWebHandler &AsyncWebServer::on(const char *uri, ArRequestHandlerFunction onRequest)
+{
+    return on(uri, HTTP_ANY, onRequest);
+}
+
+AsyncCallbackWebHandler &AsyncWebServer::on(const char *uri, WebRequestMethodComposite method, ArRequestHandlerFunction onRequest, ArBodyHandlerFunction onBody)
+{
+    AsyncCallbackWebHandler *handler = new AsyncCallbackWebHandler(uri, method, onRequest, onBody);
+    ownedHandlers.emplace_back(handler);
+    handlers.push_back(handler);
+    return *handler;
+}
+
+AsyncWebHandler &AsyncWebServer::addHandler(AsyncWebHandler *handler)
+{
+    handlers.push_back(handler);
+    return *handler;
+}
+
+void AsyncWebServer::onData(std::shared_ptr<sim::Connection> connection, const uint8_t *data, size_t len)
+{
+    std::string &buffer = buffers[connection.get()];
+    buffer.append((const char *)data, len);
+
+    sim::HttpMessage message;
+    if(sim::parseHttpRequest(buffer, message))
+    {
+        buffers.erase(connection.get());
+        dispatch(connection, message);
+    }
+}
+
+void AsyncWebServer::onClose(std::shared_ptr<sim::Connection> connection)
+{
+    buffers.erase(connection.get());
+}
+
+void AsyncWebServer::dispatch(std::shared_ptr<sim::Connection> connection, const sim::HttpMessage &message)
+{
+    AsyncWebServerRequest *request = new AsyncWebServerRequest(this, connection, message);
+
+    // first handler that takes it, in the order they were added
+    AsyncWebHandler *handler = nullptr;
+    for(AsyncWebHandler *h : handlers)
+    {
+        if(h->canHandle(request))
+        {
+            handler = h;
+            break;
+        }
+    }
+
+    if(handler != nullptr)
+    {
+        if(!message.body.empty())
+        {
+            std::string body = message.body;
+            handler->handleBody(request, (uint8_t *)&body[0], body.size(), 0, body.size());
+        }
+
+        handler->handleRequest(request);
+    }
+    else if(notFoundHandler)
+    {
+        notFoundHandler(request);
+    }
+    else
+    {
+        request->send(404);
+    }
+
+    if(!request->isHandled())
+    {
+        request->send(500, "text/plain", "no response");
+    }
+
+    delete request;
+}
@@ -0,0 +1,233 @@
+#pragma once
+
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "ESPAsyncTCP.h"
+#include "FS.h"
+
+typedef enum
+{
+    HTTP_GET = 0b00000001,
+    HTTP_POST = 0b00000010,
+    HTTP_DELETE = 0b00000100,
+    HTTP_PUT = 0b00001000,
+    HTTP_PATCH = 0b00010000,
+    HTTP_HEAD = 0b00100000,
+    HTTP_OPTIONS = 0b01000000,
+    HTTP_ANY = 0b01111111
+} WebRequestMethod;
+
+typedef uint8_t WebRequestMethodComposite;
+
+#define RESPONSE_TRY_AGAIN 0xFFFFFFFF
+
+class AsyncWebServer;
+class AsyncWebServerRequest;
+class AsyncEventSource;
+
+typedef std::function<void(AsyncWebServerRequest *request)> ArRequestHandlerFunction;
+typedef std::function<void(AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total)> ArBodyHandlerFunction;
+typedef std::function<size_t(uint8_t *buffer, size_t maxLen, size_t index)> AwsResponseFiller;
+
+class AsyncWebParameter
+{
+    private:
+        String paramName;
+        String paramValue;
+        bool post;
+
+    public:
+        AsyncWebParameter(const String &name, const String &value, bool post) : paramName(name), paramValue(value), post(post) {}
+        const String &name() const { return paramName; }
+        const String &value() const { return paramValue; }
+        bool isPost() const { return post; }
+        bool isFile() const { return false; }
+};
+
+class AsyncWebServerResponse
+{
+    protected:
+        int code;
+        String contentType;
+        std::vector<std::pair<String, String>> headers;
+
+    public:
+        AsyncWebServerResponse(int code, const String &contentType) : code(code), contentType(contentType) {}
+        virtual ~AsyncWebServerResponse() {}
+        void setCode(int code) { this->code = code; }
+        void addHeader(const String &name, const String &value) { headers.push_back({name, value}); }
+        std::string head(bool isChunked, size_t contentLength);
+        virtual std::string serialize() = 0;
+};
+
+class AsyncBasicResponse : public AsyncWebServerResponse
+{
+    private:
+        std::string content;
+
+    public:
+        AsyncBasicResponse(int code, const String &contentType, const std::string &content) : AsyncWebServerResponse(code, contentType), content(content) {}
+        std::string serialize();
+};
+
+class AsyncChunkedResponse : public AsyncWebServerResponse
+{
+    private:
+        AwsResponseFiller filler;
+
+    public:
+        AsyncChunkedResponse(const String &contentType, AwsResponseFiller filler) : AsyncWebServerResponse(200, contentType), filler(filler) {}
+        std::string serialize();
+};
+
+class AsyncWebServerRequest
+{
+    private:
+        AsyncWebServer *server;
+        std::shared_ptr<sim::Connection> connection;
+        sim::HttpMessage message;
+        std::vector<AsyncWebParameter> parameters;
+        WebRequestMethod requestMethod;
+        String requestUrl;
+        bool isSent = false;
+        bool isKept = false;
+
+    public:
+        void *_tempObject = nullptr;
+
+        AsyncWebServerRequest(AsyncWebServer *server, std::shared_ptr<sim::Connection> connection, const sim::HttpMessage &message);
+        ~AsyncWebServerRequest();
+
+        const String &url() const { return requestUrl; }
+        WebRequestMethodComposite method() const { return requestMethod; }
+        const char *methodToString() const;
+        String contentType() const { return String(message.header("Content-Type")); }
+        size_t contentLength() const { return message.body.size(); }
+        const std::string &body() const { return message.body; }
+
+        size_t params() const { return parameters.size(); }
+        bool hasParam(const String &name, bool post = false, bool file = false) const;
+        AsyncWebParameter *getParam(const String &name, bool post = false, bool file = false) const;
+        AsyncWebParameter *getParam(size_t index) const;
+        size_t args() const { return parameters.size(); }
+        bool hasArg(const char *name) const;
+        const String &arg(const String &name) const;
+        const String &arg(size_t index) const;
+        const String &argName(size_t index) const;
+        bool hasHeader(const String &name) const { return !message.header(name.c_str()).empty(); }
+        String header(const char *name) const { return String(message.header(name)); }
+
+        void send(AsyncWebServerResponse *response);
+        void send(int code, const String &contentType = String(), const String &content = String());
+        void send(FS &fs, const String &path, const String &contentType = String(), bool download = false);
+        AsyncWebServerResponse *beginResponse(int code, const String &contentType = String(), const String &content = String());
+        AsyncWebServerResponse *beginChunkedResponse(const String &contentType, AwsResponseFiller callback);
+        void redirect(const String &url);
+
+        // host side
+        std::shared_ptr<sim::Connection> getConnection() { return connection; }
+        void keep() { isKept = true; }
+        bool isHandled() const { return isSent || isKept; }
+};
+
+class AsyncWebHandler
+{
+    public:
+        virtual ~AsyncWebHandler() {}
+        virtual bool canHandle(AsyncWebServerRequest *request) { return false; }
+        virtual void handleRequest(AsyncWebServerRequest *request) {}
+        virtual void handleBody(AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total) {}
+        virtual bool isRequestHandlerTrivial() { return true; }
+};
+
+class AsyncCallbackWebHandler : public AsyncWebHandler
+{
+    private:
+        String uri;
+        WebRequestMethodComposite method;
+        ArRequestHandlerFunction onRequest;
+        ArBodyHandlerFunction onBody;
+
+    public:
+        AsyncCallbackWebHandler(const String &uri, WebRequestMethodComposite method, ArRequestHandlerFunction onRequest, ArBodyHandlerFunction onBody = nullptr) :
+            uri(uri), method(method), onRequest(onRequest), onBody(onBody) {}
+
+        // same matching as the library, "/log" also takes "/log/live"
+        static bool matches(const String &uri, const String &url);
+        bool canHandle(AsyncWebServerRequest *request);
+        void handleRequest(AsyncWebServerRequest *request) { onRequest(request); }
+        void handleBody(AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total);
+};
+
+class AsyncEventSourceClient
+{
+    private:
+        AsyncEventSource *server;
+        std::shared_ptr<sim::Connection> connection;
+        uint32_t lastEventId;
+
+    public:
+        AsyncEventSourceClient(AsyncEventSource *server, std::shared_ptr<sim::Connection> connection, uint32_t lastId) :
+            server(server), connection(connection), lastEventId(lastId) {}
+
+        void send(const char *message, const char *event = nullptr, uint32_t id = 0, uint32_t reconnect = 0);
+        bool connected() { return connection->isOpen(); }
+        uint32_t lastId() const { return lastEventId; }
+        size_t packetsWaiting() const { return 0; }
+        void close() { connection->close(); }
+        std::shared_ptr<sim::Connection> getConnection() { return connection; }
+};
+
+typedef std::function<void(AsyncEventSourceClient *client)> ArEventHandlerFunction;
+
+class AsyncEventSource : public AsyncWebHandler
+{
+    private:
+        String url;
+        std::vector<std::unique_ptr<AsyncEventSourceClient>> clients;
+        ArEventHandlerFunction connectHandler;
+
+        void prune();
+
+    public:
+        AsyncEventSource(const String &url) : url(url) {}
+
+        void onConnect(ArEventHandlerFunction cb) { connectHandler = cb; }
+        void send(const char *message, const char *event = nullptr, uint32_t id = 0, uint32_t reconnect = 0);
+        size_t count();
+        size_t avgPacketsWaiting() const { return 0; }
+        void close();
+
+        bool canHandle(AsyncWebServerRequest *request);
+        void handleRequest(AsyncWebServerRequest *request);
+
+        static std::string format(const char *message, const char *event, uint32_t id, uint32_t reconnect);
+};
+
+class AsyncWebServer : public sim::Listener
+{
+    private:
+        uint16_t port;
+        std::vector<AsyncWebHandler *> handlers;
+        std::vector<std::unique_ptr<AsyncWebHandler>> ownedHandlers;
+        ArRequestHandlerFunction notFoundHandler;
+        std::map<sim::Connection *, std::string> buffers;
+
+        void dispatch(std::shared_ptr<sim::Connection> connection, const sim::HttpMessage &message);
+
+    public:
+        AsyncWebServer(uint16_t port) : port(port) {}
+        ~AsyncWebServer();
+
+        void begin();
+        void end();
+        AsyncCallbackWebHandler &on(const char *uri, ArRequestHandlerFunction onRequest);
+        AsyncCallbackWebHandler &on(const char *uri, WebRequestMethodComposite method, ArRequestHandlerFunction onRequest, ArBodyHandlerFunction onBody = nullptr);
+        AsyncWebHandler &addHandler(AsyncWebHandler *handler);
+        void onNotFound(ArRequestHandlerFunction fn) { notFoundHandler = fn; }
+
+        void onData(std::shared_ptr<sim::Connection> connection, const uint8_t *data, size_t len);
+        void onClose(std::shared_ptr<sim::Connection> connection);
+};
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "Sim.h"
+
+#define HOST_HEAP_SIZE 48000
+
+// heap figures are the simulated heap size minus what the process has live through new
+class EspClass
+{
+    public:
+        uint32_t getFreeHeap()
+        {
+            int64_t free = HOST_HEAP_SIZE - sim::heap().live;
+            return free > 0 ? free : 0;
+        }
+
+        uint32_t getMaxFreeBlockSize() { return getFreeHeap(); }
+        uint8_t getHeapFragmentation() { return 0; }
+        void getHeapStats(uint32_t *free, uint16_t *max, uint8_t *frag)
+        {
+            *free = getFreeHeap();
+            *max = getMaxFreeBlockSize() > 0xFFFF ? 0xFFFF : getMaxFreeBlockSize();
+            *frag = getHeapFragmentation();
+        }
+
+        uint8_t getCpuFreqMHz() { return 80; }
+        uint32_t getCycleCount() { return (uint32_t)(sim::now() * getCpuFreqMHz()); }
+        uint32_t getChipId() { return 0x00C0FFEE; }
+        void reset() {}
+        void restart() {}
+        void deepSleep(uint64_t time) { sim::advance(time); }
+};
+
+extern EspClass ESP;
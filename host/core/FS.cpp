@@ -0,0 +1,348 @@
+#include "FS.h"
+#include "LittleFS.h"
+
+#include <stdio.h>
+#include <algorithm>
+#include <filesystem>
+
+namespace stdfs = std::filesystem;
+
+FS LittleFS;
+
+namespace fs
+{
+
+// whole 4 KB blocks, like LittleFS
+static size_t usedBytes()
+{
+    size_t used = 0;
+    std::error_code error;
+    for(auto &entry : stdfs::recursive_directory_iterator(sim::fsRoot()))
+    {
+        if(entry.is_regular_file())
+        {
+            used += (entry.file_size(error) + 4095) / 4096 * 4096;
+        }
+    }
+
+    return used;
+}
+
+struct File::handle
+{
+    FILE *file = nullptr;
+    std::string hostPath;
+    String path;
+    String fileName;
+    bool isDirectory = false;
+    std::vector<std::string> entries;
+    size_t nextEntry = 0;
+
+    ~handle()
+    {
+        if(file != nullptr)
+        {
+            fclose(file);
+        }
+    }
+};
+
+File::File(const std::string &hostPath, const String &path, const char *mode) : h(std::make_shared<handle>())
+{
+    h->hostPath = hostPath;
+    h->path = path;
+    h->fileName = path.substring(path.lastIndexOf('/') + 1);
+
+    std::error_code error;
+    if(stdfs::is_directory(hostPath, error))
+    {
+        h->isDirectory = true;
+        for(auto &entry : stdfs::directory_iterator(hostPath))
+        {
+            h->entries.push_back(entry.path().filename().string());
+        }
+        std::sort(h->entries.begin(), h->entries.end());
+        return;
+    }
+
+    std::string m = mode;
+    if(m[0] != 'r')
+    {
+        // LittleFS creates the missing directories on open for writing
+        stdfs::create_directories(stdfs::path(hostPath).parent_path(), error);
+    }
+
+    m += 'b';
+    h->file = fopen(hostPath.c_str(), m.c_str());
+    if(h->file == nullptr)
+    {
+        h.reset();
+    }
+}
+
+size_t File::write(uint8_t c)
+{
+    return write(&c, 1);
+}
+
+size_t File::write(const uint8_t *buf, size_t size)
+{
+    if(!h || !h->file)
+    {
+        return 0;
+    }
+
+    if(sim::isFsSizeSet())
+    {
+        fflush(h->file);
+        if(usedBytes() + size > sim::fsSize())
+        {
+            return 0;
+        }
+    }
+
+    return fwrite(buf, 1, size, h->file);
+}
+
+int File::available()
+{
+    return h && h->file ? size() - position() : 0;
+}
+
+int File::read()
+{
+    uint8_t c;
+    return read(&c, 1) == 1 ? c : -1;
+}
+
+int File::peek()
+{
+    if(!h || !h->file)
+    {
+        return -1;
+    }
+
+    int c = fgetc(h->file);
+    if(c != EOF)
+    {
+        ungetc(c, h->file);
+    }
+
+    return c == EOF ? -1 : c;
+}
+
+size_t File::read(uint8_t *buf, size_t size)
+{
+    return h && h->file ? fread(buf, 1, size, h->file) : 0;
+}
+
+void File::flush()
+{
+    if(h && h->file)
+    {
+        fflush(h->file);
+    }
+}
+
+bool File::seek(uint32_t pos, SeekMode mode)
+{
+    int whence = mode == SeekSet ? SEEK_SET : mode == SeekCur ? SEEK_CUR : SEEK_END;
+    return h && h->file && fseek(h->file, pos, whence) == 0;
+}
+
+size_t File::position() const
+{
+    return h && h->file ? ftell(h->file) : 0;
+}
+
+size_t File::size() const
+{
+    if(!h || !h->file)
+    {
+        return 0;
+    }
+
+    long current = ftell(h->file);
+    fseek(h->file, 0, SEEK_END);
+    long size = ftell(h->file);
+    fseek(h->file, current, SEEK_SET);
+    return size;
+}
+
+void File::close()
+{
+    h.reset();
+}
+
+File::operator bool() const
+{
+    return (bool)h;
+}
+
+const char *File::name() const
+{
+    return h ? h->fileName.c_str() : "";
+}
+
+const char *File::fullName() const
+{
+    return h ? h->path.c_str() : "";
+}
+
+bool File::isFile() const
+{
+    return h && !h->isDirectory;
+}
+
+bool File::isDirectory() const
+{
+    return h && h->isDirectory;
+}
+
+File File::openNextFile()
+{
+    if(!h || !h->isDirectory || h->nextEntry >= h->entries.size())
+    {
+        return File();
+    }
+
+    std::string name = h->entries[h->nextEntry++];
+    String path = h->path.endsWith("/") ? h->path + name.c_str() : h->path + "/" + name.c_str();
+    return File(h->hostPath + "/" + name, path, "r");
+}
+
+Dir::Dir(const std::string &hostPath, const String &path) : hostPath(hostPath), path(path)
+{
+    std::error_code error;
+    if(stdfs::is_directory(hostPath, error))
+    {
+        for(auto &entry : stdfs::directory_iterator(hostPath))
+        {
+            entries.push_back(entry.path().filename().string());
+        }
+        std::sort(entries.begin(), entries.end());
+    }
+}
+
+bool Dir::next()
+{
+    return ++index < (int)entries.size();
+}
+
+String Dir::fileName()
+{
+    return index >= 0 && index < (int)entries.size() ? String(entries[index]) : String();
+}
+
+size_t Dir::fileSize()
+{
+    std::error_code error;
+    return isFile() ? stdfs::file_size(hostPath + "/" + entries[index], error) : 0;
+}
+
+bool Dir::isFile()
+{
+    std::error_code error;
+    return index >= 0 && index < (int)entries.size() && stdfs::is_regular_file(hostPath + "/" + entries[index], error);
+}
+
+bool Dir::isDirectory()
+{
+    std::error_code error;
+    return index >= 0 && index < (int)entries.size() && stdfs::is_directory(hostPath + "/" + entries[index], error);
+}
+
+File Dir::openFile(const char *mode)
+{
+    if(index < 0 || index >= (int)entries.size())
+    {
+        return File();
+    }
+
+    String file = path.endsWith("/") ? path + entries[index].c_str() : path + "/" + entries[index].c_str();
+    return File(hostPath + "/" + entries[index], file, mode);
+}
+
+std::string FS::hostPath(const String &path)
+{
+    std::string p = path.c_str();
+    if(p.empty() || p[0] != '/')
+    {
+        p = "/" + p;
+    }
+
+    return sim::fsRoot() + p;
+}
+
+bool FS::format()
+{
+    std::error_code error;
+    for(auto &entry : stdfs::directory_iterator(sim::fsRoot()))
+    {
+        stdfs::remove_all(entry.path(), error);
+    }
+
+    return true;
+}
+
+bool FS::info(FSInfo &info)
+{
+    info.totalBytes = sim::fsSize();
+    info.usedBytes = usedBytes();
+    info.blockSize = 4096;
+    info.pageSize = 256;
+    info.maxOpenFiles = 5;
+    info.maxPathLength = 32;
+    return true;
+}
+
+File FS::open(const String &path, const char *mode)
+{
+    std::error_code error;
+    std::string p = hostPath(path);
+    if(mode[0] == 'r' && !stdfs::exists(p, error))
+    {
+        return File();
+    }
+
+    return File(p, path, mode);
+}
+
+bool FS::exists(const String &path)
+{
+    std::error_code error;
+    return stdfs::exists(hostPath(path), error);
+}
+
+Dir FS::openDir(const String &path)
+{
+    return Dir(hostPath(path), path);
+}
+
+bool FS::remove(const String &path)
+{
+    std::error_code error;
+    return stdfs::remove(hostPath(path), error);
+}
+
+bool FS::rename(const String &from, const String &to)
+{
+    std::error_code error;
+    stdfs::rename(hostPath(from), hostPath(to), error);
+    return !error;
+}
+
+bool FS::mkdir(const String &path)
+{
+    std::error_code error;
+    stdfs::create_directories(hostPath(path), error);
+    return !error;
+}
+
+bool FS::rmdir(const String &path)
+{
+    std::error_code error;
+    return stdfs::remove(hostPath(path), error);
+}
+
+}
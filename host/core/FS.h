@@ -0,0 +1,114 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Arduino.h"
+
+namespace fs
+{
+
+enum SeekMode
+{
+    SeekSet = 0,
+    SeekCur = 1,
+    SeekEnd = 2
+};
+
+struct FSInfo
+{
+    size_t totalBytes;
+    size_t usedBytes;
+    size_t blockSize;
+    size_t pageSize;
+    size_t maxOpenFiles;
+    size_t maxPathLength;
+};
+
+class File : public Stream
+{
+    private:
+        struct handle;
+        std::shared_ptr<handle> h;
+
+    public:
+        File() {}
+        File(const std::string &hostPath, const String &path, const char *mode);
+
+        size_t write(uint8_t c);
+        size_t write(const uint8_t *buf, size_t size);
+        using Print::write;
+        int available();
+        int read();
+        int peek();
+        size_t read(uint8_t *buf, size_t size);
+        void flush();
+        bool seek(uint32_t pos, SeekMode mode = SeekSet);
+        size_t position() const;
+        size_t size() const;
+        void close();
+        operator bool() const;
+        const char *name() const;
+        const char *fullName() const;
+        bool isFile() const;
+        bool isDirectory() const;
+        File openNextFile();
+};
+
+class Dir
+{
+    private:
+        std::string hostPath;
+        String path;
+        std::vector<std::string> entries;
+        int index = -1;
+
+    public:
+        Dir() {}
+        Dir(const std::string &hostPath, const String &path);
+        bool next();
+        String fileName();
+        size_t fileSize();
+        bool isFile();
+        bool isDirectory();
+        File openFile(const char *mode);
+};
+
+// LittleFS on a directory of the host, see sim::fsRoot()
+class FS
+{
+    private:
+        std::string hostPath(const String &path);
+
+    public:
+        bool begin() { return true; }
+        void end() {}
+        bool format();
+        bool info(FSInfo &info);
+        File open(const String &path, const char *mode);
+        File open(const char *path, const char *mode) { return open(String(path), mode); }
+        bool exists(const String &path);
+        bool exists(const char *path) { return exists(String(path)); }
+        Dir openDir(const String &path);
+        Dir openDir(const char *path) { return openDir(String(path)); }
+        bool remove(const String &path);
+        bool remove(const char *path) { return remove(String(path)); }
+        bool rename(const String &from, const String &to);
+        bool rename(const char *from, const char *to) { return rename(String(from), String(to)); }
+        bool mkdir(const String &path);
+        bool mkdir(const char *path) { return mkdir(String(path)); }
+        bool rmdir(const String &path);
+        bool rmdir(const char *path) { return rmdir(String(path)); }
+};
+
+}
+
+using fs::File;
+using fs::Dir;
+using fs::FS;
+using fs::SeekMode;
+using fs::SeekSet;
+using fs::SeekCur;
+using fs::SeekEnd;
+using fs::FSInfo;
@@ -0,0 +1,110 @@
+#include "HardwareSerial.h"
+#include "Sim.h"
+
+#include <stdio.h>
+
+HardwareSerial Serial;
+
+void HardwareSerial::pump()
+{
+    sim::runPending();
+
+    while(!pending.empty() && pending.front().time <= sim::now())
+    {
+        if(buffer.size() < rxBufferSize)
+        {
+            buffer.push_back(pending.front().value);
+        }
+        else
+        {
+            overrun = true;
+        }
+
+        pending.pop_front();
+    }
+}
+
+int HardwareSerial::available()
+{
+    pump();
+    return buffer.size();
+}
+
+int HardwareSerial::read()
+{
+    pump();
+    if(buffer.empty())
+    {
+        return -1;
+    }
+
+    uint8_t c = buffer.front();
+    buffer.pop_front();
+    return c;
+}
+
+int HardwareSerial::peek()
+{
+    pump();
+    return buffer.empty() ? -1 : buffer.front();
+}
+
+size_t HardwareSerial::write(uint8_t c)
+{
+    // only the tail is kept for takeOutput()
+    if(output.size() >= 65536)
+    {
+        output.erase(0, 32768);
+    }
+    output += (char)c;
+    if(echo)
+    {
+        fputc(c, stdout);
+    }
+
+    uint64_t start = txBusyUntil > sim::now() ? txBusyUntil : sim::now();
+    txBusyUntil = start + getByteTime();
+
+    if(device != nullptr)
+    {
+        SerialDevice *target = device;
+        sim::post(txBusyUntil, [target, c]() { target->onReceive(c); });
+    }
+
+    return 1;
+}
+
+void HardwareSerial::flush()
+{
+    if(txBusyUntil > sim::now())
+    {
+        sim::advance(txBusyUntil - sim::now());
+    }
+}
+
+bool HardwareSerial::hasOverrun()
+{
+    pump();
+    bool result = overrun;
+    overrun = false;
+    return result;
+}
+
+void HardwareSerial::inject(const uint8_t *data, size_t len)
+{
+    uint64_t time = rxBusyUntil > sim::now() ? rxBusyUntil : sim::now();
+    for(size_t i = 0; i < len; i++)
+    {
+        time += getByteTime();
+        pending.push_back({time, data[i]});
+    }
+
+    rxBusyUntil = time;
+}
+
+std::string HardwareSerial::takeOutput()
+{
+    std::string result;
+    result.swap(output);
+    return result;
+}
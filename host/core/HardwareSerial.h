@@ -0,0 +1,63 @@
+#pragma once
+
+#include <deque>
+#include <string>
+
+#include "Stream.h"
+
+#define SERIAL_8N1 0x1c
+
+// other end of the simulated UART, gets every byte once it has been shifted out
+class SerialDevice
+{
+    public:
+        virtual ~SerialDevice() {}
+        virtual void onReceive(uint8_t c) = 0;
+};
+
+class HardwareSerial : public Stream
+{
+    private:
+        struct pendingByte
+        {
+            uint64_t time;
+            uint8_t value;
+        };
+
+        unsigned long baud = 115200;
+        size_t rxBufferSize = 256;
+        std::deque<pendingByte> pending;
+        std::deque<uint8_t> buffer;
+        bool overrun = false;
+        uint64_t txBusyUntil = 0;
+        uint64_t rxBusyUntil = 0;
+        std::string output;
+        SerialDevice *device = nullptr;
+        bool echo = false;
+
+        void pump();
+
+    public:
+        void begin(unsigned long baud, int config = SERIAL_8N1) { this->baud = baud; }
+        void end() {}
+        int available();
+        int read();
+        int peek();
+        size_t write(uint8_t c);
+        using Print::write;
+        void flush();
+        size_t setRxBufferSize(size_t size) { rxBufferSize = size; return size; }
+        bool hasOverrun();
+        unsigned long baudRate() { return baud; }
+        operator bool() { return true; }
+
+        // host side
+        uint64_t getByteTime() { return 10000000ULL / baud; }
+        void inject(const uint8_t *data, size_t len);
+        void inject(const std::string &data) { inject((const uint8_t *)data.c_str(), data.length()); }
+        void attach(SerialDevice *device) { this->device = device; }
+        std::string takeOutput();
+        void setEcho(bool echo) { this->echo = echo; }
+};
+
+extern HardwareSerial Serial;
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "WString.h"
+
+class IPAddress
+{
+    private:
+        uint8_t bytes[4];
+
+    public:
+        IPAddress() : bytes{0, 0, 0, 0} {}
+        IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) : bytes{a, b, c, d} {}
+        IPAddress(uint32_t address) { memcpy(bytes, &address, 4); }
+
+        operator uint32_t() const { uint32_t address; memcpy(&address, bytes, 4); return address; }
+        uint8_t operator[](int index) const { return bytes[index]; }
+        uint8_t &operator[](int index) { return bytes[index]; }
+        bool operator==(const IPAddress &other) const { return memcmp(bytes, other.bytes, 4) == 0; }
+        bool operator!=(const IPAddress &other) const { return !(*this == other); }
+
+        bool isSet() const { return (uint32_t)*this != 0; }
+        bool isMulticast() const { return bytes[0] >= 224 && bytes[0] <= 239; }
+        bool fromString(const char *address);
+        bool fromString(const String &address) { return fromString(address.c_str()); }
+        String toString() const;
+};
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "WiFiUdp.h"
+
+// reads the virtual clock, the epoch is set with sim::setEpoch()
+class NTPClient
+{
+    private:
+        long timeOffset;
+
+    public:
+        NTPClient(WiFiUDP &udp, const char *poolServerName = "pool.ntp.org", long timeOffset = 0, unsigned long updateInterval = 60000) : timeOffset(timeOffset) {}
+
+        void begin() {}
+        void begin(unsigned int port) {}
+        void end() {}
+        bool update() { return true; }
+        bool forceUpdate() { return true; }
+        bool isTimeSet() const { return true; }
+        void setTimeOffset(int timeOffset) { this->timeOffset = timeOffset; }
+        void setUpdateInterval(unsigned long updateInterval) {}
+        void setPoolServerName(const char *poolServerName) {}
+
+        unsigned long getEpochTime() const { return time(nullptr) + timeOffset; }
+        int getDay() const { return ((getEpochTime() / 86400L) + 4) % 7; }
+        int getHours() const { return (getEpochTime() % 86400L) / 3600; }
+        int getMinutes() const { return (getEpochTime() % 3600) / 60; }
+        int getSeconds() const { return getEpochTime() % 60; }
+        String getFormattedTime() const
+        {
+            char buf[9];
+            snprintf(buf, sizeof(buf), "%02d:%02d:%02d", getHours(), getMinutes(), getSeconds());
+            return String(buf);
+        }
+};
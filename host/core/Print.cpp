@@ -0,0 +1,66 @@
+#include "Print.h"
+
+#include <stdarg.h>
+#include <stdio.h>
+
+size_t Print::write(const uint8_t *buffer, size_t size)
+{
+    size_t n = 0;
+    while(size--)
+    {
+        n += write(*buffer++);
+    }
+
+    return n;
+}
+
+size_t Print::printNumber(unsigned long long value, int base, bool negative)
+{
+    if(base == 0)
+    {
+        return write((uint8_t)value);
+    }
+
+    String str((unsigned long long)value, (unsigned char)base);
+    return negative ? print('-') + print(str) : print(str);
+}
+
+size_t Print::print(long value, int base)
+{
+    if(base == DEC && value < 0)
+    {
+        return printNumber(-(unsigned long long)value, base, true);
+    }
+
+    return printNumber(base == DEC ? (unsigned long long)value : (unsigned long)value, base, false);
+}
+
+size_t Print::print(double value, int digits)
+{
+    return print(String(value, (unsigned char)digits));
+}
+
+size_t Print::printf(const char *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    char buf[256];
+    int len = vsnprintf(buf, sizeof(buf), format, args);
+    va_end(args);
+
+    if(len < 0)
+    {
+        return 0;
+    }
+
+    if((size_t)len < sizeof(buf))
+    {
+        return write((const uint8_t *)buf, len);
+    }
+
+    std::string large(len + 1, 0);
+    va_start(args, format);
+    vsnprintf(&large[0], large.size(), format, args);
+    va_end(args);
+    return write((const uint8_t *)large.c_str(), len);
+}
@@ -0,0 +1,239 @@
+#include "Sim.h"
+
+#include <malloc.h>
+#include <stdlib.h>
+#include <filesystem>
+#include <map>
+#include <new>
+
+namespace
+{
+    struct Event
+    {
+        uint64_t time;
+        uint64_t order;
+    };
+
+    bool operator<(const Event &a, const Event &b)
+    {
+        return a.time != b.time ? a.time < b.time : a.order < b.order;
+    }
+
+    uint64_t virtualClock = 0;
+    uint64_t order = 0;
+    int64_t epochBase = 1700000000;
+    std::map<Event, std::function<void()>> &events()
+    {
+        // never destroyed, globals still unregister from it at exit
+        static std::map<Event, std::function<void()>> *events = new std::map<Event, std::function<void()>>();
+        return *events;
+    }
+
+    std::vector<sim::PinEvent> pins;
+    int pinValues[256];
+    int digitalInputs[256];
+    int analogInputs[256];
+
+    sim::HeapStats stats;
+
+    size_t fsBytes = 1024 * 1024;
+    bool isFsLimited = false;
+}
+
+namespace sim
+{
+    uint64_t now()
+    {
+        return virtualClock;
+    }
+
+    void advance(uint64_t us)
+    {
+        uint64_t target = virtualClock + us;
+        while(!events().empty() && events().begin()->first.time <= target)
+        {
+            auto it = events().begin();
+            std::function<void()> event = it->second;
+            if(it->first.time > virtualClock)
+            {
+                virtualClock = it->first.time;
+            }
+            events().erase(it);
+            event();
+        }
+
+        // an event may have delayed past the target itself
+        if(virtualClock < target)
+        {
+            virtualClock = target;
+        }
+    }
+
+    void runPending()
+    {
+        advance(0);
+    }
+
+    void post(uint64_t at, std::function<void()> event)
+    {
+        events()[{at, order++}] = event;
+    }
+
+    void setEpoch(time_t epoch)
+    {
+        epochBase = epoch - (int64_t)(virtualClock / 1000000);
+    }
+
+    const std::vector<PinEvent> &pinLog()
+    {
+        return pins;
+    }
+
+    void clearPinLog()
+    {
+        pins.clear();
+    }
+
+    int pinValue(uint8_t pin)
+    {
+        return pinValues[pin];
+    }
+
+    void setDigitalInput(uint8_t pin, int value)
+    {
+        digitalInputs[pin] = value;
+    }
+
+    void setAnalogInput(uint8_t pin, int value)
+    {
+        analogInputs[pin] = value;
+    }
+
+    HeapStats heap()
+    {
+        return stats;
+    }
+
+    void resetHeapPeak()
+    {
+        stats.peak = stats.live;
+    }
+
+    const std::string &fsRoot()
+    {
+        static std::string root;
+        if(root.empty())
+        {
+            const char *dir = getenv("HOST_FS_DIR");
+            if(dir != nullptr)
+            {
+                root = dir;
+                std::filesystem::create_directories(root);
+            }
+            else
+            {
+                char pattern[] = "/tmp/littlefs-XXXXXX";
+                root = mkdtemp(pattern);
+                atexit([]() { std::filesystem::remove_all(sim::fsRoot()); });
+            }
+        }
+
+        return root;
+    }
+
+    void setFsSize(size_t bytes)
+    {
+        fsBytes = bytes;
+        isFsLimited = true;
+    }
+
+    size_t fsSize()
+    {
+        return fsBytes;
+    }
+
+    bool isFsSizeSet()
+    {
+        return isFsLimited;
+    }
+
+    // used by the core, not part of the harness api
+    void recordPin(uint8_t pin, int value)
+    {
+        pinValues[pin] = value;
+        pins.push_back({virtualClock, pin, value});
+    }
+
+    int readDigitalInput(uint8_t pin)
+    {
+        return digitalInputs[pin];
+    }
+
+    int readAnalogInput(uint8_t pin)
+    {
+        return analogInputs[pin];
+    }
+}
+
+extern "C" time_t time(time_t *t) __THROW
+{
+    time_t result = epochBase + virtualClock / 1000000;
+    if(t != nullptr)
+    {
+        *t = result;
+    }
+
+    return result;
+}
+
+void *operator new(size_t size)
+{
+    void *p = malloc(size ? size : 1);
+    if(p == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+
+    size_t usable = malloc_usable_size(p);
+    stats.allocations++;
+    stats.bytes += usable;
+    stats.live += usable;
+    if(stats.live > stats.peak)
+    {
+        stats.peak = stats.live;
+    }
+
+    return p;
+}
+
+void operator delete(void *p) noexcept
+{
+    if(p == nullptr)
+    {
+        return;
+    }
+
+    stats.frees++;
+    stats.live -= malloc_usable_size(p);
+    free(p);
+}
+
+void *operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete[](void *p) noexcept
+{
+    operator delete(p);
+}
+
+void operator delete(void *p, size_t) noexcept
+{
+    operator delete(p);
+}
+
+void operator delete[](void *p, size_t) noexcept
+{
+    operator delete(p);
+}
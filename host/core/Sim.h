@@ -0,0 +1,67 @@
+#pragma once
+
+#include <stdint.h>
+#include <time.h>
+#include <functional>
+#include <string>
+#include <vector>
+
+/*
+Host side of the simulated core. Drivers only see the Arduino headers, benchmarks use this
+to move the virtual clock, feed inputs and inspect outputs.
+
+Time only moves in advance() (delay() and Stream timeouts end up there), events posted for
+a time are run when the clock reaches it, like the SDK running network callbacks while the
+sketch is in delay().
+*/
+namespace sim
+{
+    // virtual clock [us]
+    uint64_t now();
+    void advance(uint64_t us);
+    void runPending();
+    void post(uint64_t at, std::function<void()> event);
+    void setEpoch(time_t epoch);
+
+    // pins
+    struct PinEvent
+    {
+        uint64_t time;
+        uint8_t pin;
+        int value;
+    };
+
+    const std::vector<PinEvent> &pinLog();
+    void clearPinLog();
+    int pinValue(uint8_t pin);
+    void setDigitalInput(uint8_t pin, int value);
+    void setDigitalInputEdge(uint8_t pin, int value); // also runs an attached interrupt
+    void setAnalogInput(uint8_t pin, int value);
+
+    // heap, counted by the global operator new/delete
+    struct HeapStats
+    {
+        uint64_t allocations;
+        uint64_t frees;
+        uint64_t bytes;
+        int64_t live;
+        int64_t peak;
+    };
+
+    HeapStats heap();
+    void resetHeapPeak();
+
+    // network
+    void setLocalIP(uint8_t a, uint8_t b, uint8_t c, uint8_t d);
+    void setNetworkLatency(uint64_t us);
+    uint64_t getNetworkLatency();
+    void wifiDisconnect(); // the access point goes away until wifiConnect()
+    void wifiConnect();
+
+    // filesystem root of LittleFS, a temp directory removed at exit unless HOST_FS_DIR is set
+    const std::string &fsRoot();
+    // LittleFS capacity, 1 MB; once set, writes that do not fit fail like on a full flash
+    void setFsSize(size_t bytes);
+    size_t fsSize();
+    bool isFsSizeSet();
+}
@@ -0,0 +1,136 @@
+#include "SimHttp.h"
+#include "Sim.h"
+#include "ESPAsyncTCP.h"
+
+#include <chrono>
+
+namespace sim
+{
+    HttpResult http(uint16_t port, const std::string &method, const std::string &path, std::function<void()> loop,
+        const std::string &body, const std::string &contentType, uint64_t timeout, uint64_t delay)
+    {
+        HttpResult result;
+        std::string received;
+        bool isDone = false;
+        bool isClosed = false;
+        uint64_t doneAt = 0;
+
+        std::string request = method + " " + path + " HTTP/1.1\r\nHost: device\r\n";
+        if(!contentType.empty())
+        {
+            request += "Content-Type: " + contentType + "\r\n";
+        }
+        request += "Content-Length: " + std::to_string(body.size()) + "\r\nConnection: close\r\n\r\n" + body;
+
+        AsyncClient *client = new AsyncClient();
+        client->onConnect([&](void *, AsyncClient *c) { c->write(request.c_str(), request.size()); });
+        client->onData([&](void *, AsyncClient *, void *data, size_t len) {
+            received.append((const char *)data, len);
+            isDone = isDone || parseHttpResponse(received, result.response, false);
+            doneAt = isDone && doneAt == 0 ? sim::now() : doneAt;
+        });
+        client->onDisconnect([&](void *, AsyncClient *) {
+            isClosed = true;
+            isDone = isDone || parseHttpResponse(received, result.response, true);
+            doneAt = isDone && doneAt == 0 ? sim::now() : doneAt;
+        });
+        client->onError([&](void *, AsyncClient *, int8_t) { isClosed = true; });
+
+        uint64_t start = sim::now() + delay;
+        auto wallStart = std::chrono::steady_clock::now();
+        if(delay > 0)
+        {
+            sim::post(start, [client, port]() { client->connect("127.0.0.1", port); });
+        }
+        else
+        {
+            client->connect("127.0.0.1", port);
+        }
+
+        while(!isDone && !isClosed && sim::now() < start + timeout)
+        {
+            loop();
+            sim::advance(100);
+        }
+
+        result.wall = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - wallStart).count();
+        // the response may complete while loop() is still in delay()
+        result.latency = (doneAt > 0 ? doneAt : sim::now()) - start;
+        result.isTimedOut = !isDone;
+        result.status = result.response.status;
+        result.body = result.response.body;
+
+        delete client;
+        return result;
+    }
+
+    void EventStream::connect(uint16_t port, const std::string &path, uint32_t lastId)
+    {
+        close();
+
+        std::string request = "GET " + path + " HTTP/1.1\r\nHost: device\r\nAccept: text/event-stream\r\n";
+        if(lastId > 0)
+        {
+            request += "Last-Event-ID: " + std::to_string(lastId) + "\r\n";
+        }
+        request += "\r\n";
+
+        client = new AsyncClient();
+        client->onConnect([request](void *, AsyncClient *c) { c->write(request.c_str(), request.size()); });
+        client->onData([this](void *, AsyncClient *, void *data, size_t len) { onData((const char *)data, len); });
+        client->connect("127.0.0.1", port);
+    }
+
+    void EventStream::close()
+    {
+        if(client != nullptr)
+        {
+            client->close();
+            delete client;
+            client = nullptr;
+        }
+
+        buffer.clear();
+        isHeaderDone = false;
+    }
+
+    void EventStream::onData(const char *data, size_t len)
+    {
+        buffer.append(data, len);
+
+        if(!isHeaderDone)
+        {
+            size_t end = buffer.find("\r\n\r\n");
+            if(end == std::string::npos)
+            {
+                return;
+            }
+
+            buffer.erase(0, end + 4);
+            isHeaderDone = true;
+        }
+
+        size_t end;
+        while((end = buffer.find("\r\n\r\n")) != std::string::npos)
+        {
+            std::string event = buffer.substr(0, end + 2);
+            buffer.erase(0, end + 4);
+
+            std::string payload;
+            size_t pos = 0;
+            while(pos < event.size())
+            {
+                size_t lineEnd = event.find("\r\n", pos);
+                std::string line = event.substr(pos, lineEnd - pos);
+                if(line.compare(0, 6, "data: ") == 0)
+                {
+                    payload += (payload.empty() ? "" : "\n") + line.substr(6);
+                }
+                pos = lineEnd + 2;
+            }
+
+            received.push_back(payload);
+            receivedAt.push_back(sim::now());
+        }
+    }
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <stdint.h>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "SimNet.h"
+
+class AsyncClient;
+
+namespace sim
+{
+    struct HttpResult
+    {
+        int status = 0;
+        std::string body;
+        HttpMessage response;
+        uint64_t latency = 0; // virtual [us]
+        uint64_t wall = 0;    // host [ns], includes the loop() calls made while waiting
+        bool isTimedOut = false;
+    };
+
+    // one request over the loopback, loop() is called until the response is complete; a delay
+    // [us] lets the request arrive while loop() is busy, latency is measured from that point
+    HttpResult http(uint16_t port, const std::string &method, const std::string &path, std::function<void()> loop,
+        const std::string &body = "", const std::string &contentType = "", uint64_t timeout = 5000000, uint64_t delay = 0);
+
+    // server-sent events reader, events() grows while the loop runs
+    class EventStream
+    {
+        private:
+            AsyncClient *client = nullptr;
+            std::string buffer;
+            std::vector<std::string> received;
+            std::vector<uint64_t> receivedAt;
+            bool isHeaderDone = false;
+
+            void onData(const char *data, size_t len);
+
+        public:
+            ~EventStream() { close(); }
+            void connect(uint16_t port, const std::string &path, uint32_t lastId = 0);
+            void close();
+            const std::vector<std::string> &events() const { return received; }
+            const std::vector<uint64_t> &eventTimes() const { return receivedAt; } // virtual [us]
+    };
+}
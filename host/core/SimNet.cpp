@@ -0,0 +1,245 @@
+#include "SimNet.h"
+
+#include <stdlib.h>
+#include <strings.h>
+
+namespace
+{
+    std::map<uint16_t, sim::Listener *> &listeners()
+    {
+        // never destroyed, globals still unregister from it at exit
+        static std::map<uint16_t, sim::Listener *> *listeners = new std::map<uint16_t, sim::Listener *>();
+        return *listeners;
+    }
+
+    // header block up to the empty line, false while it is incomplete
+    bool parseHeaders(const std::string &buffer, size_t &end, std::string &firstLine, std::vector<std::pair<std::string, std::string>> &headers)
+    {
+        end = buffer.find("\r\n\r\n");
+        if(end == std::string::npos)
+        {
+            return false;
+        }
+
+        size_t lineEnd = buffer.find("\r\n");
+        firstLine = buffer.substr(0, lineEnd);
+
+        size_t pos = lineEnd + 2;
+        while(pos < end)
+        {
+            size_t next = buffer.find("\r\n", pos);
+            std::string line = buffer.substr(pos, next - pos);
+            size_t colon = line.find(':');
+            if(colon != std::string::npos)
+            {
+                size_t value = line.find_first_not_of(' ', colon + 1);
+                headers.push_back({line.substr(0, colon), value == std::string::npos ? "" : line.substr(value)});
+            }
+            pos = next + 2;
+        }
+
+        end += 4;
+        return true;
+    }
+}
+
+namespace sim
+{
+    void listen(uint16_t port, Listener *listener)
+    {
+        listeners()[port] = listener;
+    }
+
+    void unlisten(uint16_t port, Listener *listener)
+    {
+        auto it = listeners().find(port);
+        if(it != listeners().end() && it->second == listener)
+        {
+            listeners().erase(it);
+        }
+    }
+
+    Listener *findListener(uint16_t port)
+    {
+        auto it = listeners().find(port);
+        return it == listeners().end() ? nullptr : it->second;
+    }
+
+    std::string HttpMessage::header(const std::string &name) const
+    {
+        for(auto &h : headers)
+        {
+            if(strcasecmp(h.first.c_str(), name.c_str()) == 0)
+            {
+                return h.second;
+            }
+        }
+
+        return "";
+    }
+
+    bool parseHttpRequest(std::string &buffer, HttpMessage &message)
+    {
+        size_t end;
+        std::string firstLine;
+        std::vector<std::pair<std::string, std::string>> headers;
+        if(!parseHeaders(buffer, end, firstLine, headers))
+        {
+            return false;
+        }
+
+        HttpMessage result;
+        result.headers = headers;
+        std::string length = result.header("Content-Length");
+        size_t contentLength = length.empty() ? 0 : strtoul(length.c_str(), nullptr, 10);
+        if(buffer.size() < end + contentLength)
+        {
+            return false;
+        }
+
+        size_t space1 = firstLine.find(' ');
+        size_t space2 = firstLine.find(' ', space1 + 1);
+        result.method = firstLine.substr(0, space1);
+        std::string target = firstLine.substr(space1 + 1, space2 - space1 - 1);
+        size_t question = target.find('?');
+        result.path = urlDecode(target.substr(0, question));
+        result.query = question == std::string::npos ? "" : target.substr(question + 1);
+        parseParams(result.query, result.params);
+        result.body = buffer.substr(end, contentLength);
+
+        buffer.erase(0, end + contentLength);
+        message = result;
+        return true;
+    }
+
+    bool parseHttpResponse(std::string &buffer, HttpMessage &message, bool isClosed)
+    {
+        size_t end;
+        std::string firstLine;
+        std::vector<std::pair<std::string, std::string>> headers;
+        if(!parseHeaders(buffer, end, firstLine, headers))
+        {
+            return false;
+        }
+
+        HttpMessage result;
+        result.headers = headers;
+        size_t space = firstLine.find(' ');
+        result.status = atoi(firstLine.c_str() + space + 1);
+
+        std::string length = result.header("Content-Length");
+        if(strcasecmp(result.header("Transfer-Encoding").c_str(), "chunked") == 0)
+        {
+            size_t pos = end;
+            while(true)
+            {
+                size_t lineEnd = buffer.find("\r\n", pos);
+                if(lineEnd == std::string::npos)
+                {
+                    return false;
+                }
+
+                size_t size = strtoul(buffer.c_str() + pos, nullptr, 16);
+                if(buffer.size() < lineEnd + 2 + size + 2)
+                {
+                    return false;
+                }
+
+                result.body.append(buffer, lineEnd + 2, size);
+                pos = lineEnd + 2 + size + 2;
+                if(size == 0)
+                {
+                    break;
+                }
+            }
+
+            buffer.erase(0, pos);
+        }
+        else if(!length.empty())
+        {
+            size_t contentLength = strtoul(length.c_str(), nullptr, 10);
+            if(buffer.size() < end + contentLength)
+            {
+                return false;
+            }
+
+            result.body = buffer.substr(end, contentLength);
+            buffer.erase(0, end + contentLength);
+        }
+        else
+        {
+            // body ends with the connection
+            if(!isClosed)
+            {
+                return false;
+            }
+
+            result.body = buffer.substr(end);
+            buffer.clear();
+        }
+
+        message = result;
+        return true;
+    }
+
+    std::string urlDecode(const std::string &value)
+    {
+        std::string result;
+        for(size_t i = 0; i < value.size(); i++)
+        {
+            if(value[i] == '+')
+            {
+                result += ' ';
+            }
+            else if(value[i] == '%' && i + 2 < value.size())
+            {
+                result += (char)strtol(value.substr(i + 1, 2).c_str(), nullptr, 16);
+                i += 2;
+            }
+            else
+            {
+                result += value[i];
+            }
+        }
+
+        return result;
+    }
+
+    void parseParams(const std::string &query, std::vector<std::pair<std::string, std::string>> &params)
+    {
+        size_t pos = 0;
+        while(pos < query.size())
+        {
+            size_t amp = query.find('&', pos);
+            if(amp == std::string::npos)
+            {
+                amp = query.size();
+            }
+
+            std::string pair = query.substr(pos, amp - pos);
+            size_t eq = pair.find('=');
+            if(!pair.empty())
+            {
+                params.push_back({urlDecode(pair.substr(0, eq)), eq == std::string::npos ? "" : urlDecode(pair.substr(eq + 1))});
+            }
+            pos = amp + 1;
+        }
+    }
+
+    const char *statusText(int code)
+    {
+        switch(code)
+        {
+            case 200: return "OK";
+            case 204: return "No Content";
+            case 301: return "Moved Permanently";
+            case 302: return "Found";
+            case 400: return "Bad Request";
+            case 404: return "Not Found";
+            case 405: return "Method Not Allowed";
+            case 500: return "Internal Server Error";
+            case 503: return "Service Unavailable";
+            default: return "";
+        }
+    }
+}
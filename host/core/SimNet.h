@@ -0,0 +1,57 @@
+#pragma once
+
+#include <stdint.h>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+/*
+Loopback TCP used by the simulated AsyncClient and web servers. The host part of an address is
+ignored, a connection goes to whatever listens on the port. Data is handed over one network
+latency after it was written.
+*/
+namespace sim
+{
+    class Connection
+    {
+        public:
+            virtual ~Connection() {}
+            virtual void send(const uint8_t *data, size_t len) = 0;
+            void send(const std::string &data) { send((const uint8_t *)data.data(), data.size()); }
+            virtual void close() = 0;
+            virtual bool isOpen() = 0;
+    };
+
+    class Listener
+    {
+        public:
+            virtual ~Listener() {}
+            virtual void onData(std::shared_ptr<Connection> connection, const uint8_t *data, size_t len) = 0;
+            virtual void onClose(std::shared_ptr<Connection> connection) {}
+    };
+
+    void listen(uint16_t port, Listener *listener);
+    void unlisten(uint16_t port, Listener *listener);
+    Listener *findListener(uint16_t port);
+
+    struct HttpMessage
+    {
+        std::string method;
+        std::string path;
+        std::string query;
+        std::vector<std::pair<std::string, std::string>> params;
+        std::vector<std::pair<std::string, std::string>> headers;
+        std::string body;
+        int status = 0;
+
+        std::string header(const std::string &name) const;
+    };
+
+    // complete request or response in buffer, removed from it; false while more data is needed
+    bool parseHttpRequest(std::string &buffer, HttpMessage &message);
+    bool parseHttpResponse(std::string &buffer, HttpMessage &message, bool isClosed);
+    std::string urlDecode(const std::string &value);
+    void parseParams(const std::string &query, std::vector<std::pair<std::string, std::string>> &params);
+    const char *statusText(int code);
+}
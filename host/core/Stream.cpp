@@ -0,0 +1,128 @@
+#include "Stream.h"
+#include "Sim.h"
+
+int Stream::timedRead()
+{
+    uint64_t start = sim::now();
+    while(true)
+    {
+        int c = read();
+        if(c >= 0 || sim::now() - start >= timeout * 1000ULL)
+        {
+            return c;
+        }
+
+        sim::advance(100);
+    }
+}
+
+int Stream::timedPeek()
+{
+    uint64_t start = sim::now();
+    while(true)
+    {
+        int c = peek();
+        if(c >= 0 || sim::now() - start >= timeout * 1000ULL)
+        {
+            return c;
+        }
+
+        sim::advance(100);
+    }
+}
+
+bool Stream::find(const char *target)
+{
+    size_t len = strlen(target);
+    size_t matched = 0;
+    int c;
+    while(matched < len && (c = timedRead()) >= 0)
+    {
+        matched = c == target[matched] ? matched + 1 : (c == target[0] ? 1 : 0);
+    }
+
+    return matched == len;
+}
+
+size_t Stream::readBytes(char *buffer, size_t length)
+{
+    size_t count = 0;
+    while(count < length)
+    {
+        int c = timedRead();
+        if(c < 0)
+        {
+            break;
+        }
+
+        buffer[count++] = (char)c;
+    }
+
+    return count;
+}
+
+size_t Stream::readBytesUntil(char terminator, char *buffer, size_t length)
+{
+    size_t count = 0;
+    while(count < length)
+    {
+        int c = timedRead();
+        if(c < 0 || c == terminator)
+        {
+            break;
+        }
+
+        buffer[count++] = (char)c;
+    }
+
+    return count;
+}
+
+String Stream::readString()
+{
+    String result;
+    int c;
+    while((c = timedRead()) >= 0)
+    {
+        result += (char)c;
+    }
+
+    return result;
+}
+
+String Stream::readStringUntil(char terminator)
+{
+    String result;
+    int c;
+    while((c = timedRead()) >= 0 && c != terminator)
+    {
+        result += (char)c;
+    }
+
+    return result;
+}
+
+long Stream::parseInt()
+{
+    int c;
+    while((c = timedPeek()) >= 0 && c != '-' && (c < '0' || c > '9'))
+    {
+        read();
+    }
+
+    bool negative = false;
+    long value = 0;
+    if(c == '-')
+    {
+        negative = true;
+        read();
+    }
+
+    while((c = timedPeek()) >= '0' && c <= '9')
+    {
+        value = value * 10 + c - '0';
+        read();
+    }
+
+    return negative ? -value : value;
+}
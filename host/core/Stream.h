@@ -0,0 +1,28 @@
+#pragma once
+
+#include "Print.h"
+
+class Stream : public Print
+{
+    protected:
+        unsigned long timeout = 1000;
+
+        // waits on the virtual clock, so anything posted for the wait time gets to run
+        int timedRead();
+        int timedPeek();
+
+    public:
+        virtual int available() = 0;
+        virtual int read() = 0;
+        virtual int peek() = 0;
+
+        void setTimeout(unsigned long timeout) { this->timeout = timeout; }
+        unsigned long getTimeout() { return timeout; }
+        bool find(const char *target);
+        size_t readBytes(char *buffer, size_t length);
+        size_t readBytes(uint8_t *buffer, size_t length) { return readBytes((char *)buffer, length); }
+        size_t readBytesUntil(char terminator, char *buffer, size_t length);
+        String readString();
+        String readStringUntil(char terminator);
+        long parseInt();
+};
@@ -0,0 +1,4 @@
+#pragma once
+
+#define TZ_Etc_UTC PSTR("UTC0")
+#define TZ_Europe_Warsaw PSTR("CET-1CEST,M3.5.0,M10.5.0/3")
@@ -0,0 +1,89 @@
+#include "TickTwo.h"
+
+TickTwo::TickTwo(fptr callback, uint32_t timer, uint32_t repeat, resolution_t resolution) :
+    repeat(repeat), resolution(resolution), callback(callback)
+{
+    // MICROS takes milliseconds and measures them with micros()
+    this->timer = resolution == MICROS ? timer * 1000 : timer;
+}
+
+void TickTwo::start()
+{
+    if(!callback)
+    {
+        return;
+    }
+
+    lastTime = now();
+    enabled = true;
+    counts = 0;
+    status = RUNNING;
+}
+
+void TickTwo::resume()
+{
+    if(!callback)
+    {
+        return;
+    }
+
+    lastTime = now() - diffTime;
+    if(status == STOPPED)
+    {
+        counts = 0;
+    }
+
+    enabled = true;
+    status = RUNNING;
+}
+
+void TickTwo::pause()
+{
+    diffTime = now() - lastTime;
+    enabled = false;
+    status = PAUSED;
+}
+
+void TickTwo::stop()
+{
+    enabled = false;
+    counts = 0;
+    status = STOPPED;
+}
+
+void TickTwo::update()
+{
+    if(tick())
+    {
+        callback();
+    }
+}
+
+void TickTwo::interval(uint32_t timer)
+{
+    this->timer = resolution == MICROS ? timer * 1000 : timer;
+}
+
+bool TickTwo::tick()
+{
+    if(!enabled)
+    {
+        return false;
+    }
+
+    uint32_t currentTime = now();
+    if(currentTime - lastTime >= timer)
+    {
+        lastTime = currentTime;
+        if(repeat - counts == 1 && counts != 0xFFFFFFFF)
+        {
+            enabled = false;
+            status = STOPPED;
+        }
+
+        counts++;
+        return true;
+    }
+
+    return false;
+}
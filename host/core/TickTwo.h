@@ -0,0 +1,53 @@
+#pragma once
+
+#include "Arduino.h"
+
+// same behaviour as sstaub/TickTwo, which is a library dependency of the devices
+enum resolution_t
+{
+    MICROS,
+    MILLIS,
+    MICROS_MICROS
+};
+
+enum status_t
+{
+    STOPPED,
+    RUNNING,
+    PAUSED
+};
+
+typedef std::function<void()> fptr;
+
+class TickTwo
+{
+    private:
+        bool tick();
+
+        bool enabled = false;
+        uint32_t timer;
+        uint32_t repeat;
+        resolution_t resolution;
+        uint32_t counts = 0;
+        status_t status = STOPPED;
+        fptr callback;
+        uint32_t lastTime = 0;
+        uint32_t diffTime = 0;
+
+        uint32_t now() { return resolution == MILLIS ? millis() : micros(); }
+
+    public:
+        TickTwo(fptr callback, uint32_t timer, uint32_t repeat = 0, resolution_t resolution = MICROS);
+
+        void start();
+        void resume();
+        void pause();
+        void stop();
+        void update();
+        void interval(uint32_t timer);
+        uint32_t interval() { return resolution == MICROS ? timer / 1000 : timer; }
+        uint32_t elapsed() { return now() - lastTime; }
+        uint32_t remaining() { return timer - elapsed(); }
+        status_t state() { return status; }
+        uint32_t counter() { return counts; }
+};
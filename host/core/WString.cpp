@@ -0,0 +1,288 @@
+#include "WString.h"
+
+#include <ctype.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+
+std::string String::fromNumber(unsigned long long value, unsigned char base, bool negative)
+{
+    if(base < 2 || base > 36)
+    {
+        base = 10;
+    }
+
+    char buf[70];
+    char *p = buf + sizeof(buf) - 1;
+    *p = 0;
+    do
+    {
+        int digit = value % base;
+        *--p = digit < 10 ? '0' + digit : 'a' + digit - 10;
+        value /= base;
+    } while(value);
+
+    if(negative)
+    {
+        *--p = '-';
+    }
+
+    return p;
+}
+
+String::String(unsigned char value, unsigned char base) : s(fromNumber(value, base, false)) {}
+String::String(unsigned int value, unsigned char base) : s(fromNumber(value, base, false)) {}
+String::String(unsigned long value, unsigned char base) : s(fromNumber(value, base, false)) {}
+String::String(unsigned long long value, unsigned char base) : s(fromNumber(value, base, false)) {}
+
+String::String(int value, unsigned char base) : String((long long)value, base) {}
+String::String(long value, unsigned char base) : String((long long)value, base) {}
+
+String::String(long long value, unsigned char base)
+{
+    // like the core, only base 10 is printed with a sign
+    if(base == 10 && value < 0)
+    {
+        s = fromNumber(-(unsigned long long)value, base, true);
+    }
+    else
+    {
+        s = fromNumber(base == 10 ? (unsigned long long)value : (unsigned long)value, base, false);
+    }
+}
+
+String::String(float value, unsigned char decimalPlaces) : String((double)value, decimalPlaces) {}
+
+String::String(double value, unsigned char decimalPlaces)
+{
+    if(isnan(value))
+    {
+        s = "nan";
+        return;
+    }
+
+    if(isinf(value))
+    {
+        s = value > 0 ? "inf" : "-inf";
+        return;
+    }
+
+    char buf[64];
+    snprintf(buf, sizeof(buf), "%.*f", decimalPlaces, value);
+    s = buf;
+}
+
+bool String::equalsIgnoreCase(const String &str) const
+{
+    if(s.length() != str.s.length())
+    {
+        return false;
+    }
+
+    for(size_t i = 0; i < s.length(); i++)
+    {
+        if(tolower((unsigned char)s[i]) != tolower((unsigned char)str.s[i]))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool String::endsWith(const String &suffix) const
+{
+    return s.length() >= suffix.s.length() && s.compare(s.length() - suffix.s.length(), suffix.s.length(), suffix.s) == 0;
+}
+
+char &String::operator[](unsigned int index)
+{
+    static char dummy;
+    if(index >= s.length())
+    {
+        dummy = 0;
+        return dummy;
+    }
+
+    return s[index];
+}
+
+void String::getBytes(unsigned char *buf, unsigned int bufsize, unsigned int index) const
+{
+    if(bufsize == 0 || buf == nullptr)
+    {
+        return;
+    }
+
+    if(index >= s.length())
+    {
+        buf[0] = 0;
+        return;
+    }
+
+    unsigned int n = std::min<unsigned int>(bufsize - 1, s.length() - index);
+    memcpy(buf, s.c_str() + index, n);
+    buf[n] = 0;
+}
+
+int String::indexOf(char c, unsigned int from) const
+{
+    size_t i = s.find(c, from);
+    return i == std::string::npos ? -1 : (int)i;
+}
+
+int String::indexOf(const String &str, unsigned int from) const
+{
+    size_t i = s.find(str.s, from);
+    return i == std::string::npos ? -1 : (int)i;
+}
+
+int String::lastIndexOf(char c) const
+{
+    size_t i = s.rfind(c);
+    return i == std::string::npos ? -1 : (int)i;
+}
+
+int String::lastIndexOf(char c, unsigned int from) const
+{
+    size_t i = s.rfind(c, from);
+    return i == std::string::npos ? -1 : (int)i;
+}
+
+int String::lastIndexOf(const String &str) const
+{
+    size_t i = s.rfind(str.s);
+    return i == std::string::npos ? -1 : (int)i;
+}
+
+String String::substring(unsigned int from, unsigned int to) const
+{
+    if(from > to)
+    {
+        std::swap(from, to);
+    }
+
+    if(from >= s.length())
+    {
+        return String();
+    }
+
+    if(to > s.length())
+    {
+        to = s.length();
+    }
+
+    return String(s.substr(from, to - from));
+}
+
+void String::replace(char find, char replace)
+{
+    std::replace(s.begin(), s.end(), find, replace);
+}
+
+void String::replace(const String &find, const String &replace)
+{
+    if(find.s.empty())
+    {
+        return;
+    }
+
+    size_t i = 0;
+    while((i = s.find(find.s, i)) != std::string::npos)
+    {
+        s.replace(i, find.s.length(), replace.s);
+        i += replace.s.length();
+    }
+}
+
+void String::remove(unsigned int index, unsigned int count)
+{
+    if(index < s.length())
+    {
+        s.erase(index, count);
+    }
+}
+
+void String::toLowerCase()
+{
+    for(char &c : s)
+    {
+        c = tolower((unsigned char)c);
+    }
+}
+
+void String::toUpperCase()
+{
+    for(char &c : s)
+    {
+        c = toupper((unsigned char)c);
+    }
+}
+
+void String::trim()
+{
+    size_t begin = 0;
+    while(begin < s.length() && isspace((unsigned char)s[begin]))
+    {
+        begin++;
+    }
+
+    size_t end = s.length();
+    while(end > begin && isspace((unsigned char)s[end - 1]))
+    {
+        end--;
+    }
+
+    s = s.substr(begin, end - begin);
+}
+
+long String::toInt() const
+{
+    return atol(s.c_str());
+}
+
+float String::toFloat() const
+{
+    return atof(s.c_str());
+}
+
+double String::toDouble() const
+{
+    return atof(s.c_str());
+}
+
+String operator+(const String &lhs, const String &rhs)
+{
+    String result(lhs);
+    result.concat(rhs);
+    return result;
+}
+
+String operator+(const String &lhs, const char *rhs)
+{
+    String result(lhs);
+    result.concat(rhs);
+    return result;
+}
+
+String operator+(const char *lhs, const String &rhs)
+{
+    String result(lhs);
+    result.concat(rhs);
+    return result;
+}
+
+String operator+(const String &lhs, char rhs)
+{
+    String result(lhs);
+    result.concat(rhs);
+    return result;
+}
+
+String operator+(const String &lhs, int rhs) { return lhs + String(rhs); }
+String operator+(const String &lhs, unsigned int rhs) { return lhs + String(rhs); }
+String operator+(const String &lhs, long rhs) { return lhs + String(rhs); }
+String operator+(const String &lhs, unsigned long rhs) { return lhs + String(rhs); }
+String operator+(const String &lhs, float rhs) { return lhs + String(rhs); }
+String operator+(const String &lhs, double rhs) { return lhs + String(rhs); }
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+#include <string>
+
+class __FlashStringHelper;
+
+// Arduino String on top of std::string, allocations show up in the heap counters
+class String
+{
+    private:
+        std::string s;
+
+        static std::string fromNumber(unsigned long long value, unsigned char base, bool negative);
+
+    public:
+        String() {}
+        String(const char *cstr) : s(cstr != nullptr ? cstr : "") {}
+        String(const __FlashStringHelper *str) : String((const char *)str) {}
+        String(const std::string &str) : s(str) {}
+        explicit String(char c) : s(1, c) {}
+        explicit String(unsigned char value, unsigned char base = 10);
+        explicit String(int value, unsigned char base = 10);
+        explicit String(unsigned int value, unsigned char base = 10);
+        explicit String(long value, unsigned char base = 10);
+        explicit String(unsigned long value, unsigned char base = 10);
+        explicit String(long long value, unsigned char base = 10);
+        explicit String(unsigned long long value, unsigned char base = 10);
+        explicit String(float value, unsigned char decimalPlaces = 2);
+        explicit String(double value, unsigned char decimalPlaces = 2);
+
+        unsigned int length() const { return s.length(); }
+        bool isEmpty() const { return s.empty(); }
+        const char *c_str() const { return s.c_str(); }
+        char *begin() { return &s[0]; }
+        char *end() { return &s[0] + s.length(); }
+        bool reserve(unsigned int size) { s.reserve(size); return true; }
+        const std::string &str() const { return s; }
+
+        bool concat(const String &str) { s += str.s; return true; }
+        bool concat(const char *cstr) { s += cstr; return true; }
+        bool concat(const char *cstr, unsigned int len) { s.append(cstr, len); return true; }
+        bool concat(char c) { s += c; return true; }
+        bool concat(unsigned char value) { return concat(String(value)); }
+        bool concat(int value) { return concat(String(value)); }
+        bool concat(unsigned int value) { return concat(String(value)); }
+        bool concat(long value) { return concat(String(value)); }
+        bool concat(unsigned long value) { return concat(String(value)); }
+        bool concat(float value) { return concat(String(value)); }
+        bool concat(double value) { return concat(String(value)); }
+
+        template<typename T>
+        String &operator+=(const T &value) { concat(value); return *this; }
+
+        int compareTo(const String &str) const { return s.compare(str.s); }
+        bool equals(const String &str) const { return s == str.s; }
+        bool equals(const char *cstr) const { return s == cstr; }
+        bool equalsIgnoreCase(const String &str) const;
+        bool operator==(const String &str) const { return s == str.s; }
+        bool operator==(const char *cstr) const { return s == cstr; }
+        bool operator!=(const String &str) const { return s != str.s; }
+        bool operator!=(const char *cstr) const { return s != cstr; }
+        bool operator<(const String &str) const { return s < str.s; }
+        bool operator>(const String &str) const { return s > str.s; }
+        bool startsWith(const String &prefix) const { return s.compare(0, prefix.s.length(), prefix.s) == 0; }
+        bool startsWith(const String &prefix, unsigned int offset) const { return offset <= s.length() && s.compare(offset, prefix.s.length(), prefix.s) == 0; }
+        bool endsWith(const String &suffix) const;
+
+        char charAt(unsigned int index) const { return index < s.length() ? s[index] : 0; }
+        void setCharAt(unsigned int index, char c) { if(index < s.length()) s[index] = c; }
+        char operator[](unsigned int index) const { return charAt(index); }
+        char &operator[](unsigned int index);
+        void getBytes(unsigned char *buf, unsigned int bufsize, unsigned int index = 0) const;
+        void toCharArray(char *buf, unsigned int bufsize, unsigned int index = 0) const { getBytes((unsigned char *)buf, bufsize, index); }
+
+        int indexOf(char c, unsigned int from = 0) const;
+        int indexOf(const String &str, unsigned int from = 0) const;
+        int lastIndexOf(char c) const;
+        int lastIndexOf(char c, unsigned int from) const;
+        int lastIndexOf(const String &str) const;
+        String substring(unsigned int from) const { return substring(from, s.length()); }
+        String substring(unsigned int from, unsigned int to) const;
+
+        void replace(char find, char replace);
+        void replace(const String &find, const String &replace);
+        void remove(unsigned int index) { remove(index, (unsigned int)-1); }
+        void remove(unsigned int index, unsigned int count);
+        void toLowerCase();
+        void toUpperCase();
+        void trim();
+
+        long toInt() const;
+        float toFloat() const;
+        double toDouble() const;
+};
+
+String operator+(const String &lhs, const String &rhs);
+String operator+(const String &lhs, const char *rhs);
+String operator+(const char *lhs, const String &rhs);
+String operator+(const String &lhs, char rhs);
+String operator+(const String &lhs, int rhs);
+String operator+(const String &lhs, unsigned int rhs);
+String operator+(const String &lhs, long rhs);
+String operator+(const String &lhs, unsigned long rhs);
+String operator+(const String &lhs, float rhs);
+String operator+(const String &lhs, double rhs);
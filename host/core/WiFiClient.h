@@ -0,0 +1,18 @@
+#pragma once
+
+#include "ESP8266WiFi.h"
+
+// only here for the includes, blocking TCP clients are not simulated
+class WiFiClient : public Stream
+{
+    public:
+        int connect(IPAddress ip, uint16_t port) { return 0; }
+        int connect(const char *host, uint16_t port) { return 0; }
+        uint8_t connected() { return 0; }
+        void stop() {}
+        int available() { return 0; }
+        int read() { return -1; }
+        int peek() { return -1; }
+        size_t write(uint8_t c) { return 0; }
+        using Print::write;
+};
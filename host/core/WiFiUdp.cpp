@@ -0,0 +1,179 @@
+#include "WiFiUdp.h"
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+namespace
+{
+    std::vector<WiFiUDP *> &sockets()
+    {
+        // never destroyed, globals still unregister from it at exit
+        static std::vector<WiFiUDP *> *sockets = new std::vector<WiFiUDP *>();
+        return *sockets;
+    }
+
+    // a posted delivery must not reach a socket that was destroyed meanwhile
+    bool isOpen(WiFiUDP *socket)
+    {
+        return std::find(sockets().begin(), sockets().end(), socket) != sockets().end();
+    }
+}
+
+WiFiUDP::~WiFiUDP()
+{
+    stop();
+}
+
+uint8_t WiFiUDP::begin(uint16_t port)
+{
+    stop();
+    this->port = port;
+    this->group = IPAddress();
+    sockets().push_back(this);
+    return 1;
+}
+
+uint8_t WiFiUDP::beginMulticast(IPAddress interfaceAddr, IPAddress multicast, uint16_t port)
+{
+    begin(port);
+    group = multicast;
+    return 1;
+}
+
+void WiFiUDP::stop()
+{
+    sockets().erase(std::remove(sockets().begin(), sockets().end(), this), sockets().end());
+    received.clear();
+    port = 0;
+}
+
+int WiFiUDP::beginPacket(IPAddress ip, uint16_t port)
+{
+    if(WiFi.status() != WL_CONNECTED)
+    {
+        return 0;
+    }
+
+    destination = ip;
+    destinationPort = port;
+    outgoing.clear();
+    return 1;
+}
+
+int WiFiUDP::beginPacket(const char *host, uint16_t port)
+{
+    IPAddress ip;
+    if(!ip.fromString(host))
+    {
+        ip = IPAddress(127, 0, 0, 1);
+    }
+
+    return beginPacket(ip, port);
+}
+
+int WiFiUDP::beginPacketMulticast(IPAddress multicastAddress, uint16_t port, IPAddress interfaceAddress, int ttl)
+{
+    return beginPacket(multicastAddress, port);
+}
+
+size_t WiFiUDP::write(uint8_t c)
+{
+    outgoing += (char)c;
+    return 1;
+}
+
+size_t WiFiUDP::write(const uint8_t *buffer, size_t size)
+{
+    outgoing.append((const char *)buffer, size);
+    return size;
+}
+
+int WiFiUDP::endPacket()
+{
+    if(destinationPort == 0)
+    {
+        return 0;
+    }
+
+    packet p = {outgoing, WiFi.localIP(), port};
+    IPAddress target = destination;
+    uint16_t targetPort = destinationPort;
+    WiFiUDP *sender = this;
+    outgoing.clear();
+    destinationPort = 0;
+
+    sim::post(sim::now() + sim::getNetworkLatency(), [p, target, targetPort, sender]() {
+        std::vector<WiFiUDP *> current = sockets();
+        for(WiFiUDP *socket : current)
+        {
+            if(socket == sender || socket->port != targetPort || !isOpen(socket))
+            {
+                continue;
+            }
+
+            if(target.isMulticast() ? socket->group == target : !socket->group.isSet())
+            {
+                socket->deliver(p);
+            }
+        }
+    });
+
+    return 1;
+}
+
+void WiFiUDP::deliver(const packet &p)
+{
+    // lwIP keeps a few pbufs per pcb, the oldest is dropped beyond that
+    if(received.size() >= 8)
+    {
+        received.pop_front();
+    }
+
+    received.push_back(p);
+}
+
+int WiFiUDP::parsePacket()
+{
+    sim::runPending();
+
+    if(received.empty())
+    {
+        current = packet();
+        position = 0;
+        return 0;
+    }
+
+    current = received.front();
+    received.pop_front();
+    position = 0;
+    return current.data.size();
+}
+
+int WiFiUDP::available()
+{
+    return current.data.size() - position;
+}
+
+int WiFiUDP::read()
+{
+    return position < current.data.size() ? (uint8_t)current.data[position++] : -1;
+}
+
+int WiFiUDP::read(unsigned char *buffer, size_t len)
+{
+    size_t n = std::min(len, current.data.size() - position);
+    memcpy(buffer, current.data.data() + position, n);
+    position += n;
+    return n;
+}
+
+int WiFiUDP::peek()
+{
+    return position < current.data.size() ? (uint8_t)current.data[position] : -1;
+}
+
+void WiFiUDP::flush()
+{
+    position = current.data.size();
+}
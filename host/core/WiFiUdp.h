@@ -0,0 +1,58 @@
+#pragma once
+
+#include <deque>
+#include <string>
+
+#include "ESP8266WiFi.h"
+
+// every socket lives on one loopback segment, multicast goes to the sockets that joined the group
+class WiFiUDP : public Stream
+{
+    private:
+        struct packet
+        {
+            std::string data;
+            IPAddress remoteIP;
+            uint16_t remotePort;
+        };
+
+        uint16_t port = 0;
+        IPAddress group;
+        std::deque<packet> received;
+        packet current;
+        size_t position = 0;
+        std::string outgoing;
+        IPAddress destination;
+        uint16_t destinationPort = 0;
+
+        void deliver(const packet &p);
+
+    public:
+        WiFiUDP() {}
+        WiFiUDP(const WiFiUDP &) = delete;
+        WiFiUDP &operator=(const WiFiUDP &) = delete;
+        ~WiFiUDP();
+
+        uint8_t begin(uint16_t port);
+        uint8_t beginMulticast(IPAddress interfaceAddr, IPAddress multicast, uint16_t port);
+        void stop();
+
+        int beginPacket(IPAddress ip, uint16_t port);
+        int beginPacket(const char *host, uint16_t port);
+        int beginPacketMulticast(IPAddress multicastAddress, uint16_t port, IPAddress interfaceAddress, int ttl = 1);
+        size_t write(uint8_t c);
+        size_t write(const uint8_t *buffer, size_t size);
+        using Print::write;
+        int endPacket();
+
+        int parsePacket();
+        int available();
+        int read();
+        int read(unsigned char *buffer, size_t len);
+        int read(char *buffer, size_t len) { return read((unsigned char *)buffer, len); }
+        int peek();
+        void flush();
+        IPAddress remoteIP() { return current.remoteIP; }
+        uint16_t remotePort() { return current.remotePort; }
+        uint16_t localPort() { return port; }
+};
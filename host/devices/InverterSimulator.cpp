@@ -0,0 +1,346 @@
+#include "InverterSimulator.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+
+#include <CRC16.h>
+#include <Sim.h>
+
+namespace
+{
+    const double pvRated = 4000; // W, sets the PV voltage for a given available power
+    const uint64_t maxStep = 10000000;
+
+    // stateless noise so the curves do not depend on how often they are sampled
+    double noise(uint64_t key, uint32_t seed)
+    {
+        uint64_t z = key * 0x9E3779B97F4A7C15ULL + seed;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        z ^= z >> 31;
+        return (z >> 11) * (1.0 / 9007199254740992.0);
+    }
+
+    bool isDigits(const std::string &value, size_t length)
+    {
+        return value.size() == length && std::all_of(value.begin(), value.end(), ::isdigit);
+    }
+}
+
+InverterSimulator::InverterSimulator(HardwareSerial *serial, uint32_t seed) :
+    serial(serial),
+    random(seed),
+    pvCurve(sunnyDays(pvRated)),
+    loadCurve(constantLoad(500, 100))
+{
+}
+
+void InverterSimulator::onReceive(uint8_t c)
+{
+    if(c != '\r')
+    {
+        // garbage without a terminator is dropped like the inverter's own line buffer does
+        if(frame.size() < 64)
+        {
+            frame += (char)c;
+        }
+        return;
+    }
+
+    std::string received;
+    received.swap(frame);
+    handleFrame(received);
+}
+
+void InverterSimulator::handleFrame(const std::string &received)
+{
+    if(faults.isOffline)
+    {
+        return;
+    }
+
+    counters.requests++;
+    if(received.size() < 3)
+    {
+        counters.crcErrors++;
+        reply("(NAK");
+        return;
+    }
+
+    std::string command = received.substr(0, received.size() - 2);
+    uint16_t expected = crc(command);
+    if((uint8_t)received[received.size() - 2] != (expected >> 8) || (uint8_t)received[received.size() - 1] != (expected & 0xFF))
+    {
+        counters.crcErrors++;
+        reply("(NAK");
+        return;
+    }
+
+    if(chance(faults.dropRate))
+    {
+        counters.dropped++;
+        return;
+    }
+
+    if(chance(faults.nakRate))
+    {
+        counters.naks++;
+        reply("(NAK");
+        return;
+    }
+
+    reply(execute(command));
+}
+
+std::string InverterSimulator::execute(const std::string &command)
+{
+    update();
+
+    std::string name = command.compare(0, 2, "QE") == 0 || command.compare(0, 3, "POP") == 0 ? command.substr(0, 3) : command;
+    counters.commands[name]++;
+
+    if(command == "QPI")
+    {
+        return "(PI30";
+    }
+
+    if(command == "QMN")
+    {
+        return "(MKS2-5600";
+    }
+
+    if(command == "QID")
+    {
+        return "(92932004102443";
+    }
+
+    if(command == "QPIGS")
+    {
+        return qpigs();
+    }
+
+    // PI30 units: kWh for total, year and month, Wh for day and hour
+    if(command == "QET")
+    {
+        return energy("", 1000);
+    }
+
+    std::string arg = command.size() > 3 ? command.substr(3) : "";
+    if(name == "QEY" && isDigits(arg, 4))
+    {
+        return energy(arg, 1000);
+    }
+
+    if(name == "QEM" && isDigits(arg, 6))
+    {
+        return energy(arg, 1000);
+    }
+
+    if(name == "QED" && isDigits(arg, 8))
+    {
+        return energy(arg, 1);
+    }
+
+    if(name == "QEH" && isDigits(arg, 10))
+    {
+        return energy(arg, 1);
+    }
+
+    if(name == "POP" && faults.isRefusingPop)
+    {
+        counters.naks++;
+        return "(NAK";
+    }
+
+    if(name == "POP" && command.size() == 5 && command[3] == '0' && command[4] >= '0' && command[4] <= '2')
+    {
+        OutputPriority requested = (OutputPriority)(command[4] - '0');
+        if(requested != priority)
+        {
+            priority = requested;
+            counters.priorityChanges++;
+        }
+
+        return "(ACK";
+    }
+
+    counters.unknown++;
+    return "(NAK";
+}
+
+std::string InverterSimulator::qpigs()
+{
+    double batteryVoltage = 46.0 + 8.0 * soc / 100 + (batteryPower > 0 ? 0.8 : 0);
+    double pvVoltage = getPvVoltage();
+    double pvCurrent = pvVoltage > 0 ? std::min(99.9, pvPower / pvVoltage) : 0;
+    int chargeCurrent = batteryPower > 0 ? (int)(batteryPower / batteryVoltage) : 0;
+    int dischargeCurrent = batteryPower < 0 ? (int)(-batteryPower / batteryVoltage) : 0;
+    int active = (int)std::min(9999.0, load);
+    int apparent = (int)std::min(9999.0, load * 1.05);
+    int loadPercent = (int)std::min(999.0, load * 100 / 5600);
+
+    char buf[160];
+    snprintf(buf, sizeof(buf), "(230.0 50.0 230.0 50.0 %04d %04d %03d 400 %05.2f %03d %03d %04d %04.1f %05.1f %05.2f %05d 00010%c%c0 00 00 %05d 010",
+        apparent, active, loadPercent, batteryVoltage, chargeCurrent, (int)(soc + 0.5), 35 + (int)(pvPower / 200),
+        pvCurrent, pvVoltage, batteryVoltage, dischargeCurrent, batteryPower > 0 ? '1' : '0', pvPower > 0 ? '1' : '0',
+        (int)std::min(99999.0, pvPower));
+
+    return buf;
+}
+
+std::string InverterSimulator::energy(const std::string &prefix, double divider)
+{
+    double total = 0;
+    for(auto it = pvEnergy.lower_bound(prefix); it != pvEnergy.end() && it->first.compare(0, prefix.size(), prefix) == 0; ++it)
+    {
+        total += it->second;
+    }
+
+    char buf[16];
+    snprintf(buf, sizeof(buf), "(%08lu", (unsigned long)(total / divider));
+    return buf;
+}
+
+void InverterSimulator::reply(std::string data)
+{
+    if(chance(faults.corruptRate))
+    {
+        counters.corrupted++;
+        data[1 + random() % (data.size() - 1)] ^= 0x01;
+    }
+
+    uint16_t value = crc(data);
+    data += (char)(value >> 8);
+    data += (char)(value & 0xFF);
+    data += '\r';
+
+    uint64_t delay = latency + (jitter > 0 ? random() % jitter : 0);
+    HardwareSerial *target = serial;
+    sim::post(sim::now() + delay, [target, data]() { target->inject(data); });
+}
+
+void InverterSimulator::update()
+{
+    uint64_t now = sim::now();
+    if(!isUpdated)
+    {
+        isUpdated = true;
+        updatedAt = now;
+        step(localTime(), 0);
+        return;
+    }
+
+    while(updatedAt < now)
+    {
+        uint64_t dt = std::min(maxStep, now - updatedAt);
+        step(localTime() - (time_t)((now - updatedAt) / 1000000), dt / 1e6);
+        updatedAt += dt;
+    }
+}
+
+void InverterSimulator::step(time_t local, double seconds)
+{
+    pvAvailable = std::max(0.0, pvCurve(local));
+    load = std::max(0.0, loadCurve(local));
+
+    double stored = soc / 100 * batteryCapacity;
+    double roomRate = seconds > 0 ? (batteryCapacity - stored) * 3600 / seconds : maxCharge;
+    double reserveRate = seconds > 0 ? std::max(0.0, stored - cutoffSoc / 100 * batteryCapacity) * 3600 / seconds : 0;
+
+    double pvToLoad = priority == UtilityFirst ? 0 : std::min(pvAvailable, load);
+    double charge = std::min(std::min(pvAvailable - pvToLoad, maxCharge), roomRate);
+    double discharge = 0;
+    if(priority == Sbu && soc > cutoffSoc)
+    {
+        discharge = std::min(load - pvToLoad, reserveRate);
+    }
+
+    double grid = load - pvToLoad - discharge;
+    pvPower = pvToLoad + charge;
+    batteryPower = charge - discharge;
+
+    if(seconds <= 0)
+    {
+        return;
+    }
+
+    stored += (charge * 0.95 - discharge) * seconds / 3600;
+    soc = std::max(0.0, std::min(100.0, stored * 100 / batteryCapacity));
+    gridEnergy += grid * seconds / 3600;
+
+    char hour[16];
+    tm parts;
+    gmtime_r(&local, &parts);
+    strftime(hour, sizeof(hour), "%Y%m%d%H", &parts);
+    pvEnergy[hour] += pvPower * seconds / 3600;
+}
+
+time_t InverterSimulator::localTime()
+{
+    return time(nullptr) + utcOffset;
+}
+
+bool InverterSimulator::chance(double rate)
+{
+    return rate > 0 && std::uniform_real_distribution<double>(0, 1)(random) < rate;
+}
+
+double InverterSimulator::getPvVoltage() const
+{
+    // MPPT voltage rises with irradiance, open circuit voltage is not modelled
+    return pvAvailable < 1 ? 0 : 200 + 140 * sqrt(std::min(1.0, pvAvailable / pvRated));
+}
+
+double InverterSimulator::getPvEnergy() const
+{
+    double total = 0;
+    for(auto &hour : pvEnergy)
+    {
+        total += hour.second;
+    }
+
+    return total;
+}
+
+InverterSimulator::Curve InverterSimulator::sunnyDays(double peak, double sunrise, double sunset, double cloudiness, uint32_t seed)
+{
+    return [=](time_t local) {
+        double hour = (local % 86400) / 3600.0;
+        if(hour <= sunrise || hour >= sunset)
+        {
+            return 0.0;
+        }
+
+        double day = 1 - cloudiness * noise(local / 86400, seed);
+        double minute = 1 - cloudiness * 0.3 * noise(local / 60, seed + 1);
+        return peak * sin(M_PI * (hour - sunrise) / (sunset - sunrise)) * day * minute;
+    };
+}
+
+InverterSimulator::Curve InverterSimulator::constantLoad(double load, double spread, uint32_t seed)
+{
+    return [=](time_t local) { return load + spread * (2 * noise(local / 60, seed) - 1); };
+}
+
+uint16_t InverterSimulator::crc(const std::string &data)
+{
+    CRC16 crc;
+    crc.add((const uint8_t *)data.c_str(), data.size());
+    uint16_t value = crc.getCRC();
+
+    // the inverter never sends a CRC byte that could be read as a frame delimiter
+    uint8_t high = value >> 8;
+    uint8_t low = value & 0xFF;
+    if(high == 0x28 || high == 0x0D || high == 0x0A)
+    {
+        high++;
+    }
+    if(low == 0x28 || low == 0x0D || low == 0x0A)
+    {
+        low++;
+    }
+
+    return (high << 8) | low;
+}
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <stdint.h>
+#include <time.h>
+#include <functional>
+#include <map>
+#include <random>
+#include <string>
+
+#include <HardwareSerial.h>
+
+/*
+Voltronic (PI30) inverter on the other end of a simulated UART, as polled by ESB_driver.
+
+Answers QPI, QMN, QID, QPIGS, QET/QEY/QEM/QED/QEH and POP0x with "(...<crc><cr>" frames.
+Requests are checked against the CRC the inverter expects (XMODEM, high byte first, bytes
+0x28/0x0D/0x0A incremented) and answered with "(NAK" otherwise.
+
+The plant behind it is a PV array following a day curve, a constant-ish load and a battery
+whose SOC follows the energy balance for the selected output priority. Energy counters are
+kept per local hour so the QE* queries add up.
+*/
+class InverterSimulator : public SerialDevice
+{
+    public:
+        enum OutputPriority
+        {
+            UtilityFirst = 0, // POP00
+            SolarFirst = 1,   // POP01, "sub" in the driver
+            Sbu = 2           // POP02, solar then battery then utility
+        };
+
+        struct Faults
+        {
+            double dropRate = 0;    // no reply at all
+            double corruptRate = 0; // one byte of the reply flipped
+            double nakRate = 0;     // "(NAK" instead of the reply
+            bool isRefusingPop = false; // "(NAK" to every POP0x, the rest is answered
+            bool isOffline = false;
+        };
+
+        struct Counters
+        {
+            uint32_t requests = 0;
+            uint32_t crcErrors = 0;
+            uint32_t unknown = 0;
+            uint32_t dropped = 0;
+            uint32_t corrupted = 0;
+            uint32_t naks = 0;
+            uint32_t priorityChanges = 0;
+            std::map<std::string, uint32_t> commands;
+        };
+
+        // available PV power [W] and house load [W] at a local time
+        typedef std::function<double(time_t local)> Curve;
+
+    private:
+        HardwareSerial *serial;
+        std::string frame;
+        std::mt19937 random;
+        Faults faults;
+        Counters counters;
+        uint64_t latency = 50000;
+        uint64_t jitter = 20000;
+        long utcOffset = 3600;
+
+        Curve pvCurve;
+        Curve loadCurve;
+        OutputPriority priority = SolarFirst;
+        double batteryCapacity = 4800; // Wh
+        double maxCharge = 3000;       // W
+        double cutoffSoc = 25;         // SBU falls back to utility below
+        double soc = 60;
+        double pvPower = 0;
+        double pvAvailable = 0;
+        double load = 0;
+        double batteryPower = 0; // + charging
+        double gridEnergy = 0;   // Wh taken from utility
+        std::map<std::string, double> pvEnergy; // Wh per local "yyyymmddhh"
+        uint64_t updatedAt = 0;
+        bool isUpdated = false;
+
+        void handleFrame(const std::string &frame);
+        std::string execute(const std::string &command);
+        std::string qpigs();
+        std::string energy(const std::string &prefix, double divider);
+        void reply(std::string data);
+        void step(time_t local, double seconds);
+        time_t localTime();
+        bool chance(double rate);
+
+    public:
+        InverterSimulator(HardwareSerial *serial, uint32_t seed = 1);
+
+        void onReceive(uint8_t c) override;
+
+        // reply latency, uniformly latency..latency + jitter [us]
+        void setLatency(uint64_t latency, uint64_t jitter = 0) { this->latency = latency; this->jitter = jitter; }
+        void setFaults(const Faults &faults) { this->faults = faults; }
+        void setUtcOffset(long seconds) { utcOffset = seconds; }
+        void setPvCurve(Curve curve) { pvCurve = curve; }
+        void setLoadCurve(Curve curve) { loadCurve = curve; }
+        void setBattery(double capacity, double soc) { batteryCapacity = capacity; this->soc = soc; }
+        void setPriority(OutputPriority priority) { this->priority = priority; }
+
+        // brings the plant up to the current virtual time, done before every reply
+        void update();
+
+        OutputPriority getPriority() const { return priority; }
+        double getSoc() const { return soc; }
+        double getPvPower() const { return pvPower; }
+        double getPvVoltage() const;
+        double getLoad() const { return load; }
+        double getGridEnergy() const { return gridEnergy; }
+        double getPvEnergy() const;
+        const Counters &getCounters() const { return counters; }
+
+        // clear sky day, peak [W] at local noon between sunrise and sunset hours, scaled by
+        // a per-day cloud factor in [1 - cloudiness, 1] and some minute to minute noise
+        static Curve sunnyDays(double peak, double sunrise = 6, double sunset = 19, double cloudiness = 0, uint32_t seed = 1);
+        static Curve constantLoad(double load, double spread = 0, uint32_t seed = 1);
+        static uint16_t crc(const std::string &data);
+};
@@ -0,0 +1,106 @@
+#ifndef ACUPROTOCOL_H
+#define ACUPROTOCOL_H
+
+// Shared by acu_driver8266 and acu_driver_promini, both build from this copy.
+//
+// Frame: ACU_FRAME_START, type, payload length, payload, crc8 of type..payload
+
+#include <Arduino.h>
+
+#define ACU_BAUD_RATE 9600
+#define ACU_FRAME_START 0xA5
+#define ACU_MAX_PAYLOAD 8
+
+#define ACU_GET_VALUE 0x01
+#define ACU_VALUE 0x81 // payload: uint16 value (14 bit), uint16 samples per value
+
+class AcuFrame
+{
+private:
+    byte state = 0;
+    byte index = 0;
+    byte crc = 0;
+
+    static byte crc8(byte crc, byte data)
+    {
+        crc ^= data;
+        for (byte i = 0; i < 8; i++)
+        {
+            crc = crc & 0x80 ? (crc << 1) ^ 0x07 : crc << 1;
+        }
+
+        return crc;
+    }
+
+public:
+    byte type = 0;
+    byte length = 0;
+    byte payload[ACU_MAX_PAYLOAD];
+
+    // Returns true when a complete frame with a valid crc was received.
+    bool parse(byte data)
+    {
+        switch (this->state)
+        {
+        case 0:
+            if (data == ACU_FRAME_START)
+            {
+                this->state = 1;
+            }
+            return false;
+
+        case 1:
+            this->type = data;
+            this->crc = crc8(0, data);
+            this->state = 2;
+            return false;
+
+        case 2:
+            if (data > ACU_MAX_PAYLOAD)
+            {
+                this->state = 0;
+                return false;
+            }
+
+            this->length = data;
+            this->crc = crc8(this->crc, data);
+            this->index = 0;
+            this->state = data > 0 ? 3 : 4;
+            return false;
+
+        case 3:
+            this->payload[this->index++] = data;
+            this->crc = crc8(this->crc, data);
+            if (this->index == this->length)
+            {
+                this->state = 4;
+            }
+            return false;
+
+        default:
+            this->state = 0;
+            return data == this->crc;
+        }
+    }
+
+    uint16_t getUInt16(byte offset)
+    {
+        return this->payload[offset] | (this->payload[offset + 1] << 8);
+    }
+
+    static void send(Stream &stream, byte type, const byte *payload, byte length)
+    {
+        byte crc = crc8(crc8(0, type), length);
+        stream.write(ACU_FRAME_START);
+        stream.write(type);
+        stream.write(length);
+        for (byte i = 0; i < length; i++)
+        {
+            stream.write(payload[i]);
+            crc = crc8(crc, payload[i]);
+        }
+        stream.write(crc);
+    }
+};
+
+#endif
@@ -0,0 +1,142 @@
+#include "LedFader.h"
+
+// CIE 1931 lightness to luminance for levels 0-255, scaled to 16 bits
+static const uint16_t cieTable[256] PROGMEM = {
+  0, 28, 57, 85, 114, 142, 171, 199, 228, 256, 285, 313, 341, 370, 398, 427,
+  455, 484, 512, 541, 569, 598, 627, 658, 689, 721, 755, 789, 825, 861, 899, 937,
+  977, 1018, 1060, 1103, 1147, 1192, 1239, 1287, 1336, 1386, 1437, 1490, 1544, 1599, 1656, 1714,
+  1773, 1834, 1896, 1959, 2024, 2090, 2157, 2226, 2297, 2369, 2442, 2517, 2593, 2671, 2751, 2832,
+  2914, 2999, 3085, 3172, 3261, 3352, 3444, 3538, 3634, 3732, 3831, 3932, 4035, 4139, 4245, 4354,
+  4464, 4575, 4689, 4804, 4922, 5041, 5162, 5285, 5410, 5537, 5666, 5797, 5930, 6065, 6202, 6341,
+  6482, 6626, 6771, 6918, 7068, 7220, 7373, 7529, 7687, 7848, 8010, 8175, 8342, 8512, 8683, 8857,
+  9033, 9212, 9393, 9576, 9762, 9949, 10140, 10333, 10528, 10725, 10926, 11128, 11333, 11541, 11751, 11963,
+  12179, 12396, 12617, 12840, 13065, 13293, 13524, 13757, 13993, 14232, 14474, 14718, 14965, 15215, 15467, 15722,
+  15980, 16241, 16505, 16771, 17041, 17313, 17588, 17866, 18147, 18431, 18717, 19007, 19300, 19596, 19894, 20196,
+  20501, 20809, 21119, 21433, 21750, 22071, 22394, 22720, 23050, 23383, 23719, 24058, 24400, 24746, 25095, 25447,
+  25802, 26161, 26523, 26888, 27257, 27629, 28004, 28383, 28765, 29151, 29540, 29932, 30328, 30728, 31131, 31537,
+  31947, 32360, 32777, 33198, 33622, 34050, 34481, 34916, 35355, 35797, 36243, 36693, 37146, 37603, 38064, 38529,
+  38997, 39469, 39945, 40425, 40908, 41396, 41887, 42382, 42881, 43384, 43891, 44401, 44916, 45435, 45957, 46484,
+  47015, 47549, 48088, 48631, 49178, 49728, 50283, 50843, 51406, 51973, 52545, 53120, 53700, 54284, 54873, 55465,
+  56062, 56663, 57269, 57878, 58492, 59111, 59733, 60360, 60992, 61627, 62268, 62912, 63561, 64215, 64873, 65535,
+};
+
+LedFader::LedFader(const int pins[], byte pinsCount)
+{
+  this->pins = pins;
+  this->pinsCount = pinsCount > FADER_MAX_PINS ? FADER_MAX_PINS : pinsCount;
+}
+
+void LedFader::setup()
+{
+  for (byte i = 0; i < this->pinsCount; i++)
+  {
+    pinMode(this->pins[i], OUTPUT);
+    digitalWrite(this->pins[i], LOW);
+  }
+
+  // fast PWM with ICR1 as top (mode 14), no prescaler, outputs connected in write()
+  TCCR1A = _BV(WGM11);
+  TCCR1B = _BV(WGM13) | _BV(WGM12) | _BV(CS10);
+  ICR1 = (uint16_t)((1UL << FADER_PWM_BITS) - 1);
+}
+
+void LedFader::write(uint16_t duty)
+{
+  for (byte i = 0; i < this->pinsCount; i++)
+  {
+    int pin = this->pins[i];
+    if (pin != 9 && pin != 10)
+    {
+      analogWrite(pin, duty >> (FADER_PWM_BITS - 8));
+      continue;
+    }
+
+    // compare output off at 0, fast PWM would still pulse once per period
+    byte output = pin == 9 ? _BV(COM1A1) : _BV(COM1B1);
+    if (duty == 0)
+    {
+      TCCR1A &= ~output;
+      digitalWrite(pin, LOW);
+    }
+    else if (pin == 9)
+    {
+      OCR1A = duty;
+      TCCR1A |= output;
+    }
+    else
+    {
+      OCR1B = duty;
+      TCCR1A |= output;
+    }
+  }
+}
+
+void LedFader::fadeTo(byte level, unsigned int duration)
+{
+  this->from = this->level;
+  this->to = (uint16_t)level << 8;
+  this->startedAt = millis();
+  this->duration = duration;
+  this->updatedAt = this->startedAt - 1;
+}
+
+void LedFader::set(byte level)
+{
+  this->fadeTo(level, 0);
+  this->from = this->to;
+  this->level = this->to;
+}
+
+void LedFader::update()
+{
+  unsigned long now = millis();
+  if (now == this->updatedAt)
+  {
+    return;
+  }
+  this->updatedAt = now;
+
+  unsigned long elapsed = now - this->startedAt;
+  if (this->duration == 0 || elapsed >= this->duration)
+  {
+    this->level = this->to;
+  }
+  else
+  {
+    long distance = (long)this->to - (long)this->from;
+    this->level = this->from + distance * (long)elapsed / (long)this->duration;
+  }
+
+  uint16_t duty = toDuty(this->level);
+  if (duty != this->duty)
+  {
+    this->duty = duty;
+    this->write(duty);
+  }
+}
+
+byte LedFader::getLevel()
+{
+  return this->level >> 8;
+}
+
+byte LedFader::getTarget()
+{
+  return this->to >> 8;
+}
+
+bool LedFader::isFading()
+{
+  return this->level != this->to;
+}
+
+uint16_t LedFader::toDuty(uint16_t level)
+{
+  byte index = level >> 8;
+  byte fraction = level & 0xFF;
+  uint16_t low = pgm_read_word(&cieTable[index]);
+  uint16_t high = index < 255 ? pgm_read_word(&cieTable[index + 1]) : low;
+  uint16_t value = low + (uint16_t)(((uint32_t)(high - low) * fraction) >> 8);
+
+  return value >> (16 - FADER_PWM_BITS);
+}
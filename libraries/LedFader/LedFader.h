@@ -0,0 +1,54 @@
+#ifndef LEDFADER_H
+#define LEDFADER_H
+
+#include <Arduino.h>
+
+#define FADER_MAX_PINS 2
+
+// Timer1 top, 16-bit at 244Hz on 16MHz boards, 15-bit keeps 244Hz on 8MHz ones
+#if F_CPU > 8000000L
+#define FADER_PWM_BITS 16
+#else
+#define FADER_PWM_BITS 15
+#endif
+
+/*
+LED brightness on Timer1 fast PWM (pins 9 and 10 on the ATmega328) with the levels mapped
+through a CIE 1931 lightness table, so equal level steps look equal and the low end gets
+the full 16-bit resolution. Other pins fall back to 8-bit analogWrite.
+
+fadeTo() moves from the current level to the target in the given time whatever the
+distance, the level is kept in 8.8 fixed point and interpolated between table entries.
+update() recalculates it at most once per millisecond and only touches the timer when the
+duty cycle changes.
+*/
+class LedFader
+{
+private:
+  const int *pins;
+  byte pinsCount;
+  uint16_t from = 0;
+  uint16_t to = 0;
+  uint16_t level = 0;
+  uint16_t duty = 0;
+  unsigned long startedAt = 0;
+  unsigned int duration = 0;
+  unsigned long updatedAt = 0;
+
+  void write(uint16_t duty);
+
+public:
+  LedFader(const int pins[], byte pinsCount);
+  void setup();
+  void fadeTo(byte level, unsigned int duration);
+  void set(byte level);
+  void update();
+  byte getLevel();
+  byte getTarget();
+  bool isFading();
+
+  // 8.8 fixed point level to a duty cycle of FADER_PWM_BITS
+  static uint16_t toDuty(uint16_t level);
+};
+
+#endif
@@ -0,0 +1,146 @@
+#include "Metrics.h"
+
+#ifdef METRICS_ENABLED
+
+const uint32_t Histogram::bounds[METRICS_BUCKETS - 1] = {50, 100, 250, 500, 1000, 2500, 5000, 10000, 25000, 50000, 100000};
+
+const char *Metrics::SCOPE = "scope";
+const char *Metrics::HANDLER = "handler";
+Histogram *Metrics::histograms[METRICS_MAX_HISTOGRAMS];
+byte Metrics::count = 0;
+Histogram Metrics::loopHistogram("loop", "");
+Histogram Metrics::sleepHistogram("sleep", "");
+uint32_t Metrics::lastLoop = 0;
+uint32_t Metrics::loopEnd = 0;
+bool Metrics::isLoopEnded = false;
+uint32_t Metrics::minFreeHeap = 0;
+
+Histogram::Histogram(const char *family, const char *name) : family(family), name(name)
+{
+    memset(buckets, 0, sizeof(buckets));
+}
+
+void Histogram::add(uint32_t value)
+{
+    byte i = 0;
+    while(i < METRICS_BUCKETS - 1 && value > bounds[i])
+    {
+        i++;
+    }
+
+    buckets[i]++;
+    count++;
+    sum += value;
+}
+
+void Histogram::print(String &out)
+{
+    String metric = String(family) + "_duration_us";
+    String label = strlen(name) > 0 ? String(family) + "=\"" + name + "\"," : "";
+
+    uint32_t total = 0;
+    for(byte i = 0; i < METRICS_BUCKETS; i++)
+    {
+        total += buckets[i];
+        String le = i < METRICS_BUCKETS - 1 ? String(bounds[i]) : "+Inf";
+        out += metric + "_bucket{" + label + "le=\"" + le + "\"} " + String(total) + "\n";
+    }
+
+    label = strlen(name) > 0 ? "{" + String(family) + "=\"" + name + "\"}" : "";
+    out += metric + "_sum" + label + " " + String((double)sum, 0) + "\n";
+    out += metric + "_count" + label + " " + String(count) + "\n";
+}
+
+MetricsScope::~MetricsScope()
+{
+    if(histogram != nullptr)
+    {
+        histogram->add((ESP.getCycleCount() - start) / ESP.getCpuFreqMHz());
+    }
+}
+
+Histogram *Metrics::get(const char *family, const char *name)
+{
+    for(byte i = 0; i < count; i++)
+    {
+        if(histograms[i]->is(family, name))
+        {
+            return histograms[i];
+        }
+    }
+
+    if(count >= METRICS_MAX_HISTOGRAMS)
+    {
+        return nullptr;
+    }
+
+    histograms[count] = new Histogram(family, name);
+    return histograms[count++];
+}
+
+void Metrics::loop()
+{
+    uint32_t now = ESP.getCycleCount();
+    if(isLoopEnded)
+    {
+        sleepHistogram.add((now - loopEnd) / ESP.getCpuFreqMHz());
+    }
+    else if(lastLoop != 0)
+    {
+        loopHistogram.add((now - lastLoop) / ESP.getCpuFreqMHz());
+    }
+    lastLoop = now;
+    isLoopEnded = false;
+
+    uint32_t freeHeap = ESP.getFreeHeap();
+    if(minFreeHeap == 0 || freeHeap < minFreeHeap)
+    {
+        minFreeHeap = freeHeap;
+    }
+}
+
+void Metrics::endLoop()
+{
+    loopEnd = ESP.getCycleCount();
+    if(lastLoop != 0 && !isLoopEnded)
+    {
+        loopHistogram.add((loopEnd - lastLoop) / ESP.getCpuFreqMHz());
+    }
+    isLoopEnded = true;
+}
+
+String Metrics::toString()
+{
+    String out;
+
+    out += "# TYPE loop_duration_us histogram\n";
+    loopHistogram.print(out);
+    if(sleepHistogram.getCount() > 0)
+    {
+        out += "# TYPE sleep_duration_us histogram\n";
+        sleepHistogram.print(out);
+    }
+
+    const char *families[] = {SCOPE, HANDLER};
+    for(const char *family : families)
+    {
+        out += "# TYPE " + String(family) + "_duration_us histogram\n";
+        for(byte i = 0; i < count; i++)
+        {
+            if(strcmp(histograms[i]->getFamily(), family) == 0)
+            {
+                histograms[i]->print(out);
+            }
+        }
+    }
+
+    out += "# TYPE heap_free_bytes gauge\nheap_free_bytes " + String(ESP.getFreeHeap()) + "\n";
+    out += "# TYPE heap_min_free_bytes gauge\nheap_min_free_bytes " + String(minFreeHeap) + "\n";
+    out += "# TYPE heap_max_free_block_bytes gauge\nheap_max_free_block_bytes " + String(ESP.getMaxFreeBlockSize()) + "\n";
+    out += "# TYPE heap_fragmentation_percent gauge\nheap_fragmentation_percent " + String(ESP.getHeapFragmentation()) + "\n";
+    out += "# TYPE uptime_seconds counter\nuptime_seconds " + String(millis() / 1000) + "\n";
+
+    return out;
+}
+
+#endif
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <Arduino.h>
+
+/*
+Loop, handler and hot path timing plus heap gauges, exported in Prometheus text format.
+Everything compiles out unless METRICS_ENABLED is defined (build_flags = -DMETRICS_ENABLED).
+
+    METRICS_LOOP();                     // first line of loop(), records the previous iteration
+    METRICS_LOOP_END();                 // before a deliberate sleep, which is reported as sleep
+    METRICS_SCOPE("readParams");        // times the rest of the enclosing block
+    METRICS_HANDLER("root");            // same, reported as handler latency
+    METRICS_SETUP(&server);             // registers /metrics on an AsyncWebServer
+
+No dependencies beyond the core: METRICS_SETUP expands where it is used, so only sketches
+with an AsyncWebServer need ESPAsyncWebServer, others serve Metrics::toString() themselves.
+*/
+
+#ifdef METRICS_ENABLED
+
+#define METRICS_MAX_HISTOGRAMS 16
+#define METRICS_BUCKETS 12
+
+class Histogram
+{
+    private:
+        const char *family;
+        const char *name;
+        uint32_t buckets[METRICS_BUCKETS];
+        uint32_t count = 0;
+        uint64_t sum = 0;
+
+    public:
+        static const uint32_t bounds[METRICS_BUCKETS - 1];
+
+        Histogram(const char *family, const char *name);
+        void add(uint32_t value);
+        bool is(const char *family, const char *name) { return strcmp(this->family, family) == 0 && strcmp(this->name, name) == 0; }
+        void print(String &out);
+        const char *getFamily() { return family; }
+        uint32_t getCount() { return count; }
+};
+
+class MetricsScope
+{
+    private:
+        Histogram *histogram;
+        uint32_t start;
+
+    public:
+        MetricsScope(Histogram *histogram) : histogram(histogram), start(ESP.getCycleCount()) {}
+        ~MetricsScope();
+};
+
+class Metrics
+{
+    private:
+        static Histogram *histograms[METRICS_MAX_HISTOGRAMS];
+        static byte count;
+        static Histogram loopHistogram;
+        static Histogram sleepHistogram;
+        static uint32_t lastLoop;
+        static uint32_t loopEnd;
+        static bool isLoopEnded;
+        static uint32_t minFreeHeap;
+
+    public:
+        static const char *SCOPE;
+        static const char *HANDLER;
+
+        static Histogram *get(const char *family, const char *name);
+        static void loop();
+        static void endLoop();
+        static String toString();
+};
+
+#define METRICS_CONCAT_(a, b) a##b
+#define METRICS_CONCAT(a, b) METRICS_CONCAT_(a, b)
+#define METRICS_TIMED(family, name) \
+    static Histogram *METRICS_CONCAT(metricsHistogram, __LINE__) = Metrics::get(family, name); \
+    MetricsScope METRICS_CONCAT(metricsScope, __LINE__)(METRICS_CONCAT(metricsHistogram, __LINE__))
+
+#define METRICS_SCOPE(name) METRICS_TIMED(Metrics::SCOPE, name)
+#define METRICS_HANDLER(name) METRICS_TIMED(Metrics::HANDLER, name)
+#define METRICS_LOOP() Metrics::loop()
+#define METRICS_LOOP_END() Metrics::endLoop()
+#define METRICS_SETUP(server) \
+    (server)->on("/metrics", [](AsyncWebServerRequest *request) { \
+        request->send(200, "text/plain; version=0.0.4", Metrics::toString()); \
+    })
+
+#else
+
+#define METRICS_SCOPE(name)
+#define METRICS_HANDLER(name)
+#define METRICS_LOOP()
+#define METRICS_LOOP_END()
+#define METRICS_SETUP(server)
+
+#endif
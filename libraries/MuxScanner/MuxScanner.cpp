@@ -0,0 +1,139 @@
+#include "MuxScanner.h"
+
+#include <avr/interrupt.h>
+
+MuxScanner *MuxScanner::instance = nullptr;
+
+ISR(ADC_vect)
+{
+  MuxScanner::onConversion();
+}
+
+MuxScanner::MuxScanner(const byte selectPins[], byte analogPin, byte filterShift, byte settle)
+{
+  for (byte i = 0; i < 3; i++)
+  {
+    this->selectPins[i] = selectPins[i];
+  }
+  this->analogPin = analogPin >= A0 ? analogPin - A0 : analogPin;
+  this->filterShift = filterShift;
+  this->settle = settle;
+}
+
+bool MuxScanner::begin()
+{
+  byte selectPort = digitalPinToPort(this->selectPins[0]);
+  this->selectMask = 0;
+  for (byte i = 0; i < 3; i++)
+  {
+    if (digitalPinToPort(this->selectPins[i]) != selectPort)
+    {
+      return false;
+    }
+    pinMode(this->selectPins[i], OUTPUT);
+    this->selectMask |= digitalPinToBitMask(this->selectPins[i]);
+  }
+
+  // port bits of every channel number, so a switch is a single write
+  for (byte channel = 0; channel < MUX_CHANNELS; channel++)
+  {
+    this->selectBits[channel] = 0;
+    for (byte i = 0; i < 3; i++)
+    {
+      if (bitRead(channel, i))
+      {
+        this->selectBits[channel] |= digitalPinToBitMask(this->selectPins[i]);
+      }
+    }
+  }
+  this->port = portOutputRegister(selectPort);
+
+  MuxScanner::instance = this;
+  this->primed = 0;
+  this->scans = 0;
+  this->channel = 0;
+  this->discard = this->settle;
+  this->select(0);
+
+  ADMUX = _BV(REFS0) | (this->analogPin & 0x07);
+  ADCSRA = _BV(ADEN) | _BV(ADIE) | _BV(ADPS2) | _BV(ADPS1) | _BV(ADPS0) | _BV(ADSC);
+
+  return true;
+}
+
+void MuxScanner::stop()
+{
+  ADCSRA &= ~_BV(ADIE);
+  while (bit_is_set(ADCSRA, ADSC))
+    ;
+}
+
+void MuxScanner::select(byte channel)
+{
+  *this->port = (*this->port & ~this->selectMask) | this->selectBits[channel];
+}
+
+void MuxScanner::onConversion()
+{
+  MuxScanner *scanner = MuxScanner::instance;
+  int sample = ADC;
+
+  if (scanner->discard > 0)
+  {
+    scanner->discard--;
+    ADCSRA |= _BV(ADSC);
+    return;
+  }
+
+  byte channel = scanner->channel;
+  byte next = (channel + 1) % MUX_CHANNELS;
+  scanner->select(next);
+  ADCSRA |= _BV(ADSC);
+
+  uint16_t value = sample << 4;
+  if (bitRead(scanner->primed, channel))
+  {
+    int change = (int)value - (int)scanner->values[channel];
+    scanner->values[channel] += change >> scanner->filterShift;
+  }
+  else
+  {
+    scanner->values[channel] = value;
+    bitSet(scanner->primed, channel);
+  }
+
+  scanner->channel = next;
+  scanner->discard = scanner->settle;
+  if (next == 0)
+  {
+    scanner->scans++;
+  }
+}
+
+bool MuxScanner::isReady()
+{
+  return this->primed == 0xFF;
+}
+
+int MuxScanner::getValue(byte channel)
+{
+  if (channel >= MUX_CHANNELS)
+  {
+    return 0;
+  }
+
+  noInterrupts();
+  uint16_t value = this->values[channel];
+  interrupts();
+
+  return (value + 8) >> 4;
+}
+
+unsigned int MuxScanner::getScans()
+{
+  noInterrupts();
+  unsigned int scans = this->scans;
+  interrupts();
+
+  return scans;
+}
@@ -0,0 +1,58 @@
+#ifndef MUXSCANNER_H
+#define MUXSCANNER_H
+
+#include <Arduino.h>
+
+#define MUX_CHANNELS 8
+#define MUX_FILTER_SHIFT 3 // average over ~8 scans
+
+/*
+Scan of the 8 inputs of a CD4051 on one analog pin, run by the ADC conversion interrupt.
+Every interrupt takes the result, switches the select lines to the next channel with one
+write of their port and starts the next conversion, the filter of the finished channel is
+updated while that one runs. The loop only reads the table, a full scan takes ~1ms.
+
+The ADC samples 1.5 ADC clocks (12us at 125kHz) after the start, that settles sources of
+up to ~10k through the multiplexer. Sensors of higher impedance get settle conversions
+thrown away after each switch, each one adds 104us.
+
+Values are an exponential average over 2^filterShift scans, kept in 1/16 of a step. The
+select pins can be any pins of one port, the ADC and its interrupt belong to the scanner
+until stop(), analogRead() cannot be used meanwhile. One instance.
+*/
+class MuxScanner
+{
+private:
+  byte selectPins[3];
+  byte analogPin;
+  byte filterShift;
+  byte settle;
+  volatile uint8_t *port = nullptr;
+  byte selectMask = 0;
+  byte selectBits[MUX_CHANNELS];
+  volatile uint16_t values[MUX_CHANNELS];
+  volatile byte primed = 0;
+  volatile byte channel = 0;
+  volatile byte discard = 0;
+  volatile unsigned int scans = 0;
+
+  void select(byte channel);
+
+  static MuxScanner *instance;
+
+public:
+  // selectPins are S0 (A), S1 (B), S2 (C)
+  MuxScanner(const byte selectPins[], byte analogPin, byte filterShift = MUX_FILTER_SHIFT, byte settle = 0);
+  // false when the select pins are not on one port
+  bool begin();
+  void stop();
+  // every channel was read at least once
+  bool isReady();
+  int getValue(byte channel);
+  // full scans since begin(), wraps
+  unsigned int getScans();
+
+  static void onConversion();
+};
+
+#endif
@@ -0,0 +1,164 @@
+#include "SettingsStore.h"
+
+SettingsStore::SettingsStore(int address, byte slots, byte size)
+{
+  this->address = address;
+  this->slots = constrain(slots, 1, SETTINGS_MAX_SLOTS);
+  this->size = size;
+}
+
+int SettingsStore::slotAddress(byte slot)
+{
+  return this->address + slot * (this->size + 2);
+}
+
+bool SettingsStore::isValid(byte slot)
+{
+  int start = this->slotAddress(slot);
+  byte crc = SETTINGS_CRC_INIT;
+  for (byte i = 0; i < this->size + 1; i++)
+  {
+    crc = crc8(crc, EEPROM.read(start + i));
+  }
+
+  return crc == EEPROM.read(start + this->size + 1);
+}
+
+bool SettingsStore::equals(byte slot, const byte *data)
+{
+  int start = this->slotAddress(slot) + 1;
+  for (byte i = 0; i < this->size; i++)
+  {
+    if (EEPROM.read(start + i) != data[i])
+    {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+bool SettingsStore::load(void *data)
+{
+  // the newest valid slot is the one whose sequence number has no successor
+  uint32_t valid = 0;
+  for (byte i = 0; i < this->slots; i++)
+  {
+    if (this->isValid(i))
+    {
+      bitSet(valid, i);
+    }
+  }
+
+  this->newest = 0xFF;
+  for (byte i = 0; i < this->slots && this->newest == 0xFF; i++)
+  {
+    if (!bitRead(valid, i))
+    {
+      continue;
+    }
+
+    byte next = EEPROM.read(this->slotAddress(i)) + 1;
+    bool hasSuccessor = false;
+    for (byte j = 0; j < this->slots; j++)
+    {
+      if (bitRead(valid, j) && j != i && EEPROM.read(this->slotAddress(j)) == next)
+      {
+        hasSuccessor = true;
+        break;
+      }
+    }
+
+    if (!hasSuccessor)
+    {
+      this->newest = i;
+    }
+  }
+
+  if (this->newest == 0xFF)
+  {
+    return false;
+  }
+
+  int start = this->slotAddress(this->newest);
+  this->sequence = EEPROM.read(start);
+  for (byte i = 0; i < this->size; i++)
+  {
+    ((byte *)data)[i] = EEPROM.read(start + 1 + i);
+  }
+
+  return true;
+}
+
+bool SettingsStore::save(const void *data)
+{
+  const byte *bytes = (const byte *)data;
+  this->isDirty = false;
+
+  if (this->newest != 0xFF && this->equals(this->newest, bytes))
+  {
+    return false;
+  }
+
+  byte slot = this->newest == 0xFF ? 0 : (this->newest + 1) % this->slots;
+  byte sequence = this->newest == 0xFF ? 0 : this->sequence + 1;
+  int start = this->slotAddress(slot);
+
+  // crc last, a reset in between leaves an invalid slot and the previous one is used
+  byte crc = crc8(SETTINGS_CRC_INIT, sequence);
+  EEPROM.update(start, sequence);
+  for (byte i = 0; i < this->size; i++)
+  {
+    EEPROM.update(start + 1 + i, bytes[i]);
+    crc = crc8(crc, bytes[i]);
+  }
+  EEPROM.update(start + this->size + 1, crc);
+
+  this->newest = slot;
+  this->sequence = sequence;
+  this->saves++;
+
+  return true;
+}
+
+void SettingsStore::changed()
+{
+  this->isDirty = true;
+  this->changedAt = millis();
+}
+
+void SettingsStore::handle(const void *data)
+{
+  if (this->isDirty && millis() - this->changedAt >= SETTINGS_SAVE_DELAY)
+  {
+    this->save(data);
+  }
+}
+
+bool SettingsStore::isPending()
+{
+  return this->isDirty;
+}
+
+unsigned int SettingsStore::getSaves()
+{
+  return this->saves;
+}
+
+int SettingsStore::getLength()
+{
+  return this->slots * (this->size + 2);
+}
+
+// Dallas/Maxim CRC-8, started from SETTINGS_CRC_INIT so erased (0xFF) or zeroed slots of up
+// to 8 data bytes never pass
+byte SettingsStore::crc8(byte crc, byte value)
+{
+  crc ^= value;
+  for (byte i = 0; i < 8; i++)
+  {
+    crc = crc & 0x01 ? (crc >> 1) ^ 0x8C : crc >> 1;
+  }
+
+  return crc;
+}
@@ -0,0 +1,52 @@
+#ifndef SETTINGSSTORE_H
+#define SETTINGSSTORE_H
+
+#include <Arduino.h>
+#include <EEPROM.h>
+
+#define SETTINGS_SAVE_DELAY 1500 // ms without changes before a save
+#define SETTINGS_MAX_SLOTS 32
+#define SETTINGS_CRC_INIT 0x5A
+
+/*
+Settings block kept in a ring of EEPROM slots, each slot is [sequence][data...][crc8].
+A save goes to the slot after the newest one with the next sequence number, so every slot
+takes 1/slots of the writes, and only bytes that differ are written (EEPROM.update). The
+newest slot with a valid CRC is loaded, a save torn by a reset leaves the previous one.
+
+changed() marks the settings as modified, handle() saves them once they stayed unchanged
+for SETTINGS_SAVE_DELAY, so holding a button stores the final value only.
+*/
+class SettingsStore
+{
+private:
+  int address;
+  byte slots;
+  byte size;
+  byte newest = 0xFF;
+  byte sequence = 0;
+  bool isDirty = false;
+  unsigned long changedAt = 0;
+  unsigned int saves = 0;
+
+  int slotAddress(byte slot);
+  bool isValid(byte slot);
+  bool equals(byte slot, const byte *data);
+
+public:
+  SettingsStore(int address, byte slots, byte size);
+  // false when no slot is valid, data is left as it is
+  bool load(void *data);
+  // false when the newest slot already holds data
+  bool save(const void *data);
+  void changed();
+  void handle(const void *data);
+  bool isPending();
+  unsigned int getSaves();
+  // EEPROM bytes taken by the ring
+  int getLength();
+
+  static byte crc8(byte crc, byte value);
+};
+
+#endif
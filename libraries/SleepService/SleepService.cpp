@@ -0,0 +1,147 @@
+#include "SleepService.h"
+
+#include <avr/interrupt.h>
+#include <avr/power.h>
+#include <avr/sleep.h>
+#include <avr/wdt.h>
+
+static volatile bool hasWatchdogFired = false;
+static unsigned long watchdogStep = WATCHDOG_NOMINAL_STEP;
+
+// the wakeup is all that is needed, the loop reads the pins itself
+EMPTY_INTERRUPT(PCINT0_vect);
+EMPTY_INTERRUPT(PCINT1_vect);
+EMPTY_INTERRUPT(PCINT2_vect);
+
+ISR(WDT_vect)
+{
+  hasWatchdogFired = true;
+}
+
+void SleepService::begin()
+{
+  power_spi_disable();
+  power_twi_disable();
+}
+
+void SleepService::wakeOnPin(byte pin)
+{
+  volatile uint8_t *mask = digitalPinToPCMSK(pin);
+  if (mask == 0)
+  {
+    return;
+  }
+
+  *mask |= _BV(digitalPinToPCMSKbit(pin));
+  PCIFR |= _BV(digitalPinToPCICRbit(pin));
+  PCICR |= _BV(digitalPinToPCICRbit(pin));
+}
+
+void SleepService::idle()
+{
+  set_sleep_mode(SLEEP_MODE_IDLE);
+  sleep_enable();
+  sei();
+  sleep_cpu();
+  sleep_disable();
+}
+
+void SleepService::powerDown()
+{
+  byte adc = ADCSRA;
+  ADCSRA &= ~_BV(ADEN);
+
+  set_sleep_mode(SLEEP_MODE_PWR_DOWN);
+  sleep_enable();
+#ifdef sleep_bod_disable
+  sleep_bod_disable();
+#endif
+  // the instruction after sei always runs, a pending pin change wakes it right after
+  sei();
+  sleep_cpu();
+  sleep_disable();
+
+  ADCSRA = adc;
+}
+
+unsigned long SleepService::powerDownFor(unsigned long ms)
+{
+  unsigned long slept = 0;
+  while (true)
+  {
+    byte prescaler = WATCHDOG_MAX_PRESCALER;
+    while (prescaler > 0 && stepLength(prescaler) > ms - slept)
+    {
+      prescaler--;
+    }
+
+    unsigned long length = stepLength(prescaler);
+    if (length > ms - slept)
+    {
+      return slept;
+    }
+
+    noInterrupts();
+    hasWatchdogFired = false;
+    startWatchdog(prescaler);
+    powerDown();
+    wdt_disable();
+
+    // a pin woke it part way through the step, the caller has work to do
+    if (!hasWatchdogFired)
+    {
+      return slept;
+    }
+    slept += length;
+  }
+}
+
+void SleepService::calibrate()
+{
+  byte tccr1a = TCCR1A;
+  byte tccr1b = TCCR1B;
+  byte timsk1 = TIMSK1;
+  TIMSK1 = 0;
+  TCCR1A = 0;
+  TCCR1B = _BV(CS12) | _BV(CS10); // F_CPU / 1024, 64us per tick on 16MHz
+
+  noInterrupts();
+  hasWatchdogFired = false;
+  startWatchdog(WATCHDOG_CALIBRATION);
+  TCNT1 = 0;
+  // checked with interrupts off, the watchdog firing after the check wakes idle() at once
+  while (!hasWatchdogFired)
+  {
+    idle();
+    noInterrupts();
+  }
+  uint16_t ticks = TCNT1;
+  interrupts();
+  wdt_disable();
+
+  TCCR1B = tccr1b;
+  TCCR1A = tccr1a;
+  TIMSK1 = timsk1;
+
+  watchdogStep = (ticks * (1024000000UL / F_CPU)) >> WATCHDOG_CALIBRATION;
+}
+
+unsigned long SleepService::getWatchdogStep()
+{
+  return watchdogStep;
+}
+
+// called with interrupts disabled, WDCE opens a window of four cycles
+void SleepService::startWatchdog(byte prescaler)
+{
+  MCUSR &= ~_BV(WDRF);
+  wdt_reset();
+  WDTCSR |= _BV(WDCE) | _BV(WDE);
+  WDTCSR = _BV(WDIE) | (prescaler & 0x07) | ((prescaler & 0x08) ? _BV(WDP3) : 0);
+}
+
+// ms of a watchdog period, 16ms << prescaler at the calibrated rate
+unsigned long SleepService::stepLength(byte prescaler)
+{
+  return ((watchdogStep << prescaler) + 500) / 1000;
+}
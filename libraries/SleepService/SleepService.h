@@ -0,0 +1,51 @@
+#ifndef SLEEPSERVICE_H
+#define SLEEPSERVICE_H
+
+#include <Arduino.h>
+
+#define WATCHDOG_MAX_PRESCALER 9 // 8s
+#define WATCHDOG_CALIBRATION 4   // 256ms
+#define WATCHDOG_NOMINAL_STEP 16000 // us, 2048 cycles of 128kHz
+
+/*
+Sleep between events for AVR sketches.
+
+idle() stops the CPU until the next interrupt, Timer0 keeps millis() going and wakes it every
+1ms, Timer1 PWM keeps running. powerDown() stops every clock until a pin registered with
+wakeOnPin() changes level; millis() does not advance while powered down, so it is only for
+periods in which nothing is timed.
+
+Both are called with interrupts disabled after the caller checked that it may sleep, they
+enable them right before sleeping, so an edge after the check wakes the sleep at once instead
+of being serviced unnoticed.
+
+powerDownFor() is power-down for a time, woken by the watchdog in steps of 16ms to 8s. The
+128kHz watchdog oscillator is off by up to 10% and drifts with temperature and supply, so
+calibrate() times one 256ms watchdog period against Timer1 on the crystal and the steps
+are counted at their measured length; calling it before every long sleep keeps hours of
+sleep within a fraction of a percent.
+
+The pin-change and watchdog vectors are defined here, sketches using it cannot use
+SoftwareSerial.
+*/
+class SleepService
+{
+public:
+  // SPI and TWI off, none of the sketches use them
+  static void begin();
+  static void wakeOnPin(byte pin);
+  static void idle();
+  static void powerDown();
+  // sleeps whole watchdog steps up to ms, returns the ms slept, fewer when a pin woke it
+  static unsigned long powerDownFor(unsigned long ms);
+  // Timer1 is borrowed for 256ms and restored
+  static void calibrate();
+  // measured us of the 16ms watchdog step
+  static unsigned long getWatchdogStep();
+
+private:
+  static void startWatchdog(byte prescaler);
+  static unsigned long stepLength(byte prescaler);
+};
+
+#endif
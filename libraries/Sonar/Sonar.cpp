@@ -0,0 +1,155 @@
+#include "Sonar.h"
+
+Sonar *Sonar::instance = nullptr;
+
+Sonar::Sonar(byte trigPin, byte echoPin, unsigned int interval, unsigned int minCm, unsigned int maxCm)
+{
+  this->trigPin = trigPin;
+  this->echoPin = echoPin;
+  this->interval = max(interval, (unsigned int)SONAR_MIN_INTERVAL);
+  this->minEcho = min((unsigned long)minCm * SONAR_US_PER_CM, (unsigned long)SONAR_TIMEOUT);
+  this->maxEcho = min((unsigned long)maxCm * SONAR_US_PER_CM, (unsigned long)SONAR_TIMEOUT);
+}
+
+void Sonar::begin()
+{
+  pinMode(this->trigPin, OUTPUT);
+  digitalWrite(this->trigPin, LOW);
+  pinMode(this->echoPin, INPUT);
+
+  Sonar::instance = this;
+  attachInterrupt(digitalPinToInterrupt(this->echoPin), Sonar::onEcho, CHANGE);
+}
+
+void Sonar::onEcho()
+{
+  Sonar *sonar = Sonar::instance;
+  unsigned long now = micros();
+
+  // edges of an echo that timed out or came before the trigger are ignored
+  if (digitalRead(sonar->echoPin) == HIGH)
+  {
+    if (sonar->state == Waiting)
+    {
+      sonar->echoStart = now;
+      sonar->state = Echo;
+    }
+  }
+  else if (sonar->state == Echo)
+  {
+    sonar->echoLength = now - sonar->echoStart;
+    sonar->state = Done;
+  }
+}
+
+bool Sonar::handle()
+{
+  bool isFinished = false;
+
+  if (this->state == Done)
+  {
+    noInterrupts();
+    unsigned long length = this->echoLength;
+    this->state = Idle;
+    interrupts();
+
+    if (length >= this->minEcho && length <= this->maxEcho)
+    {
+      this->add(length);
+    }
+    else
+    {
+      this->miss();
+    }
+    isFinished = true;
+  }
+  else if (this->state != Idle && micros() - this->triggeredAt > SONAR_TIMEOUT)
+  {
+    // the echo may have ended right now, checked again with the interrupt held off
+    noInterrupts();
+    bool isLost = this->state != Done;
+    if (isLost)
+    {
+      this->state = Idle;
+    }
+    interrupts();
+
+    if (isLost)
+    {
+      this->miss();
+      isFinished = true;
+    }
+  }
+
+  if (this->state == Idle && millis() - this->pingAt >= this->interval)
+  {
+    this->ping();
+  }
+
+  return isFinished;
+}
+
+void Sonar::ping()
+{
+  // the module ignores triggers while it still holds echo from the previous ping
+  if (digitalRead(this->echoPin) == HIGH)
+  {
+    return;
+  }
+
+  this->pingAt = millis();
+  this->state = Waiting;
+  digitalWrite(this->trigPin, HIGH);
+  delayMicroseconds(10);
+  digitalWrite(this->trigPin, LOW);
+  this->triggeredAt = micros();
+}
+
+void Sonar::add(unsigned long length)
+{
+  this->echoes[this->next] = length;
+  this->next = (this->next + 1) % SONAR_WINDOW;
+  if (this->count < SONAR_WINDOW)
+  {
+    this->count++;
+  }
+  this->misses = 0;
+
+  unsigned int sorted[SONAR_WINDOW];
+  for (byte i = 0; i < this->count; i++)
+  {
+    unsigned int value = this->echoes[i];
+    byte j = i;
+    for (; j > 0 && sorted[j - 1] > value; j--)
+    {
+      sorted[j] = sorted[j - 1];
+    }
+    sorted[j] = value;
+  }
+
+  this->median = sorted[this->count / 2];
+}
+
+void Sonar::miss()
+{
+  if (this->misses < SONAR_WINDOW)
+  {
+    this->misses++;
+  }
+
+  if (this->misses == SONAR_WINDOW)
+  {
+    this->count = 0;
+    this->next = 0;
+  }
+}
+
+bool Sonar::isValid()
+{
+  return this->count > 0;
+}
+
+unsigned int Sonar::getDistance()
+{
+  return this->isValid() ? (this->median + SONAR_US_PER_CM / 2) / SONAR_US_PER_CM : 0;
+}
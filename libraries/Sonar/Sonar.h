@@ -0,0 +1,68 @@
+#ifndef SONAR_H
+#define SONAR_H
+
+#include <Arduino.h>
+
+#define SONAR_WINDOW 5        // readings in the median, odd
+#define SONAR_TIMEOUT 30000   // us from the trigger, the module holds echo ~38ms without one
+#define SONAR_US_PER_CM 58    // echo round trip
+#define SONAR_MIN_INTERVAL 60 // ms, echoes of the previous ping die out
+
+/*
+HC-SR04 ranging in the background. handle() sends a trigger pulse every interval, the echo
+pin interrupt timestamps both edges with micros() and handle() picks up the length on a
+later call, the loop never waits for the echo like pulseIn() does.
+
+Echoes outside minCm..maxCm and pings without an echo within SONAR_TIMEOUT are dropped,
+the distance is the median of the last SONAR_WINDOW valid echoes, so single spurious echoes
+do not show. After SONAR_WINDOW dropped pings in a row the distance is invalid until new
+echoes come.
+
+The echo pin must have an external interrupt (2 or 3 on the ATmega328), there is one
+interrupt handler and so one instance.
+*/
+class Sonar
+{
+private:
+  enum State
+  {
+    Idle,
+    Waiting,
+    Echo,
+    Done
+  };
+
+  byte trigPin;
+  byte echoPin;
+  unsigned int interval;
+  unsigned int minEcho;
+  unsigned int maxEcho;
+  volatile State state = Idle;
+  volatile unsigned long echoStart = 0;
+  volatile unsigned long echoLength = 0;
+  unsigned long triggeredAt = 0;
+  unsigned long pingAt = 0;
+  unsigned int echoes[SONAR_WINDOW];
+  byte next = 0;
+  byte count = 0;
+  byte misses = 0;
+  unsigned int median = 0;
+
+  void ping();
+  void add(unsigned long length);
+  void miss();
+
+  static Sonar *instance;
+  static void onEcho();
+
+public:
+  Sonar(byte trigPin, byte echoPin, unsigned int interval, unsigned int minCm = 2, unsigned int maxCm = 400);
+  void begin();
+  // true when a ping finished, with or without a valid echo
+  bool handle();
+  bool isValid();
+  // cm, 0 when not valid
+  unsigned int getDistance();
+};
+
+#endif
@@ -0,0 +1,75 @@
+#include "Telemetry.h"
+#include <limits.h>
+
+bool TelemetryPublisher::publish(const char *topic, const String &data)
+{
+    if(WiFi.status() != WL_CONNECTED)
+    {
+        return false;
+    }
+
+    String header = String(topic) + " " + String(++sequence) + "\n";
+
+    if(!udp.beginPacketMulticast(group, TELEMETRY_PORT, WiFi.localIP()))
+    {
+        return false;
+    }
+
+    udp.write((const uint8_t *)header.c_str(), header.length());
+    udp.write((const uint8_t *)data.c_str(), data.length());
+    return udp.endPacket();
+}
+
+void TelemetrySubscriber::begin()
+{
+    stop();
+    isStarted = udp.beginMulticast(WiFi.localIP(), group, TELEMETRY_PORT);
+}
+
+void TelemetrySubscriber::stop()
+{
+    if(isStarted)
+    {
+        udp.stop();
+        isStarted = false;
+    }
+}
+
+void TelemetrySubscriber::handle()
+{
+    if(!isStarted)
+    {
+        return;
+    }
+
+    int size = udp.parsePacket();
+    if(size <= 0)
+    {
+        return;
+    }
+
+    char buf[TELEMETRY_MAX_PACKET + 1];
+    int len = udp.read(buf, TELEMETRY_MAX_PACKET);
+    if(len <= 0)
+    {
+        return;
+    }
+
+    buf[len] = 0;
+    char *data = strchr(buf, '\n');
+    char *space = strchr(buf, ' ');
+    if(data == nullptr || space == nullptr || space > data)
+    {
+        return;
+    }
+
+    *space = 0;
+    *data = 0;
+    lastReceived = millis();
+    handler->onTelemetry(String(buf), strtoul(space + 1, nullptr, 10), String(data + 1));
+}
+
+unsigned long TelemetrySubscriber::getAge()
+{
+    return lastReceived == 0 ? ULONG_MAX : millis() - lastReceived;
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <Arduino.h>
+#include <ESP8266WiFi.h>
+#include <WiFiUdp.h>
+
+#define TELEMETRY_PORT 4210
+#define TELEMETRY_MAX_PACKET 512
+
+/*
+Packets are sent to a multicast group as "<topic> <sequence>\n<data>".
+*/
+class TelemetryHandler
+{
+    public:
+        virtual void onTelemetry(String topic, uint32_t sequence, String data) {}
+};
+
+class TelemetryPublisher
+{
+    private:
+        WiFiUDP udp;
+        IPAddress group;
+        uint32_t sequence = 0;
+
+    public:
+        TelemetryPublisher() : group(239, 255, 100, 1) {}
+        bool publish(const char *topic, const String &data);
+};
+
+class TelemetrySubscriber
+{
+    private:
+        WiFiUDP udp;
+        IPAddress group;
+        TelemetryHandler *handler;
+        bool isStarted = false;
+        unsigned long lastReceived = 0;
+
+    public:
+        TelemetrySubscriber(TelemetryHandler *handler) : group(239, 255, 100, 1), handler(handler) {}
+        void begin();
+        void stop();
+        void handle();
+        /*
+        Milliseconds since last packet, or ULONG_MAX when nothing was received yet.
+        */
+        unsigned long getAge();
+};
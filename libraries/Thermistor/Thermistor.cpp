@@ -0,0 +1,44 @@
+#include "Thermistor.h"
+#include "ThermistorTable.h"
+
+uint16_t Thermistor::rawAt(byte i)
+{
+  return pgm_read_word(&thermistorRaw[i]);
+}
+
+int Thermistor::tenthsAt(byte i)
+{
+  return (int16_t)pgm_read_word(&thermistorTenths[i]);
+}
+
+// first knot of the segment raw falls in, the end segments for readings outside the table
+byte Thermistor::segment(int raw)
+{
+  byte low = 0;
+  byte high = THERMISTOR_POINTS - 1;
+  while (high - low > 1)
+  {
+    byte middle = (low + high) / 2;
+    if ((int)rawAt(middle) <= raw)
+    {
+      low = middle;
+    }
+    else
+    {
+      high = middle;
+    }
+  }
+
+  return low;
+}
+
+int Thermistor::toTenths(int raw)
+{
+  byte i = segment(raw);
+  long dr = rawAt(i + 1) - rawAt(i);
+  long dt = tenthsAt(i + 1) - tenthsAt(i);
+  long offset = dt * (raw - (int)rawAt(i)) * 2;
+
+  // rounded to the nearest tenth, also below the table where offset is negative
+  return tenthsAt(i) + (offset + (offset < 0 ? -dr : dr)) / (2 * dr);
+}
@@ -0,0 +1,26 @@
+#ifndef THERMISTOR_H
+#define THERMISTOR_H
+
+#include <Arduino.h>
+
+// setpoint in tenths, a constant expression the compiler folds, no float at runtime
+#define THERMISTOR_C(celsius) ((int)((celsius) * 10 + ((celsius) < 0 ? -0.5 : 0.5)))
+
+/*
+Raw thermistor readings to tenths of a degree Celsius from the knots in
+ThermistorTable.h (generated by tools/thermistor_table.py from tools/calibration.txt).
+A binary search finds the segment and the value is interpolated in integers; readings past
+either end continue the end segment. The table is in PROGMEM, it costs no RAM.
+*/
+class Thermistor
+{
+private:
+  static byte segment(int raw);
+  static uint16_t rawAt(byte i);
+  static int tenthsAt(byte i);
+
+public:
+  static int toTenths(int raw);
+};
+
+#endif
@@ -0,0 +1,12 @@
+// generated by tools/thermistor_table.py from tools/calibration.txt, do not edit
+#ifndef THERMISTORTABLE_H
+#define THERMISTORTABLE_H
+
+#define THERMISTOR_POINTS 4
+
+// ascending readings and their temperatures in tenths of a degree Celsius, linear
+// interpolation between them is within 0.1C of every calibration point
+static const uint16_t thermistorRaw[THERMISTOR_POINTS] PROGMEM = {251, 317, 394, 478};
+static const int16_t thermistorTenths[THERMISTOR_POINTS] PROGMEM = {14, 80, 150, 223};
+
+#endif
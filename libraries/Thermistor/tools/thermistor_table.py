@@ -0,0 +1,103 @@
+#!/usr/bin/env python3
+"""Builds ThermistorTable.h from raw ADC / Celsius calibration pairs.
+
+    thermistor_table.py calibration.txt -o ../ThermistorTable.h
+    thermistor_table.py calibration.txt --check ../ThermistorTable.h
+
+Pairs of the same reading are averaged, then the fewest knots are kept such that linear
+interpolation between them stays within --tolerance tenths of every calibration point.
+The Arduino IDE has no generation step, so the header is committed; the host build
+regenerates it and --check fails when the committed copy is stale.
+"""
+
+import argparse
+import sys
+
+
+def read_pairs(name):
+    sums = {}
+    with open(name) as f:
+        for line in f:
+            line = line.split("#", 1)[0].split()
+            if not line:
+                continue
+            raw, celsius = int(line[0]), float(line[1])
+            total, count = sums.get(raw, (0.0, 0))
+            sums[raw] = (total + celsius * 10, count + 1)
+
+    points = [(raw, total / count) for raw, (total, count) in sorted(sums.items())]
+    for (r0, t0), (r1, t1) in zip(points, points[1:]):
+        if t1 < t0:
+            sys.exit(f"calibration is not monotonic between raw {r0} and {r1}")
+    return points
+
+
+def interpolate(a, b, raw):
+    (r0, t0), (r1, t1) = a, b
+    return t0 + (t1 - t0) * (raw - r0) / (r1 - r0)
+
+
+def knots(points, tolerance):
+    # greedy: extend every segment as far as all points under it stay within tolerance
+    result = [points[0]]
+    start = 0
+    while start < len(points) - 1:
+        end = start + 1
+        while end + 1 < len(points):
+            a, b = points[start], points[end + 1]
+            if all(abs(interpolate(a, b, r) - t) <= tolerance for r, t in points[start + 1:end + 1]):
+                end += 1
+            else:
+                break
+        result.append(points[end])
+        start = end
+    return [(raw, round(tenths)) for raw, tenths in result]
+
+
+def header(table, source, tolerance):
+    raws = ", ".join(str(raw) for raw, _ in table)
+    tenths = ", ".join(str(t) for _, t in table)
+    return f"""// generated by tools/thermistor_table.py from {source}, do not edit
+#ifndef THERMISTORTABLE_H
+#define THERMISTORTABLE_H
+
+#define THERMISTOR_POINTS {len(table)}
+
+// ascending readings and their temperatures in tenths of a degree Celsius, linear
+// interpolation between them is within {tolerance / 10:g}C of every calibration point
+static const uint16_t thermistorRaw[THERMISTOR_POINTS] PROGMEM = {{{raws}}};
+static const int16_t thermistorTenths[THERMISTOR_POINTS] PROGMEM = {{{tenths}}};
+
+#endif
+"""
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("calibration")
+    parser.add_argument("-o", "--output")
+    parser.add_argument("--check", metavar="HEADER")
+    # the log has 0.1C resolution, a tighter fit only follows its rounding steps
+    parser.add_argument("--tolerance", type=float, default=1.0, help="tenths of a degree")
+    args = parser.parse_args()
+
+    points = read_pairs(args.calibration)
+    table = knots(points, args.tolerance)
+    text = header(table, "tools/calibration.txt", args.tolerance)
+
+    if args.check:
+        with open(args.check) as f:
+            if f.read() != text:
+                sys.exit(f"{args.check} is out of date, run {sys.argv[0]} {args.calibration} -o {args.check}")
+        return
+
+    if args.output:
+        with open(args.output, "w") as f:
+            f.write(text)
+    else:
+        sys.stdout.write(text)
+    print(f"{len(points)} calibration points, {len(table)} knots", file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()
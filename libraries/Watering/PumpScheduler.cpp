@@ -0,0 +1,100 @@
+#include "PumpScheduler.h"
+
+PumpScheduler::PumpScheduler(const byte pins[], const int currents[], byte count, int budget)
+{
+  this->count = count > PUMP_MAX_CHANNELS ? PUMP_MAX_CHANNELS : count;
+  this->budget = budget;
+  for (byte i = 0; i < this->count; i++)
+  {
+    this->pins[i] = pins[i];
+    this->currents[i] = currents[i];
+  }
+}
+
+void PumpScheduler::setup()
+{
+  for (byte i = 0; i < this->count; i++)
+  {
+    pinMode(this->pins[i], OUTPUT);
+    digitalWrite(this->pins[i], LOW);
+  }
+}
+
+void PumpScheduler::run(byte pump, unsigned long duration)
+{
+  if (pump >= this->count || bitRead(this->running, pump) || duration == 0)
+  {
+    return;
+  }
+
+  this->durations[pump] = duration;
+  bitSet(this->queued, pump);
+}
+
+bool PumpScheduler::handle()
+{
+  if (this->queued == 0 && this->running == 0)
+  {
+    return false;
+  }
+
+  unsigned long now = millis();
+  bool changed = false;
+
+  for (byte i = 0; i < this->count; i++)
+  {
+    if (bitRead(this->running, i) && now - this->startedAt[i] >= this->durations[i])
+    {
+      this->stop(i);
+      changed = true;
+    }
+  }
+
+  if (this->queued == 0 || (this->running != 0 && now - this->lastStart < PUMP_START_GAP))
+  {
+    return changed;
+  }
+
+  for (byte i = 0; i < this->count; i++)
+  {
+    if (bitRead(this->queued, i) && (this->running == 0 || this->used + this->currents[i] <= this->budget))
+    {
+      this->start(i, now);
+      return true;
+    }
+  }
+
+  return changed;
+}
+
+void PumpScheduler::start(byte pump, unsigned long now)
+{
+  bitClear(this->queued, pump);
+  bitSet(this->running, pump);
+  this->used += this->currents[pump];
+  this->startedAt[pump] = now;
+  this->lastStart = now;
+  digitalWrite(this->pins[pump], HIGH);
+}
+
+void PumpScheduler::stop(byte pump)
+{
+  digitalWrite(this->pins[pump], LOW);
+  bitClear(this->running, pump);
+  this->used -= this->currents[pump];
+}
+
+bool PumpScheduler::isRunning(byte pump)
+{
+  return pump < this->count && bitRead(this->running, pump);
+}
+
+bool PumpScheduler::isBusy()
+{
+  return this->queued != 0 || this->running != 0;
+}
+
+int PumpScheduler::getCurrent()
+{
+  return this->used;
+}
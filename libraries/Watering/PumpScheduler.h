@@ -0,0 +1,44 @@
+#ifndef PUMPSCHEDULER_H
+#define PUMPSCHEDULER_H
+
+#include <Arduino.h>
+
+#define PUMP_MAX_CHANNELS 8
+#define PUMP_START_GAP 250 // ms between two starts, inrush currents do not add up
+
+/*
+Pumps run from timed state machines: run() queues a pump for a duration and handle()
+starts queued pumps while the sum of their currents stays within the budget, at most one
+every PUMP_START_GAP, and stops them when their time is up. A pump drawing more than the
+whole budget still runs, alone. Nothing blocks, the loop can sleep while pumps run.
+*/
+class PumpScheduler
+{
+private:
+  byte pins[PUMP_MAX_CHANNELS];
+  int currents[PUMP_MAX_CHANNELS];
+  unsigned long durations[PUMP_MAX_CHANNELS];
+  unsigned long startedAt[PUMP_MAX_CHANNELS];
+  byte count;
+  int budget;
+  int used = 0;
+  byte queued = 0;
+  byte running = 0;
+  unsigned long lastStart = 0;
+
+  void start(byte pump, unsigned long now);
+  void stop(byte pump);
+
+public:
+  PumpScheduler(const byte pins[], const int currents[], byte count, int budget);
+  void setup();
+  void run(byte pump, unsigned long duration);
+  // true when a pump started or stopped
+  bool handle();
+  bool isRunning(byte pump);
+  bool isBusy();
+  // mA drawn by the running pumps
+  int getCurrent();
+};
+
+#endif
@@ -0,0 +1,102 @@
+#include "SoilScanner.h"
+
+#include <avr/interrupt.h>
+#include <avr/sleep.h>
+
+// only wakes the CPU, the result is read from ADC
+EMPTY_INTERRUPT(ADC_vect);
+
+SoilScanner::SoilScanner(const byte pins[], byte count, byte tries, unsigned int interval)
+{
+  this->count = count > SCAN_MAX_CHANNELS ? SCAN_MAX_CHANNELS : count;
+  this->tries = tries > 0 ? tries : 1;
+  this->interval = interval;
+  for (byte i = 0; i < this->count; i++)
+  {
+    this->pins[i] = pins[i];
+    this->sums[i] = 0;
+  }
+}
+
+void SoilScanner::start(byte mask)
+{
+  this->mask = mask;
+  for (byte i = 0; i < this->count; i++)
+  {
+    this->sums[i] = 0;
+  }
+  this->round = 0;
+  this->isRunning = true;
+  this->nextRound = millis();
+}
+
+bool SoilScanner::handle()
+{
+  if (!this->isRunning || (long)(millis() - this->nextRound) < 0)
+  {
+    return false;
+  }
+
+  for (byte i = 0; i < this->count; i++)
+  {
+    if (bitRead(this->mask, i))
+    {
+      this->sums[i] += read(this->pins[i]);
+    }
+  }
+
+  this->round++;
+  this->nextRound += this->interval;
+  if (this->round < this->tries)
+  {
+    return false;
+  }
+
+  this->isRunning = false;
+  return true;
+}
+
+bool SoilScanner::isBusy()
+{
+  return this->isRunning;
+}
+
+int SoilScanner::getValue(byte channel)
+{
+  return channel < this->count ? this->sums[channel] / this->tries : 0;
+}
+
+byte SoilScanner::getCount()
+{
+  return this->count;
+}
+
+int SoilScanner::read(byte pin)
+{
+  if (pin >= A0)
+  {
+    pin -= A0;
+  }
+
+  ADMUX = _BV(REFS0) | (pin & 0x07);
+  ADCSRA |= _BV(ADEN) | _BV(ADIE);
+  set_sleep_mode(SLEEP_MODE_ADC);
+
+  int value = 0;
+  for (byte i = 0; i < 2; i++)
+  {
+    // entering the mode starts the conversion, other interrupts (millis) may wake it earlier
+    sleep_enable();
+    do
+    {
+      sei();
+      sleep_cpu();
+    } while (bit_is_set(ADCSRA, ADSC));
+    sleep_disable();
+    value = ADC;
+  }
+
+  ADCSRA &= ~_BV(ADIE);
+
+  return value;
+}
@@ -0,0 +1,44 @@
+#ifndef SOILSCANNER_H
+#define SOILSCANNER_H
+
+#include <Arduino.h>
+
+#define SCAN_MAX_CHANNELS 8
+
+/*
+Averaged readings of several analog probes. Instead of sampling one probe after another
+with delays, every round converts each channel once and the rounds are interval ms apart,
+so a scan of all channels takes as long as the averaging of one. handle() runs a round
+when it is due and returns right away otherwise, the loop can sleep in between.
+
+read() is a single conversion taken in ADC noise reduction sleep, the CPU and the digital
+clocks are stopped while it runs. The first conversion after switching the multiplexer is
+thrown away, the sample-and-hold of high impedance probes has not settled yet.
+*/
+class SoilScanner
+{
+private:
+  byte pins[SCAN_MAX_CHANNELS];
+  byte count;
+  byte tries;
+  unsigned int interval;
+  unsigned int sums[SCAN_MAX_CHANNELS];
+  byte mask = 0;
+  byte round = 0;
+  bool isRunning = false;
+  unsigned long nextRound = 0;
+
+public:
+  SoilScanner(const byte pins[], byte count, byte tries, unsigned int interval);
+  // channels with their bit set in mask are read, the others stay 0
+  void start(byte mask = 0xFF);
+  // true once, when the last round of the scan finished
+  bool handle();
+  bool isBusy();
+  int getValue(byte channel);
+  byte getCount();
+
+  static int read(byte pin);
+};
+
+#endif
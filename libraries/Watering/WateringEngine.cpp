@@ -0,0 +1,239 @@
+#include "WateringEngine.h"
+
+WateringEngine::WateringEngine(int address, byte channels, const int thresholds[], const int targets[])
+{
+  this->address = address;
+  this->channels = channels > WATERING_MAX_CHANNELS ? WATERING_MAX_CHANNELS : channels;
+  for (byte i = 0; i < this->channels; i++)
+  {
+    this->thresholds[i] = thresholds[i] >> 2;
+    this->targets[i] = min(targets[i] >> 2, (int)this->thresholds[i]);
+    this->rates[i] = 0;
+    // until learned, a reading just above the threshold gets the old fixed dose
+    this->gains[i] = max(1, this->thresholds[i] - this->targets[i]) / (float)WATERING_DEFAULT_DOSE;
+    this->newest[i] = 0xFF;
+    this->sequences[i] = 0;
+  }
+}
+
+int WateringEngine::recordAddress(byte channel, byte slot)
+{
+  return this->address + (channel * WATERING_HISTORY + slot) * WATERING_RECORD_SIZE;
+}
+
+bool WateringEngine::readRecord(byte channel, byte slot, byte *sequence, wateringRecord *record)
+{
+  int start = this->recordAddress(channel, slot);
+  byte bytes[WATERING_RECORD_SIZE];
+  byte crc = SETTINGS_CRC_INIT;
+  for (byte i = 0; i < WATERING_RECORD_SIZE; i++)
+  {
+    bytes[i] = EEPROM.read(start + i);
+    if (i < WATERING_RECORD_SIZE - 1)
+    {
+      crc = SettingsStore::crc8(crc, bytes[i]);
+    }
+  }
+
+  if (crc != bytes[WATERING_RECORD_SIZE - 1])
+  {
+    return false;
+  }
+
+  *sequence = bytes[0];
+  record->moisture = bytes[1];
+  record->dose = bytes[2];
+  record->minutes = bytes[3] | (bytes[4] << 8);
+
+  return true;
+}
+
+void WateringEngine::writeRecord(byte channel, const wateringRecord *record)
+{
+  byte slot = this->newest[channel] == 0xFF ? 0 : (this->newest[channel] + 1) % WATERING_HISTORY;
+  byte sequence = this->newest[channel] == 0xFF ? 0 : this->sequences[channel] + 1;
+  byte bytes[] = {sequence, record->moisture, record->dose, lowByte(record->minutes), highByte(record->minutes)};
+  int start = this->recordAddress(channel, slot);
+
+  // crc last, a record torn by a reset is skipped by load()
+  byte crc = SETTINGS_CRC_INIT;
+  for (byte i = 0; i < sizeof(bytes); i++)
+  {
+    EEPROM.update(start + i, bytes[i]);
+    crc = SettingsStore::crc8(crc, bytes[i]);
+  }
+  EEPROM.update(start + sizeof(bytes), crc);
+
+  this->newest[channel] = slot;
+  this->sequences[channel] = sequence;
+  this->writes++;
+}
+
+void WateringEngine::load()
+{
+  for (byte channel = 0; channel < this->channels; channel++)
+  {
+    byte sequences[WATERING_HISTORY];
+    wateringRecord records[WATERING_HISTORY];
+    byte valid = 0;
+    for (byte i = 0; i < WATERING_HISTORY; i++)
+    {
+      if (this->readRecord(channel, i, &sequences[i], &records[i]))
+      {
+        bitSet(valid, i);
+      }
+    }
+
+    // the newest record is the one whose sequence number has no successor
+    this->newest[channel] = 0xFF;
+    for (byte i = 0; i < WATERING_HISTORY && this->newest[channel] == 0xFF; i++)
+    {
+      if (!bitRead(valid, i))
+      {
+        continue;
+      }
+
+      bool hasSuccessor = false;
+      for (byte j = 0; j < WATERING_HISTORY; j++)
+      {
+        if (bitRead(valid, j) && j != i && sequences[j] == (byte)(sequences[i] + 1))
+        {
+          hasSuccessor = true;
+          break;
+        }
+      }
+
+      if (!hasSuccessor)
+      {
+        this->newest[channel] = i;
+        this->sequences[channel] = sequences[i];
+      }
+    }
+
+    if (this->newest[channel] == 0xFF)
+    {
+      continue;
+    }
+
+    // replay from the oldest, the slot after the newest
+    for (byte n = 1; n <= WATERING_HISTORY; n++)
+    {
+      byte slot = (this->newest[channel] + n) % WATERING_HISTORY;
+      if (bitRead(valid, slot))
+      {
+        this->learn(channel, &records[slot]);
+      }
+    }
+  }
+}
+
+void WateringEngine::learn(byte channel, const wateringRecord *record)
+{
+  wateringRecord *previous = &this->last[channel];
+  if (bitRead(this->hasLast, channel) && record->minutes > 0)
+  {
+    if (previous->dose > 0)
+    {
+      // drop caused by the dose, the soil kept drying meanwhile; none at all means the
+      // probe is out of the pot or the tank is empty and says nothing about the gain
+      float response = previous->moisture - record->moisture + this->rates[channel] * record->minutes;
+      if (response > 0)
+      {
+        this->gains[channel] += (response / previous->dose - this->gains[channel]) * WATERING_SMOOTHING;
+      }
+    }
+    else
+    {
+      float rate = ((float)record->moisture - previous->moisture) / record->minutes;
+      rate = rate > 0 ? rate : 0;
+      if (bitRead(this->hasRate, channel))
+      {
+        this->rates[channel] += (rate - this->rates[channel]) * WATERING_SMOOTHING;
+      }
+      else
+      {
+        this->rates[channel] = rate;
+        bitSet(this->hasRate, channel);
+      }
+    }
+  }
+
+  *previous = *record;
+  bitSet(this->hasLast, channel);
+}
+
+byte WateringEngine::check(byte channel, int reading, unsigned int minutes)
+{
+  if (channel >= this->channels)
+  {
+    return 0;
+  }
+
+  wateringRecord record;
+  record.moisture = constrain(reading >> 2, 0, 255);
+  record.minutes = minutes;
+  record.dose = 0;
+
+  // learn first, the dose below already uses the gain of the previous one
+  this->learn(channel, &record);
+
+  // one that would dry past the threshold before the shortest check is watered now
+  if (record.moisture + this->rates[channel] * WATERING_MIN_CHECK >= this->thresholds[channel])
+  {
+    float dose = (record.moisture - this->targets[channel]) / this->gains[channel];
+    record.dose = constrain((int)(dose + 0.5), 1, WATERING_MAX_DOSE);
+    this->last[channel].dose = record.dose;
+  }
+
+  this->writeRecord(channel, &record);
+
+  return record.dose;
+}
+
+unsigned int WateringEngine::nextCheck(byte channel)
+{
+  if (channel >= this->channels || !bitRead(this->hasLast, channel))
+  {
+    return WATERING_DEFAULT_CHECK;
+  }
+
+  const wateringRecord *previous = &this->last[channel];
+  if (previous->dose > 0)
+  {
+    return WATERING_SOAK_CHECK;
+  }
+
+  if (!bitRead(this->hasRate, channel))
+  {
+    return WATERING_DEFAULT_CHECK;
+  }
+
+  // no drying seen yet, maybe too little to show in a short interval: back off by doubling
+  if (this->rates[channel] <= 0)
+  {
+    return constrain(2 * previous->minutes, WATERING_DEFAULT_CHECK, WATERING_MAX_CHECK);
+  }
+
+  float minutes = (this->thresholds[channel] - (float)previous->moisture) / this->rates[channel];
+  return constrain(minutes, WATERING_MIN_CHECK, WATERING_MAX_CHECK);
+}
+
+float WateringEngine::getDryingRate(byte channel)
+{
+  return channel < this->channels ? this->rates[channel] : 0;
+}
+
+float WateringEngine::getGain(byte channel)
+{
+  return channel < this->channels ? this->gains[channel] : 0;
+}
+
+unsigned int WateringEngine::getWrites()
+{
+  return this->writes;
+}
+
+int WateringEngine::getLength()
+{
+  return this->channels * WATERING_HISTORY * WATERING_RECORD_SIZE;
+}
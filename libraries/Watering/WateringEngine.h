@@ -0,0 +1,79 @@
+#ifndef WATERINGENGINE_H
+#define WATERINGENGINE_H
+
+#include <Arduino.h>
+#include <EEPROM.h>
+#include <SettingsStore.h>
+
+#define WATERING_MAX_CHANNELS 4
+#define WATERING_HISTORY 8       // records per channel in the EEPROM ring
+#define WATERING_RECORD_SIZE 6   // [sequence][moisture][dose][minutes lo][minutes hi][crc]
+#define WATERING_DEFAULT_CHECK 20 // min, until the drying rate is known
+#define WATERING_MIN_CHECK 15    // min
+#define WATERING_MAX_CHECK 720   // min
+#define WATERING_SOAK_CHECK 60   // min after a dose, the water has spread and the response shows
+#define WATERING_DEFAULT_DOSE 10 // s, the first dose just above the threshold
+#define WATERING_MAX_DOSE 30     // s
+#define WATERING_SMOOTHING 0.25  // weight of a new sample in the rate and gain averages
+
+struct wateringRecord
+{
+  byte moisture;
+  byte dose;
+  unsigned int minutes;
+};
+
+/*
+Per-plant watering from the history of each channel. Readings grow as the soil dries; they
+are kept as reading / 4 in one byte.
+
+Every check appends [moisture, dose, minutes since the previous check] to the channel's
+ring of WATERING_HISTORY records in EEPROM, sequence numbered and CRC protected like
+SettingsStore slots, so the estimates survive a reset and load() rebuilds them by
+replaying the ring. Two checks without a dose in between give the drying rate, a check
+after a dose gives the gain, the moisture drop per second of pump corrected for the drying
+in between. Both are running averages.
+
+A channel above its threshold, or one that reaches it within WATERING_MIN_CHECK, gets the
+dose that brings it down to its target at the learned gain, and the next check is planned
+for when the drying rate takes it back to the threshold, so a slowly drying pot is read
+rarely and a fast one often. One that shows no drying yet is read at doubling intervals.
+*/
+class WateringEngine
+{
+private:
+  int address;
+  byte channels;
+  byte thresholds[WATERING_MAX_CHANNELS];
+  byte targets[WATERING_MAX_CHANNELS];
+  float rates[WATERING_MAX_CHANNELS];
+  float gains[WATERING_MAX_CHANNELS];
+  wateringRecord last[WATERING_MAX_CHANNELS];
+  byte newest[WATERING_MAX_CHANNELS];
+  byte sequences[WATERING_MAX_CHANNELS];
+  byte hasLast = 0;
+  byte hasRate = 0;
+  unsigned int writes = 0;
+
+  int recordAddress(byte channel, byte slot);
+  bool readRecord(byte channel, byte slot, byte *sequence, wateringRecord *record);
+  void writeRecord(byte channel, const wateringRecord *record);
+  void learn(byte channel, const wateringRecord *record);
+
+public:
+  WateringEngine(int address, byte channels, const int thresholds[], const int targets[]);
+  void load();
+  // reading of a checked channel, minutes since its previous check; dose in seconds, 0 for none
+  byte check(byte channel, int reading, unsigned int minutes);
+  // minutes until the channel should be read again
+  unsigned int nextCheck(byte channel);
+  // moisture units (reading / 4) per minute
+  float getDryingRate(byte channel);
+  // moisture units per second of pump
+  float getGain(byte channel);
+  unsigned int getWrites();
+  // EEPROM bytes taken by the rings
+  int getLength();
+};
+
+#endif
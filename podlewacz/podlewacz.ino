@@ -1,5 +1,9 @@
 #include <avr/sleep.h>
 #include <avr/power.h>
+#include <SleepService.h>
+#include <SoilScanner.h>
+#include <PumpScheduler.h>
+#include <WateringEngine.h>
 
 static const byte vcc_read = A3;
 static const byte options = 2;
@@ -22,44 +26,42 @@ static const byte led_m4 = 7;
 
 static const int vcc_min = 990;
 
-static const unsigned long checkInMinutes = 20L;
-static const unsigned long checkDelay =  60L * checkInMinutes / 4L;
-static const int pompDelay = 1000 * 10;
-
+// a reading above the threshold gets watered down to the target
 static const int sensorThresholds[] = { 160, 510, 510, 510 };
+static const int sensorTargets[] = { 120, 400, 400, 400 };
+static const int historyAddress = 0;
 
 static const int sensorTries = 5;
+static const int sensorInterval = 100;
+
+// mA per pump and for all running pumps together, two pumps at a time
+static const int pompCurrents[] = { 250, 250, 250, 250 };
+static const int pompBudget = 500;
 
 byte pomps[] = { m1_in, m2_in, m3_in, m4_in };
 
 byte sensors[] {s1a0, s2a0, s3a0, s4a0};
 
+SoilScanner scanner(sensors, sizeof(sensors), sensorTries, sensorInterval);
+PumpScheduler pumpScheduler(pomps, pompCurrents, sizeof(pomps), pompBudget);
+byte pompsOn = 0;
+
+WateringEngine engine(historyAddress, sizeof(sensors), sensorThresholds, sensorTargets);
+// per channel, 0 when it is due
+unsigned int minutesLeft[sizeof(sensors)];
+unsigned int minutesSinceCheck[sizeof(sensors)];
+
 byte allLeds[] = { led_m1, led_m2, led_m3, led_m4, led_red };
 byte motorLeds[] = { led_m1, led_m2, led_m3, led_m4 };
 
-ISR(TIMER1_OVF_vect)
-{
-    
-}
-
 void setup() {
     Serial.begin(115200);
 
     pinMode(13, OUTPUT);
-    /* Normal timer operation.*/
-    TCCR1A = 0x00;
-
-    /* Enable the timer overlow interrupt. */
-    TIMSK1 = 0x01;
 
     pinMode(vcc_read, INPUT);
     pinMode(options, INPUT);
 
-    pinMode(m1_in, OUTPUT);
-    pinMode(m2_in, OUTPUT);
-    pinMode(m3_in, OUTPUT);
-    pinMode(m4_in, OUTPUT);
-
     pinMode(s1a0, INPUT);
     pinMode(s2a0, INPUT);
     pinMode(s3a0, INPUT);
@@ -71,10 +73,9 @@ void setup() {
     pinMode(led_m3, OUTPUT);
     pinMode(led_m4, OUTPUT);
 
-    analogWrite(m1_in, 0);
-    analogWrite(m2_in, 0);
-    analogWrite(m3_in, 0);
-    analogWrite(m4_in, 0);
+    pumpScheduler.setup();
+    SleepService::begin();
+    engine.load();
 
     welcome();
 }
@@ -83,91 +84,121 @@ void loop() {
     checkVoltage();
 
     checkSensors();
+    Serial.flush();
 
-    for (int i = 0; i < checkDelay; i++){
-        enterSleep();
-    }
+    sleepMinutes(nextCheck());
 }
 
-void enterSleep()
+// minutes until the first channel is due, they pass for all of them
+unsigned int nextCheck()
 {
-    /* Clear the timer counter register.
-    * You can pre-load this register with a value in order to
-    * reduce the timeout period, say if you wanted to wake up
-    * ever 4.0 seconds exactly.
-    */
-    TCNT1 = 0x0000;
-
-    /* Configure the prescaler for 1:1024, giving us a
-    * timeout of 4.09 seconds.
-    */
-    TCCR1B = 0x05;
-
-    set_sleep_mode(SLEEP_MODE_IDLE);
+    unsigned int minutes = WATERING_MAX_CHECK;
+    for (byte i = 0; i < sizeof(sensors); i++)
+    {
+        minutes = min(minutes, minutesLeft[i]);
+    }
 
-    sleep_enable();
+    for (byte i = 0; i < sizeof(sensors); i++)
+    {
+        minutesLeft[i] -= minutes;
+        minutesSinceCheck[i] += minutes;
+    }
 
+    return minutes;
+}
 
-    /* Disable all of the unused peripherals. This will reduce power
-    * consumption further and, more importantly, some of these
-    * peripherals may generate interrupts that will wake our Arduino from
-    * sleep!
-    */
-    power_adc_disable();
-    power_spi_disable();
-    power_timer0_disable();
-    power_timer2_disable();
-    power_twi_disable();
+// power-down on the watchdog, its period measured against the crystal before every sleep
+void sleepMinutes(unsigned int minutes)
+{
+    SleepService::calibrate();
+    SleepService::powerDownFor(60000UL * minutes);
+}
 
-    /* Now enter sleep mode. */
-    sleep_mode();
+// one watering cycle: the due probes scanned together, then the dry ones watered together
+// as far as the current budget allows, the CPU sleeps between the steps
+void checkSensors()
+{
+    byte due = 0;
+    for (byte i = 0; i < sizeof(sensors); i++)
+    {
+        if (minutesLeft[i] == 0)
+        {
+            bitSet(due, i);
+            digitalWrite(motorLeds[i], HIGH);
+        }
+    }
 
-    /* The program will continue from here after the timer timeout*/
-    sleep_disable(); /* First thing to do is disable sleep. */
+    scanner.start(due);
+    while (scanner.isBusy() || pumpScheduler.isBusy())
+    {
+        if (scanner.handle())
+        {
+            handleScan();
+        }
 
-    /* Re-enable the peripherals. */
-    power_all_enable();
+        if (pumpScheduler.handle())
+        {
+            handlePomps();
+        }
 
-    TCCR1B = 0x1;
+        // the next millis() tick wakes it
+        noInterrupts();
+        SleepService::idle();
+    }
 }
 
-void checkSensors()
+void handleScan()
 {
     for (byte i = 0; i < sizeof(sensors); i++)
     {
-        digitalWrite(motorLeds[i], HIGH);
-
-        int sensor, sum = 0;
-        for (byte j = 0; j < sensorTries; j++)
+        if (minutesLeft[i] > 0)
         {
-            sensor = analogRead(sensors[i]);
-            sum += sensor;
-            delay(100);
+            continue;
         }
-        sensor = (int)((double)sum / (double)sensorTries);
+
+        int sensor = scanner.getValue(i);
+        byte dose = engine.check(i, sensor, minutesSinceCheck[i]);
+        minutesSinceCheck[i] = 0;
+        minutesLeft[i] = engine.nextCheck(i);
 
         Serial.print("Sensor ");
         Serial.print(i + 1);
         Serial.print(" : ");
-        Serial.println(sensor);
-        if (sensor > sensorThresholds[i])
+        Serial.print(sensor);
+        Serial.print(", dose ");
+        Serial.print(dose);
+        Serial.print("s, next check in ");
+        Serial.print(minutesLeft[i]);
+        Serial.println("min");
+        if (dose > 0)
         {
-            Serial.print("Pomp ");
-            Serial.print(i + 1);
-            Serial.println(" ON");
-            analogWrite(pomps[i], 255);
-            delay(pompDelay);
-            analogWrite(pomps[i], 0);
-            Serial.print("Pomp ");
-            Serial.print(i + 1);
-            Serial.println(" OFF");
+            pumpScheduler.run(i, dose * 1000UL);
         }
         else
         {
-            delay(500);
+            digitalWrite(motorLeds[i], LOW);
         }
+    }
+}
 
-        digitalWrite(motorLeds[i], LOW);
+void handlePomps()
+{
+    for (byte i = 0; i < sizeof(pomps); i++)
+    {
+        bool isOn = pumpScheduler.isRunning(i);
+        if (isOn == bitRead(pompsOn, i))
+        {
+            continue;
+        }
+
+        bitWrite(pompsOn, i, isOn);
+        Serial.print("Pomp ");
+        Serial.print(i + 1);
+        Serial.println(isOn ? " ON" : " OFF");
+        if (!isOn)
+        {
+            digitalWrite(motorLeds[i], LOW);
+        }
     }
 }
 
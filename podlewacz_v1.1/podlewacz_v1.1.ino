@@ -1,3 +1,5 @@
+#include <SleepService.h>
+
 const byte masterOn = 3;
 const byte multiplexerA = 0;
 const byte multiplexerB = 1;
@@ -18,6 +20,7 @@ void setup() {
     digitalWrite(multiplexerC, LOW);
     digitalWrite(led, LOW);
 
+    SleepService::begin();
     welcome();
 }
 
@@ -45,7 +48,9 @@ void loop() {
     goodbye();
     digitalWrite(masterOn, LOW);
 
-    delay(1 * 60 * 1000);
+    // power-down on the watchdog instead of spinning in delay()
+    SleepService::calibrate();
+    SleepService::powerDownFor(1 * 60 * 1000UL);
 }
 
 void goodbye(){
@@ -3,33 +3,11 @@
  * Donal Morrissey - 2011.
  *
  */
-#include <avr/sleep.h>
-#include <avr/power.h>
+#include <SleepService.h>
 
 #define LED_PIN (13)
+#define SLEEP_TIME (4096) /* ms, the old Timer1 overflow period */
 
-volatile int f_timer=0;
-
-
-
-/***************************************************
- *  Name:        ISR(TIMER1_OVF_vect)
- *
- *  Returns:     Nothing.
- *
- *  Parameters:  None.
- *
- *  Description: Timer1 Overflow interrupt.
- *
- ***************************************************/
-ISR(TIMER1_OVF_vect)
-{
-  /* set the flag. */
-   if(f_timer == 0)
-   {
-     f_timer = 1;
-   }
-}
 
 
 /***************************************************
@@ -44,44 +22,12 @@ ISR(TIMER1_OVF_vect)
  ***************************************************/
 void enterSleep(void)
 {
-    /* Clear the timer counter register.
-    * You can pre-load this register with a value in order to
-    * reduce the timeout period, say if you wanted to wake up
-    * ever 4.0 seconds exactly.
-    */
-    TCNT1 = 0x0000;
-
-    /* Configure the prescaler for 1:1024, giving us a
-    * timeout of 4.09 seconds.
-    */
-    TCCR1B = 0x05;  
-
-  set_sleep_mode(SLEEP_MODE_IDLE);
-  
-  sleep_enable();
-
-
-  /* Disable all of the unused peripherals. This will reduce power
-   * consumption further and, more importantly, some of these
-   * peripherals may generate interrupts that will wake our Arduino from
-   * sleep!
+  /* Power-down until the watchdog wakes it, BOD and ADC off.
+   * The watchdog period is measured against Timer1 first so
+   * the sleep lasts SLEEP_TIME on the crystal's timebase.
    */
-  power_adc_disable();
-  power_spi_disable();
-  power_timer0_disable();
-  power_timer2_disable();
-  power_twi_disable();  
-
-  /* Now enter sleep mode. */
-  sleep_mode();
-  
-  /* The program will continue from here after the timer timeout*/
-  sleep_disable(); /* First thing to do is disable sleep. */
-  
-  /* Re-enable the peripherals. */
-  power_all_enable();
-
-  TCCR1B = 0x1;
+  SleepService::calibrate();
+  SleepService::powerDownFor(SLEEP_TIME);
 }
 
 
@@ -94,7 +40,7 @@ void enterSleep(void)
  *  Parameters:  None.
  *
  *  Description: Setup for the serial comms and the
- *                timer. 
+ *                sleep service.
  *
  ***************************************************/
 void setup()
@@ -104,13 +50,7 @@ void setup()
   /* Don't forget to configure the pin! */
   pinMode(LED_PIN, OUTPUT);
 
-  /*** Configure the timer.***/
-  
-  /* Normal timer operation.*/
-  TCCR1A = 0x00; 
-
-  /* Enable the timer overlow interrupt. */
-  TIMSK1 = 0x01;
+  SleepService::begin();
 }
 
 
@@ -154,25 +94,4 @@ void loop()
         digitalWrite(LED_PIN, LOW);
         delay(100);
     }
-
-    return;
-  if(f_timer==1)
-  {
-    f_timer = 0;
-    /* Toggle the LED */
-    digitalWrite(LED_PIN, !digitalRead(LED_PIN));
-    
-    /* Re-enter sleep mode. */
-    enterSleep();
-
-    int r = digitalRead(LED_PIN);
-    if (r == LOW){
-        for (int i = 0; i < 10; i++){
-            digitalWrite(LED_PIN, HIGH);
-            delay(1000);
-            digitalWrite(LED_PIN, LOW);
-            delay(1000);
-        }
-    }
-  }
 }